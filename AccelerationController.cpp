@@ -0,0 +1,83 @@
+#include "AccelerationController.h"
+
+#include <algorithm>
+
+// 예산 대비 압축 시간이 이 비율을 넘으면 올리고, 밑돌면 내림
+static const double HIGH_WATER = 0.9;
+static const double LOW_WATER = 0.6;
+// 내릴 때마다 압축률이 이만큼도 좋아지지 않는 일이 연속되면 더 내리지 않음
+// (acceleration이 높은 구간은 값을 바꿔도 압축률이 거의 같으므로 한 번으로는 판단하지 않음)
+static const double MIN_RATIO_GAIN = 1.01;
+static const int PLATEAU_STEPS = 4;
+// 내용이 바뀌었을 수 있으므로 일정 프레임마다 다시 내려봄
+static const int PLATEAU_RETRY_FRAMES = 120;
+
+// LZ4_ACCELERATION_MAX
+static const int LZ4_MAX_ACCELERATION = 65537;
+
+void AccelerationController::configure(int minValue, int maxValue) {
+	std::lock_guard<std::mutex> lock(controllerMutex);
+	minAcceleration = std::clamp(minValue, 1, LZ4_MAX_ACCELERATION);
+	maxAcceleration = std::clamp(maxValue, minAcceleration, LZ4_MAX_ACCELERATION);
+	acceleration = maxAcceleration;
+	hasSample = false;
+	lastStepDown = false;
+	plateau = false;
+	flatSteps = 0;
+}
+
+void AccelerationController::reset() {
+	std::lock_guard<std::mutex> lock(controllerMutex);
+	acceleration = maxAcceleration; // 가장 빠른 설정에서 시작해 예산이 남으면 내려감
+	hasSample = false;
+	lastStepDown = false;
+	plateau = false;
+	framesSincePlateau = 0;
+}
+
+int AccelerationController::current() {
+	std::lock_guard<std::mutex> lock(controllerMutex);
+	return static_cast<int>(acceleration);
+}
+
+int AccelerationController::update(double compressMs, double budgetMs, size_t rawSize, size_t compressedSize) {
+	std::lock_guard<std::mutex> lock(controllerMutex);
+	if (minAcceleration >= maxAcceleration) {
+		return minAcceleration;
+	}
+
+	smoothedMs = hasSample ? smoothedMs * 0.8 + compressMs * 0.2 : compressMs;
+	hasSample = true;
+	double ratio = compressedSize > 0 ? static_cast<double>(rawSize) / compressedSize : 1.0;
+
+	if (plateau && ++framesSincePlateau >= PLATEAU_RETRY_FRAMES) {
+		plateau = false;
+	}
+
+	if (budgetMs <= 0 || smoothedMs > budgetMs * HIGH_WATER) {
+		// CPU가 병목: 속도 우선
+		acceleration = (std::min)(static_cast<double>(maxAcceleration), acceleration * 1.5 + 1);
+		lastStepDown = false;
+		plateau = false;
+		flatSteps = 0;
+	}
+	else if (smoothedMs < budgetMs * LOW_WATER && !plateau) {
+		flatSteps = (lastStepDown && ratio < lastRatio * MIN_RATIO_GAIN) ? flatSteps + 1 : 0;
+		if (flatSteps >= PLATEAU_STEPS) {
+			plateau = true;
+			framesSincePlateau = 0;
+			flatSteps = 0;
+		}
+		else {
+			// 예산이 남음: 압축률 우선
+			acceleration = (std::max)(static_cast<double>(minAcceleration), acceleration * 0.5);
+			lastStepDown = true;
+		}
+	}
+	else {
+		lastStepDown = false;
+	}
+	lastRatio = ratio;
+
+	return static_cast<int>(acceleration);
+}
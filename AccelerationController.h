@@ -0,0 +1,31 @@
+#pragma once
+#include <cstddef>
+#include <mutex>
+
+// 프레임마다 압축 시간과 압축률을 보고 LZ4 acceleration을 조정
+// 남은 프레임 예산 안에서는 acceleration을 낮춰(압축률 우선) 쓰고, 넘치면 올려(속도 우선) 따라잡음
+class AccelerationController {
+public:
+	// minAcceleration == maxAcceleration 이면 고정값
+	void configure(int minAcceleration, int maxAcceleration);
+	void reset();
+
+	int current();
+
+	// budgetMs: 프레임 시간에서 압축 외 단계를 뺀 시간. 반환값: 다음 프레임에 쓸 acceleration
+	int update(double compressMs, double budgetMs, size_t rawSize, size_t compressedSize);
+
+private:
+	std::mutex controllerMutex;
+	int minAcceleration = 1;
+	int maxAcceleration = 10000;
+	double acceleration = 10000;
+
+	double smoothedMs = 0;
+	double lastRatio = 0;
+	bool hasSample = false;
+	bool lastStepDown = false;
+	int flatSteps = 0;
+	bool plateau = false;       // 더 낮춰도 압축률이 나아지지 않는 구간
+	int framesSincePlateau = 0;
+};
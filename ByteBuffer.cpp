@@ -0,0 +1,16 @@
+#include "ByteBuffer.h"
+
+#include <atomic>
+
+static std::atomic<long long> allocationCounter{ 0 };
+static std::atomic<long long> allocatedByteCounter{ 0 };
+
+void countAllocation(size_t bytes) {
+	allocationCounter.fetch_add(1, std::memory_order_relaxed);
+	allocatedByteCounter.fetch_add(static_cast<long long>(bytes), std::memory_order_relaxed);
+}
+
+void getAllocationCounters(long long& allocationCount, long long& allocatedBytes) {
+	allocationCount = allocationCounter.load(std::memory_order_relaxed);
+	allocatedBytes = allocatedByteCounter.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,80 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+// 인코딩 경로에서 일어난 힙 할당 누적 횟수/바이트 (ByteBuffer, CopyRect 목록, 워커별 LZ4 상태, 인라인에 안 들어간 Task)
+void countAllocation(size_t bytes);
+void getAllocationCounters(long long& allocationCount, long long& allocatedBytes);
+
+// 할당 횟수를 세고, resize 시 새 원소를 0으로 채우지 않는 할당자
+// 압축 출력처럼 곧바로 덮어쓸 버퍼를 LZ4_compressBound 크기로 늘릴 때 memset을 피함
+template <typename T>
+struct CountingAllocator {
+	typedef T value_type;
+
+	CountingAllocator() = default;
+	template <typename U>
+	CountingAllocator(const CountingAllocator<U>&) {}
+
+	T* allocate(size_t count) {
+		countAllocation(count * sizeof(T));
+		return std::allocator<T>().allocate(count);
+	}
+
+	void deallocate(T* p, size_t count) {
+		std::allocator<T>().deallocate(p, count);
+	}
+
+	template <typename U>
+	void construct(U* p) {
+		::new (static_cast<void*>(p)) U;
+	}
+
+	template <typename U, typename... Args>
+	void construct(U* p, Args&&... args) {
+		::new (static_cast<void*>(p)) U(std::forward<Args>(args)...);
+	}
+
+	template <typename U>
+	bool operator==(const CountingAllocator<U>&) const { return true; }
+	template <typename U>
+	bool operator!=(const CountingAllocator<U>&) const { return false; }
+};
+
+typedef std::vector<uint8_t, CountingAllocator<uint8_t>> ByteBuffer;
+
+// 프레임 사이에 용량을 유지한 채 버퍼(vector)를 돌려쓰는 풀
+// 정상 상태에서는 진행 중인 프레임 수만큼의 버퍼가 돌고 새 할당이 없음
+template <typename Buffer>
+class BufferPool {
+public:
+	Buffer acquire() {
+		std::lock_guard<std::mutex> lock(poolMutex);
+		if (freeBuffers.empty()) {
+			return Buffer();
+		}
+		Buffer buffer = std::move(freeBuffers.back());
+		freeBuffers.pop_back();
+		return buffer;
+	}
+
+	void release(Buffer&& buffer) {
+		// 이번 프레임에 쓰지 않은 빈 버퍼까지 넣으면 목록만 계속 자람
+		if (buffer.capacity() == 0) {
+			return;
+		}
+		buffer.clear(); // 용량은 유지
+		std::lock_guard<std::mutex> lock(poolMutex);
+		freeBuffers.push_back(std::move(buffer));
+	}
+
+private:
+	std::mutex poolMutex;
+	std::vector<Buffer> freeBuffers;
+};
+
+typedef BufferPool<ByteBuffer> ByteBufferPool;
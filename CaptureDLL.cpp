@@ -12,11 +12,29 @@
 #include <timeapi.h>
 #include <windows.h>
 #include <immintrin.h>
-#include <queue>
-#include <condition_variable>
-#include <functional>
+#include <algorithm>
+#include <atomic>
 
 #include "Log.h"
+#include "ThreadPool.h"
+#include "ByteBuffer.h"
+#include "FrameDiff.h"
+#include "TileDiff.h"
+#include "TileHash.h"
+#include "MotionDetect.h"
+#include "FrameCodec.h"
+#include "ChannelPack.h"
+#include "ColorConvert.h"
+#include "FrameScaler.h"
+#include "FramePool.h"
+#include "EncodedFrameRing.h"
+#include "FrameDelivery.h"
+#include "FramePacer.h"
+#include "SpscRing.h"
+#include "SharedFrameRing.h"
+#include "UdpStream.h"
+#include "AccelerationController.h"
+#include "RateController.h"
 #include "lz4/lz4.h"
 
 #pragma comment(lib, "winmm.lib") // 📌 winmm 라이브러리 링크 추가
@@ -25,94 +43,144 @@
 
 using namespace Microsoft::WRL;
 
-
 #define NOFRAMECHANGE 1557
 
-// 전역 변수
-bool capturing = false;
-std::thread captureThread;
-std::mutex captureMutex;
+// 전역 쓰레드 풀 인스턴스 (모든 세션이 공유)
+ThreadPool pool((std::max)(1u, std::thread::hardware_concurrency())); // CPU 코어 수만큼 쓰레드 생성
+
+// 파이프라인 단계 사이를 오가는 프레임 하나의 작업 상태
+struct PipelineFrame {
+	bool stop = false;     // 마지막 항목: 받은 단계는 다음 단계로 넘기고 끝남
+	bool failed = false;   // 앞 단계에서 예외. 순번만 넘김
+	uint64_t sequence = 0;
+	long long startEpochTime = 0;
+	bool changed = false;  // false면 NOFRAMECHANGE (frame은 diff 단계가 기준 프레임으로 채움)
+	bool zeroBase = false; // diff 단계가 기준을 0 프레임으로 다시 잡은 프레임 (FRAME_FLAG_ZERO_BASE)
+	int width = 0;         // 이 프레임의 출력 해상도 (전송률 제어로 세션 해상도보다 작을 수 있음)
+	int height = 0;
+	RateDecision rate;     // acquire 단계에서 정한 fps/해상도/압축 예산
+	FrameLease frame;          // 현재 프레임 (BGRA)
+	FrameLease previousFrame;  // XOR/사전 모드의 기준 (모션 보정 적용 후)
+	ByteBuffer yuvFrame;       // YUV 출력 시 변환한 현재 프레임
+	CopyRectList copyRects;
+	bool motionDetection = false;
+	TileGrid tileGrid;
+	ByteBuffer dirtyBitmap;
+	ByteBuffer tilePixels;
+	int dirtyTileCount = 0;
+};
 
-// DirectX 변수
-ComPtr<ID3D11Device> d3dDevice;
-ComPtr<ID3D11DeviceContext> d3dContext;
-ComPtr<IDXGIOutputDuplication> desktopDuplication;
+// 단계 사이 큐. 파이프라인 안의 프레임 수는 전달 창(DROP_OLDEST는 두 배)으로 묶이므로 넘치지 않음
+const size_t PIPELINE_QUEUE_CAPACITY = 256;
+// 풀 방식에서 호스트가 꺼내 가기를 기다리거나 들고 있을 수 있는 프레임 수
+const size_t ENCODED_FRAME_RING_CAPACITY = 8;
+
+// 캡처 세션 하나의 상태. 세션마다 장치/버퍼/인코더/페이싱을 따로 갖고 쓰레드 풀만 공유
+struct CaptureSession {
+	std::atomic<bool> capturing{ false };
+	std::thread captureThread;
+	std::mutex captureMutex;
+	void (*frameCallback)(FrameData frameData) = nullptr; // 없으면 풀 방식 (AcquireEncodedFrame)
+
+	// DirectX 변수
+	ComPtr<ID3D11Device> d3dDevice;
+	ComPtr<ID3D11DeviceContext> d3dContext;
+	ComPtr<IDXGIOutputDuplication> desktopDuplication;
+	int outputIndex = 0; // 캡처할 모니터 (어댑터 0의 출력 번호)
+
+	// 해상도 및 프레임버퍼
+	int frameWidth = 1920;
+	int frameHeight = 1080;
+	int frameSize = frameWidth * frameHeight * 4;
+	int targetFPS = 60;
+	double frameTime = 1000.0 / targetFPS;
+	// 캡처 프레임 버퍼 풀: 파이프라인 안의 프레임 + 기준 + 보내지 못한 최신 프레임
+	FramePool framePool;
+	FrameLease referenceFrame; // 이전 프레임 (diff 단계 전용). 교체는 lease 대입으로 복사 없음
+	TileHashTable tileHashTable; // CHANGE_DETECT_HASH에서 이전 프레임 대신 사용
+	// diff 단계 뒤에서 프레임을 보내지 못하면 받는 쪽 기준이 어긋나므로 다음 프레임을 0 프레임 기준으로 전부 보냄
+	std::atomic<bool> fullRefreshRequested{ false };
+	MotionDetector motionDetector;
+	FrameScaler frameScaler; // 데스크톱 해상도 -> frameWidth x frameHeight
+	ByteBuffer previousYuvFrameBuffer; // YUV 출력 시 이전 프레임 (XOR/사전 모드, compress 단계 전용)
+
+	// 인코딩 설정
+	int encodeMode = ENCODE_RAW;
+	int tileSize = 64;
+	int changeDetection = CHANGE_DETECT_COMPARE;
+	bool motionDetection = false;
+	int channelLayout = CHANNEL_BGRA;
+	int pixelFormat = PIXEL_FORMAT_BGRA;
+	int colorMatrix = COLOR_MATRIX_BT709;
+	bool fullRange = false;
+	int scaleFilter = SCALE_FILTER_AUTO;
+	AccelerationController accelerationController; // LZ4 acceleration 자동 조정
+	RateController rateController; // 비트레이트 예산에 맞춰 fps/해상도/압축 예산 선택
+	FrameDelivery frameDelivery; // 병렬 인코딩된 프레임을 캡처 순서대로 콜백
+	FramePacer framePacer; // 프레임 시각 유지 (sleep + 짧은 spin)
+	int deliveryWindow = 4; // 인코딩 중이거나 전달을 기다리는 프레임 최대 수
+	int backpressurePolicy = BACKPRESSURE_COALESCE; // 전달 창이 가득 찼을 때 동작
+	EncodedFrameRing encodedFrames{ ENCODED_FRAME_RING_CAPACITY }; // 풀 방식으로 넘길 프레임
+	// 공유 메모리 출력 (이름이 있으면 프레임은 콜백/풀 대신 여기로)
+	std::string sharedMemoryName;
+	int sharedMemorySlots = 8;
+	int sharedMemoryFrameBytes = 0; // 0이면 압축 최악 크기
+	SharedFrameRing sharedFrames;
+	// UDP 출력 (주소가 있으면 프레임은 콜백/풀 대신 패킷으로)
+	std::string udpHost;
+	int udpPort = 0;
+	int udpPacketSize = 1200;
+	int udpFecGroupSize = FecController::FEC_GROUP_ADAPTIVE;
+	UdpSender udpSender;
+
+	// 단계 쓰레드와 단계 사이 큐
+	SpscRing<PipelineFrame> diffQueue{ PIPELINE_QUEUE_CAPACITY };     // acquire -> diff
+	SpscRing<PipelineFrame> convertQueue{ PIPELINE_QUEUE_CAPACITY };  // diff -> convert
+	SpscRing<PipelineFrame> compressQueue{ PIPELINE_QUEUE_CAPACITY }; // convert -> compress
+	std::thread diffThread;
+	std::thread convertThread;
+	std::thread compressThread;
+};
 
-// 해상도 및 프레임버퍼
-int _frameWidth = 1920;
-int _frameHeight = 1080;
-int FRAME_SIZE = _frameWidth * _frameHeight * 4;
-int _targetFPS = 60;
-double frameTime = 1000 / _targetFPS;
-std::vector<unsigned char> previousFrameBuffer(_frameWidth* _frameHeight * 4, 0); // 이전 프레임 버퍼
-std::vector<unsigned char> frameBuffer(_frameWidth* _frameHeight * 4, 0); // 압축 버퍼
+ByteBufferPool encodeBufferPool; // 압축 출력/타일 픽셀/비트맵 버퍼 재사용 (모든 세션 공유)
+BufferPool<CopyRectList> copyRectPool; // 모션 검출 결과 목록 재사용
 
+// 기존 StartCapture/StopCapture/Set* 함수가 쓰는 세션
+CaptureSession defaultSession;
 
 // DLL 로드 테스트 함수
 extern "C" __declspec(dllexport) const char* TestDLL() {
 	return "DLL is successfully loaded!";
 }
 
-// 쓰레드 풀 클래스 정의
-class ThreadPool {
-private:
-	std::vector<std::thread> workers;
-	std::queue<std::function<void()>> tasks;
-	std::mutex queueMutex;
-	std::condition_variable condition;
-	bool stop;
-
-public:
-	explicit ThreadPool(size_t threadCount) : stop(false) {
-		for (size_t i = 0; i < threadCount; ++i) {
-			workers.emplace_back([this] {
-				while (true) {
-					std::function<void()> task;
-					{
-						std::unique_lock<std::mutex> lock(queueMutex);
-						condition.wait(lock, [this] { return stop || !tasks.empty(); });
-						if (stop && tasks.empty()) return;
-						task = std::move(tasks.front());
-						tasks.pop();
-					}
-					task();
-				}
-				});
-		}
-	}
-
-	~ThreadPool() {
-		{
-			std::unique_lock<std::mutex> lock(queueMutex);
-			stop = true;
-		}
-		condition.notify_all();
-		for (std::thread& worker : workers) {
-			worker.join();
-		}
-	}
+// 타일 해시로 변경을 찾는 경우에는 이전 프레임 버퍼가 필요 없음
+// 타일 모드는 BGRA 타일을 그대로 보내므로 YUV 변환을 하지 않음
+bool UsesYuvOutput(const CaptureSession& session) {
+	return session.pixelFormat != PIXEL_FORMAT_BGRA && session.encodeMode != ENCODE_TILE;
+}
 
-	void enqueueTask(std::function<void()> task) {
-		{
-			std::unique_lock<std::mutex> lock(queueMutex);
-			tasks.push(std::move(task));
-		}
-		condition.notify_one();
+// delta 모드는 이미 인코딩된 프레임을 빼면 다음 프레임이 깨지므로 가장 오래된 프레임을 버릴 수 없음
+int EffectiveBackpressurePolicy(const CaptureSession& session) {
+	if (session.backpressurePolicy == BACKPRESSURE_DROP_OLDEST && session.encodeMode != ENCODE_RAW) {
+		return BACKPRESSURE_COALESCE;
 	}
-};
+	return session.backpressurePolicy;
+}
 
-// 전역 쓰레드 풀 인스턴스
-ThreadPool pool(std::thread::hardware_concurrency()); // CPU 코어 수만큼 쓰레드 생성
+// 이전 프레임(BGRA)을 기준으로 유지하는지. YUV 출력은 diff 기준을 YUV로 따로 두지만 프레임 변화가 없을 때 다시 보내려고 유지
+bool UsesPreviousFrame(const CaptureSession& session) {
+	return !(session.encodeMode == ENCODE_TILE && session.changeDetection == CHANGE_DETECT_HASH);
+}
 
 // DirectX 11 초기화 함수
-bool InitializeCapture() {
+bool InitializeCapture(CaptureSession& session) {
 	HRESULT hr;
 
 	// DirectX 11 장치 생성
 	D3D_FEATURE_LEVEL featureLevel;
 	hr = D3D11CreateDevice(
 		nullptr, D3D_DRIVER_TYPE_HARDWARE, nullptr, D3D11_CREATE_DEVICE_BGRA_SUPPORT,
-		nullptr, 0, D3D11_SDK_VERSION, &d3dDevice, &featureLevel, &d3dContext
+		nullptr, 0, D3D11_SDK_VERSION, &session.d3dDevice, &featureLevel, &session.d3dContext
 	);
 
 	if (FAILED(hr)) {
@@ -122,38 +190,71 @@ bool InitializeCapture() {
 
 	// DXGI Factory 및 어댑터 가져오기
 	ComPtr<IDXGIDevice> dxgiDevice;
-	d3dDevice.As(&dxgiDevice);
+	session.d3dDevice.As(&dxgiDevice);
 
 	ComPtr<IDXGIAdapter> adapter;
 	dxgiDevice->GetAdapter(&adapter);
 
 	ComPtr<IDXGIOutput> output;
-	adapter->EnumOutputs(0, &output);
+	hr = adapter->EnumOutputs(session.outputIndex, &output);
+	if (FAILED(hr)) {
+		loge("Failed to find output " + std::to_string(session.outputIndex));
+		return false;
+	}
 
 	ComPtr<IDXGIOutput1> output1;
 	output.As(&output1);
 
 	// Output Duplication 초기화
-	hr = output1->DuplicateOutput(d3dDevice.Get(), &desktopDuplication);
+	hr = output1->DuplicateOutput(session.d3dDevice.Get(), &session.desktopDuplication);
 	if (FAILED(hr)) {
 		loge("Failed to initialize desktop duplication");
 		return false;
 	}
 
-	// 모든 픽셀을 0으로 초기화
-	previousFrameBuffer.resize(FRAME_SIZE);
-	std::fill(previousFrameBuffer.begin(), previousFrameBuffer.end(), 0);
-	frameBuffer.resize(FRAME_SIZE);
-	std::fill(frameBuffer.begin(), frameBuffer.end(), 0);
+	// 기준 프레임은 모든 픽셀을 0으로 초기화
+	// DROP_OLDEST는 버린 프레임도 인코딩이 끝날 때까지 슬롯을 잡고 있음
+	// 풀 방식은 RAW 프레임이 반납될 때까지 링 칸마다 슬롯을 잡고 있음
+	// 나머지: 캡처 중 + 보내지 못한 최신 프레임 + 기준 프레임 + 모션 보정 시 떼어낸 기준 프레임
+	size_t inFlightFrames = session.deliveryWindow * (EffectiveBackpressurePolicy(session) == BACKPRESSURE_DROP_OLDEST ? 2 : 1);
+	if (!session.frameCallback) {
+		inFlightFrames += session.encodedFrames.capacity();
+	}
+	session.framePool.reset(session.frameSize, inFlightFrames + 4);
+	session.referenceFrame.reset();
+	if (UsesPreviousFrame(session)) {
+		session.referenceFrame = session.framePool.acquire();
+		memset(session.referenceFrame.data(), 0, session.referenceFrame.size());
+	}
+	else {
+		session.tileHashTable.reset(makeTileGrid(session.frameWidth, session.frameHeight, session.tileSize));
+	}
+	session.motionDetector.reset(session.frameWidth, session.frameHeight);
+	session.fullRefreshRequested = false;
+	session.accelerationController.reset();
+	session.rateController.reset(session.targetFPS);
+
+	// 수신 측도 0으로 채운 YUV 프레임에서 시작
+	if (UsesYuvOutput(session) && session.encodeMode != ENCODE_RAW) {
+		session.previousYuvFrameBuffer.assign(yuvFrameSize(session.frameWidth, session.frameHeight), 0);
+	}
+	else {
+		ByteBuffer().swap(session.previousYuvFrameBuffer);
+	}
+	if (session.pixelFormat != PIXEL_FORMAT_BGRA && session.encodeMode == ENCODE_TILE) {
+		log("Pixel format is ignored in tile mode (BGRA tiles)");
+	}
+
+	log(std::string("Diff kernel: ") + getDiffKernelName(getActiveDiffKernel()));
 
 	return true;
 }
 
-int AcquireFrame(DXGI_OUTDUPL_FRAME_INFO& frameInfo, ComPtr<IDXGIResource>& desktopResource) {
+int AcquireFrame(CaptureSession& session, DXGI_OUTDUPL_FRAME_INFO& frameInfo, ComPtr<IDXGIResource>& desktopResource, UINT timeoutMs) {
 	HRESULT hr;
 
 	// 새 프레임 가져오기
-	hr = desktopDuplication->AcquireNextFrame(16, &frameInfo, &desktopResource);
+	hr = session.desktopDuplication->AcquireNextFrame(timeoutMs, &frameInfo, &desktopResource);
 	switch (hr) {
 	case DXGI_ERROR_ACCESS_LOST:
 		loge("Access lost");
@@ -174,7 +275,8 @@ int AcquireFrame(DXGI_OUTDUPL_FRAME_INFO& frameInfo, ComPtr<IDXGIResource>& desk
 	return true;
 }
 
-bool MapFrameToCPU(ComPtr<IDXGIResource>& desktopResource, ComPtr<ID3D11Texture2D>& acquiredTexture) {
+// frame은 frameWidth x frameHeight (전송률 제어로 세션 해상도보다 작을 수 있음)
+bool MapFrameToCPU(CaptureSession& session, ComPtr<IDXGIResource>& desktopResource, ComPtr<ID3D11Texture2D>& acquiredTexture, uint8_t* frame, int frameWidth, int frameHeight) {
 	HRESULT hr;
 
 	// 2D 텍스처 가져오기
@@ -189,90 +291,435 @@ bool MapFrameToCPU(ComPtr<IDXGIResource>& desktopResource, ComPtr<ID3D11Texture2
 	textureDesc.MiscFlags = 0;
 
 	ComPtr<ID3D11Texture2D> cpuTexture;
-	hr = d3dDevice->CreateTexture2D(&textureDesc, nullptr, &cpuTexture);
+	hr = session.d3dDevice->CreateTexture2D(&textureDesc, nullptr, &cpuTexture);
 	if (FAILED(hr)) {
 		loge("Failed to create staging texture");
-		desktopDuplication->ReleaseFrame();
+		session.desktopDuplication->ReleaseFrame();
 		return false;
 	}
 
 	// GPU -> CPU 복사
-	d3dContext->CopyResource(cpuTexture.Get(), acquiredTexture.Get());
+	session.d3dContext->CopyResource(cpuTexture.Get(), acquiredTexture.Get());
 
 	// 맵핑하여 데이터 가져오기
 	D3D11_MAPPED_SUBRESOURCE mappedResource;
-	hr = d3dContext->Map(cpuTexture.Get(), 0, D3D11_MAP_READ, 0, &mappedResource);
+	hr = session.d3dContext->Map(cpuTexture.Get(), 0, D3D11_MAP_READ, 0, &mappedResource);
 	if (FAILED(hr)) {
 		loge("Failed to map texture");
-		desktopDuplication->ReleaseFrame();
+		session.desktopDuplication->ReleaseFrame();
 		return false;
 	}
 
-	// 데이터를 frameBuffer로 복사
+	// 데이터를 frame으로 복사 (해상도가 다르면 리샘플링)
 	unsigned char* srcData = static_cast<unsigned char*>(mappedResource.pData);
 	int rowPitch = mappedResource.RowPitch;
+	int srcWidth = static_cast<int>(textureDesc.Width);
+	int srcHeight = static_cast<int>(textureDesc.Height);
 
-	for (int y = 0; y < _frameHeight; ++y) {
-		memcpy(&frameBuffer[y * _frameWidth * 4], &srcData[y * rowPitch], _frameWidth * 4);
+	if (!session.frameScaler.matches(srcWidth, srcHeight, frameWidth, frameHeight, session.scaleFilter)) {
+		session.frameScaler.reset(srcWidth, srcHeight, frameWidth, frameHeight, session.scaleFilter);
+		log("Scale " + std::to_string(srcWidth) + "x" + std::to_string(srcHeight) + " -> " + std::to_string(frameWidth) + "x" + std::to_string(frameHeight) + " (filter " + std::to_string(session.frameScaler.activeFilter()) + ")");
 	}
+	session.frameScaler.scale(srcData, rowPitch, frame, &pool);
 
-	d3dContext->Unmap(cpuTexture.Get(), 0);
-	desktopDuplication->ReleaseFrame();
+	session.d3dContext->Unmap(cpuTexture.Get(), 0);
+	session.desktopDuplication->ReleaseFrame();
 
 	return true;
 }
 
-void calculateDiffSIMD(const uint8_t* currentFrame, const uint8_t* previousFrame, uint8_t* diffBuffer, size_t frameSize) {
-	size_t i = 0;
+// diff 단계: 모션 보정과 변경 타일 탐지. 기준 프레임(session.referenceFrame)은 이 단계만 만짐
+void DiffStage(CaptureSession& session) {
+	bool usesPreviousFrame = UsesPreviousFrame(session);
+	int encodeMode = session.encodeMode;
+	bool yuvOutput = UsesYuvOutput(session);
+	bool motionDetection = session.motionDetection && usesPreviousFrame && !yuvOutput && encodeMode != ENCODE_RAW;
+	// 기준 프레임의 해상도
+	int width = session.frameWidth;
+	int height = session.frameHeight;
+
+	while (true) {
+		PipelineFrame item;
+		session.diffQueue.pop(item);
+		if (item.stop || item.failed) {
+			bool stop = item.stop;
+			session.convertQueue.push(std::move(item));
+			if (stop) {
+				return;
+			}
+			continue;
+		}
 
-	for (; i + 16 <= frameSize; i += 16) { // 16바이트씩 처리
-		__m128i curr = _mm_loadu_si128(reinterpret_cast<const __m128i*>(currentFrame + i));
-		__m128i prev = _mm_loadu_si128(reinterpret_cast<const __m128i*>(previousFrame + i));
-		__m128i diff = _mm_xor_si128(curr, prev);
-		_mm_storeu_si128(reinterpret_cast<__m128i*>(diffBuffer + i), diff);
-	}
+		try {
+			// 해상도가 바뀌면 기준을 새 해상도의 0 프레임으로 다시 잡음 (받는 쪽도 해상도가 바뀐 프레임은 0 프레임 기준)
+			if (!item.changed) {
+				item.width = width;
+				item.height = height;
+			}
+			else if (item.width != width || item.height != height) {
+				if (usesPreviousFrame) {
+					// 뒤 단계가 아직 참조 중이면 새 슬롯에 만듦. 슬롯이 없으면 이 프레임은 버리고 다음 프레임에서 다시 시도
+					if (!session.referenceFrame.unique()) {
+						FrameLease zeroFrame = session.framePool.acquire();
+						if (!zeroFrame) {
+							loge("No frame slot for the resized reference frame");
+							item.failed = true;
+							session.convertQueue.push(std::move(item));
+							continue;
+						}
+						session.referenceFrame = std::move(zeroFrame);
+					}
+					memset(session.referenceFrame.data(), 0, session.referenceFrame.size());
+				}
+				else {
+					session.tileHashTable.reset(makeTileGrid(item.width, item.height, session.tileSize));
+				}
+				session.motionDetector.reset(item.width, item.height);
+				width = item.width;
+				height = item.height;
+				item.zeroBase = true;
+				log("Frame size " + std::to_string(width) + "x" + std::to_string(height));
+			}
+			// UDP 받는 쪽이 프레임을 놓쳤다고 알려도 같은 방식으로 전체 갱신
+			if (session.udpSender.takeKeyframeRequest()) {
+				session.fullRefreshRequested = true;
+			}
+			if (session.fullRefreshRequested.exchange(false) && !item.zeroBase) {
+				// 뒤 단계에서 실패한 프레임이 있으면 해상도 변경과 같이 기준을 0 프레임으로 다시 잡음
+				if (usesPreviousFrame) {
+					// 변화가 없으면 지금 화면(기준 프레임)을 다시 보냄. 슬롯이 없으면 다음 프레임에서 다시 시도
+					FrameLease zeroFrame;
+					if (item.changed && session.referenceFrame.unique()) {
+						zeroFrame = std::move(session.referenceFrame);
+					}
+					else {
+						zeroFrame = session.framePool.acquire();
+					}
+					if (zeroFrame) {
+						if (!item.changed) {
+							item.frame = session.referenceFrame;
+							item.changed = true;
+						}
+						memset(zeroFrame.data(), 0, zeroFrame.size());
+						session.referenceFrame = std::move(zeroFrame);
+						item.zeroBase = true;
+					}
+				}
+				else if (item.changed) {
+					// 해시 모드는 변화가 없는 프레임의 픽셀을 읽지 않으므로 다음 새 화면에서 전부 보냄
+					session.tileHashTable.reset(makeTileGrid(width, height, session.tileSize));
+					item.zeroBase = true;
+				}
+				if (item.zeroBase) {
+					session.motionDetector.reset(width, height);
+					log("Full refresh");
+				}
+				else {
+					session.fullRefreshRequested = true;
+				}
+			}
+
+			// 변화가 없으면 기준 프레임을 그대로 공유 (해시 모드는 변경 타일이 없으므로 픽셀을 읽지 않음)
+			if (!item.changed && usesPreviousFrame) {
+				item.frame = session.referenceFrame;
+			}
 
-	// 남은 부분 처리 (16바이트 단위 미만)
-	for (; i < frameSize; ++i) {
-		diffBuffer[i] = currentFrame[i] ^ previousFrame[i];
+			// 스크롤/창 이동 검출: 이전 프레임에 복사 연산을 먼저 적용해두고 나머지만 diff
+			// 0 프레임 기준이면 복사할 이전 화면이 없음
+			item.motionDetection = motionDetection;
+			if (motionDetection && item.changed && !item.zeroBase) {
+				item.copyRects = copyRectPool.acquire();
+				if (session.motionDetector.detect(item.frame.data(), item.copyRects, &pool) > 0) {
+					// 기준 프레임을 뒤 단계에서도 참조 중이면 제자리 수정 전에 떼어냄
+					if (!session.referenceFrame.unique()) {
+						FrameLease detached = session.framePool.acquire();
+						if (detached) {
+							memcpy(detached.data(), session.referenceFrame.data(), session.referenceFrame.size());
+							session.referenceFrame = std::move(detached);
+						}
+					}
+					if (session.referenceFrame.unique()) {
+						applyCopyRects(session.referenceFrame.data(), width, height, item.copyRects);
+					}
+					else {
+						item.copyRects.clear();
+					}
+				}
+				logd("DetectMotion (" + std::to_string(item.copyRects.size()) + ")", item.startEpochTime);
+			}
+
+			item.tileGrid = makeTileGrid(width, height, session.tileSize);
+			item.tilePixels = encodeBufferPool.acquire();
+			if (encodeMode == ENCODE_TILE) {
+				item.dirtyBitmap = encodeBufferPool.acquire();
+				if (!item.changed) {
+					item.dirtyBitmap.assign(item.tileGrid.bitmapSize(), 0);
+				}
+				else {
+					if (usesPreviousFrame) {
+						item.dirtyTileCount = detectDirtyTiles(item.frame.data(), session.referenceFrame.data(), item.tileGrid, item.dirtyBitmap, &pool);
+					}
+					else {
+						item.dirtyTileCount = session.tileHashTable.detectDirtyTiles(item.frame.data(), item.tileGrid, item.dirtyBitmap, &pool);
+					}
+					packDirtyTiles(item.frame.data(), item.tileGrid, item.dirtyBitmap.data(), item.tilePixels);
+				}
+				logd("DetectDirtyTiles (" + std::to_string(item.dirtyTileCount) + "/" + std::to_string(item.tileGrid.tileCount()) + ")", item.startEpochTime);
+			}
+
+			// 이전 프레임 업데이트 (lease 교체만, 픽셀 복사 없음)
+			if (usesPreviousFrame) {
+				if ((encodeMode == ENCODE_XOR_LZ4 || encodeMode == ENCODE_LZ4_DICT) && !yuvOutput) {
+					item.previousFrame = session.referenceFrame;
+				}
+				session.referenceFrame = item.frame;
+			}
+		}
+		catch (std::exception& e) {
+			loge("Diff stage exception");
+			item.failed = true;
+		}
+		session.convertQueue.push(std::move(item));
 	}
 }
 
-long long _startTime = 0;
+// convert 단계: YUV 변환 (BGRA 출력이면 그대로 넘김)
+void ConvertStage(CaptureSession& session) {
+	bool yuvOutput = UsesYuvOutput(session);
+	int encodeMode = session.encodeMode;
+	int pixelFormat = session.pixelFormat;
+	int colorMatrix = session.colorMatrix;
+	bool fullRange = session.fullRange;
+
+	while (true) {
+		PipelineFrame item;
+		session.convertQueue.pop(item);
+		if (item.stop || item.failed) {
+			bool stop = item.stop;
+			session.compressQueue.push(std::move(item));
+			if (stop) {
+				return;
+			}
+			continue;
+		}
 
-void compressFrame(const uint8_t* currentFrame, const uint8_t* previousFrame, std::vector<unsigned char>& compressedData) {
-	std::vector<unsigned char> diffBuffer(_frameWidth * _frameHeight * 4, 0);
+		// 압축 모드에서 변화가 없으면 compress 단계가 이전 YUV 프레임을 그대로 씀
+		if (yuvOutput && (item.changed || encodeMode == ENCODE_RAW)) {
+			try {
+				item.yuvFrame = encodeBufferPool.acquire();
+				item.yuvFrame.resize(yuvFrameSize(item.width, item.height));
+				convertBgraToYuv(item.frame.data(), item.width, item.height, item.yuvFrame.data(), pixelFormat, colorMatrix, fullRange, &pool);
+				logd("ConvertToYuv", item.startEpochTime);
+			}
+			catch (std::exception& e) {
+				loge("Convert stage exception");
+				item.failed = true;
+			}
+		}
+		session.compressQueue.push(std::move(item));
+	}
+}
 
-	// 변경된 부분 계산
-	calculateDiffSIMD(currentFrame, previousFrame, diffBuffer.data(), FRAME_SIZE);
-	logd("CalculateDiff", _startTime);
+// compress 단계: 인코딩 후 전달 단계로 넘김. previousYuvFrameBuffer는 이 단계만 만짐
+void CompressStage(CaptureSession& session) {
+	int encodeMode = session.encodeMode;
+	int channelLayout = session.channelLayout;
+	bool yuvOutput = UsesYuvOutput(session);
 
-	// LZ4 압축
-	int maxCompressedSize = LZ4_compressBound(diffBuffer.size());
-	compressedData.resize(maxCompressedSize);
-	int compressedSize = LZ4_compress_fast(
-		reinterpret_cast<const char*>(diffBuffer.data()), // unsigned char*를 const char*로 변환
-		reinterpret_cast<char*>(compressedData.data()),
-		diffBuffer.size(),
-		maxCompressedSize,
-		10000);
+	while (true) {
+		PipelineFrame item;
+		session.compressQueue.pop(item);
+		if (item.stop) {
+			return;
+		}
+		// 실패했거나 예외로 빠져나가도 순번은 빈 작업으로 완료됨
+		// diff 단계가 이미 기준을 이 프레임으로 옮겼으므로 다음 프레임은 전체 갱신
+		FrameCompletion completion(session.frameDelivery, item.sequence);
+		if (item.failed) {
+			session.fullRefreshRequested = true;
+			continue;
+		}
+		uint32_t frameFlags = item.zeroBase ? FRAME_FLAG_ZERO_BASE : 0;
 
-	logd("LZ4Compress", _startTime);
+		try {
+			// 단계마다 쓰레드가 따로 있으므로 압축은 프레임 시간 전체를 쓸 수 있음
+			// 전송률 제어가 예산에 여유가 있다고 보면 일부만 써서 (acceleration을 올려) 압축 지연을 줄임
+			double frameInterval = session.frameTime * item.rate.frameDivisor;
+			double compressBudget = frameInterval * item.rate.compressBudgetRatio;
+			int acceleration = session.accelerationController.current();
+			auto compressStartTime = std::chrono::high_resolution_clock::now();
+
+			ByteBuffer compressedData = encodeBufferPool.acquire();
+			FrameLease rawFrame;
+			if (encodeMode == ENCODE_TILE) {
+				if (!compressTiles(item.tileGrid, item.dirtyBitmap, item.dirtyTileCount, item.tilePixels, acceleration, compressedData, &pool, channelLayout, frameFlags)) {
+					loge("CompressTiles failed");
+					session.fullRefreshRequested = true;
+					encodeBufferPool.release(std::move(compressedData));
+					continue;
+				}
+				if (item.dirtyTileCount > 0) {
+					double compressTime = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - compressStartTime).count();
+					session.accelerationController.update(compressTime, compressBudget, item.tilePixels.size(), compressedData.size());
+				}
+				if (item.motionDetection) {
+					prependCopyRects(item.copyRects, compressedData);
+				}
+				logd("CompressTiles", item.startEpochTime);
+			}
+			else if (encodeMode == ENCODE_XOR_LZ4 || encodeMode == ENCODE_LZ4_DICT) {
+				// YUV 출력: 이전 YUV 프레임과 비교/압축 (알파가 없으므로 채널 배치는 BGRA 그대로)
+				const uint8_t* encodeFrame = item.frame.data();
+				const uint8_t* encodePreviousFrame = item.previousFrame.data();
+				size_t encodeFrameSize = static_cast<size_t>(item.width) * item.height * 4;
+				int encodeChannelLayout = channelLayout;
+				if (yuvOutput) {
+					// 기준을 0 프레임으로 다시 잡았으면 (해상도 변경/전체 갱신) 이전 YUV 프레임도 0 프레임에서 다시 시작
+					size_t yuvSize = yuvFrameSize(item.width, item.height);
+					if (session.previousYuvFrameBuffer.size() != yuvSize || item.zeroBase) {
+						session.previousYuvFrameBuffer.assign(yuvSize, 0);
+					}
+					encodeFrame = item.changed ? item.yuvFrame.data() : session.previousYuvFrameBuffer.data();
+					encodePreviousFrame = session.previousYuvFrameBuffer.data();
+					encodeFrameSize = session.previousYuvFrameBuffer.size();
+					encodeChannelLayout = CHANNEL_BGRA;
+				}
 
-	if (compressedSize > 0) {
-		compressedData.resize(compressedSize); // 실제 크기로 축소
-	}
-	else {
-		std::cerr << "Compression failed!" << std::endl;
+				bool compressed = encodeMode == ENCODE_XOR_LZ4
+					? compressFrame(encodeFrame, encodePreviousFrame, encodeFrameSize, acceleration, compressedData, &pool, encodeChannelLayout, frameFlags)
+					: compressFrameWithDict(encodeFrame, encodePreviousFrame, encodeFrameSize, acceleration, compressedData, &pool, encodeChannelLayout, frameFlags);
+				if (!compressed) {
+					// 이전 YUV 프레임은 그대로 두고 다음 프레임을 0 프레임 기준으로 전부 보냄
+					loge(encodeMode == ENCODE_XOR_LZ4 ? "CompressFrame failed" : "CompressFrameWithDict failed");
+					session.fullRefreshRequested = true;
+					encodeBufferPool.release(std::move(compressedData));
+					continue;
+				}
+				double compressTime = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - compressStartTime).count();
+				session.accelerationController.update(compressTime, compressBudget, encodeFrameSize, compressedData.size());
+				if (yuvOutput && item.changed) {
+					std::swap(item.yuvFrame, session.previousYuvFrameBuffer);
+				}
+				if (item.motionDetection) {
+					prependCopyRects(item.copyRects, compressedData);
+				}
+				log("Compressed frame size: " + std::to_string(compressedData.size()) + "/" + std::to_string(encodeFrameSize) + " (acceleration " + std::to_string(acceleration) + ")");
+				logd(encodeMode == ENCODE_XOR_LZ4 ? "CompressFrame" : "CompressFrameWithDict", item.startEpochTime);
+			}
+			else if (yuvOutput) {
+				// RAW: 변환한 YUV 프레임을 그대로 보냄
+				std::swap(compressedData, item.yuvFrame);
+			}
+			else if (channelLayout != CHANNEL_BGRA) {
+				// RAW: 프레임 전체를 채널 배치대로 변환 (평면은 프레임 전체 크기)
+				size_t pixelCount = static_cast<size_t>(item.width) * item.height;
+				compressedData.resize(packedChannelSize(pixelCount, channelLayout));
+				packChannels(item.frame.data(), compressedData.data(), pixelCount, channelLayout);
+			}
+			else {
+				// RAW는 콜백이 끝날 때까지 프레임 슬롯을 잡아둠 (복사 없이 lease만 넘김)
+				rawFrame = std::move(item.frame);
+			}
+
+			// 콜백용 프레임 데이터 생성
+			FrameData frameData;
+			frameData.width = item.width;
+			frameData.height = item.height;
+			frameData.frameRate = session.targetFPS / item.rate.frameDivisor;
+			frameData.timeStamp = item.startEpochTime;
+			if (rawFrame) {
+				frameData.data = rawFrame.data();
+				frameData.dataSize = item.width * item.height * 4;
+			}
+			else {
+				frameData.data = compressedData.data();
+				frameData.dataSize = static_cast<int>(compressedData.size());
+			}
+			session.rateController.record(frameData.dataSize, item.rate);
+
+			encodeBufferPool.release(std::move(item.tilePixels));
+			encodeBufferPool.release(std::move(item.yuvFrame));
+			encodeBufferPool.release(std::move(item.dirtyBitmap));
+			copyRectPool.release(std::move(item.copyRects));
+
+			if (session.sharedFrames.isOpen()) {
+				// 공유 메모리: 전달 쓰레드가 캡처 순서대로 링 칸에 복사하고 버퍼는 바로 재사용
+				completion.complete([sharedFrames = &session.sharedFrames, frameData, compressedData = std::move(compressedData), rawFrame = std::move(rawFrame)]() mutable {
+					if (!sharedFrames->write(frameData)) {
+						log("Shared memory frame dropped");
+					}
+					encodeBufferPool.release(std::move(compressedData));
+					rawFrame.reset();
+					});
+			}
+			else if (session.udpSender.isOpen()) {
+				// UDP: 전달 쓰레드가 캡처 순서대로 프레임 간격에 나눠 보냄
+				completion.complete([udpSender = &session.udpSender, frameTime = frameInterval, frameData, compressedData = std::move(compressedData), rawFrame = std::move(rawFrame)]() mutable {
+					udpSender->send(frameData, frameTime);
+					encodeBufferPool.release(std::move(compressedData));
+					rawFrame.reset();
+					});
+			}
+			else if (session.frameCallback) {
+				// 콜백은 전달 쓰레드에서 캡처 순서대로. 콜백이 끝난 버퍼는 다음 프레임에서 재사용
+				completion.complete([frameCallback = session.frameCallback, frameData, compressedData = std::move(compressedData), rawFrame = std::move(rawFrame)]() mutable {
+					try {
+						frameCallback(frameData);
+					}
+					catch (std::exception& e) {
+						loge("Failed to call frame callback");
+					}
+					encodeBufferPool.release(std::move(compressedData));
+					rawFrame.reset();
+					});
+			}
+			else {
+				// 풀 방식: 전달 쓰레드가 캡처 순서대로 링에 넣고, 버퍼는 호스트가 ReleaseEncodedFrame할 때 재사용
+				// 해제 작업은 전달 시점에 만들어 전달 작업의 캡처가 Task 안에 들어가게 함
+				completion.complete([encodedFrames = &session.encodedFrames, frameData, compressedData = std::move(compressedData), rawFrame = std::move(rawFrame)]() mutable {
+					encodedFrames->push(frameData, Task([compressedData = std::move(compressedData), rawFrame = std::move(rawFrame)]() mutable {
+						encodeBufferPool.release(std::move(compressedData));
+						rawFrame.reset();
+						}));
+					});
+			}
+		}
+		catch (std::exception& e) {
+			loge("Compress stage exception");
+			session.fullRefreshRequested = true;
+		}
 	}
 }
 
-// 캡처 루프
-void CaptureLoop(void (*frameCallback)(FrameData frameData)) {
+// 캡처 루프 (acquire 단계): 프레임을 가져와 CPU로 복사한 뒤 diff 단계로 넘김
+void CaptureLoop(CaptureSession& session) {
 	HRESULT hr;
 	int result;
+	int backpressurePolicy = EffectiveBackpressurePolicy(session);
+	// 전달 창이 가득 차 인코딩하지 못한 최신 프레임. 기준 프레임은 그대로이므로 다음에 보낼 때 delta에 합쳐짐
+	FrameLease pendingFrame;
+
+	// 다음 프레임 시각까지 대기. COALESCE는 창이 비면 들고 있던 프레임을 바로 보내러 깸
+	std::function<bool()> sendPendingEarly = [&]() {
+		return pendingFrame && session.frameDelivery.hasRoom();
+	};
+	auto waitForNextFrame = [&]() {
+		if (backpressurePolicy == BACKPRESSURE_COALESCE && pendingFrame) {
+			session.framePacer.wait(sendPendingEarly);
+		}
+		else {
+			session.framePacer.wait();
+		}
+	};
+	session.framePacer.reset(session.frameTime);
+	// 지금 캡처하는 해상도와 fps 배수. 해상도는 새 화면이 올 때만 바꿈 (들고 있는 프레임/기준 프레임과 맞춤)
+	int captureWidth = session.frameWidth;
+	int captureHeight = session.frameHeight;
+	int captureScaleDivisor = 1;
+	int frameDivisor = 1;
+
 	try {
-		while (capturing) {
+		while (session.capturing) {
 
 			ComPtr<IDXGIResource> desktopResource;
 			DXGI_OUTDUPL_FRAME_INFO frameInfo;
@@ -280,130 +727,838 @@ void CaptureLoop(void (*frameCallback)(FrameData frameData)) {
 
 			log("NEW FRAME");
 
-			auto startTime = std::chrono::high_resolution_clock::now();
 			auto startEpochTime = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
-			_startTime = startEpochTime;
 
-			// 새 프레임 가져오기
-			result = AcquireFrame(frameInfo, desktopResource);
-			if (result == 0 || !capturing)
+			// 캡처할 빈 슬롯. 콜백이 밀려 슬롯이 없으면 이번 프레임은 건너뜀
+			FrameLease currentFrame = session.framePool.acquire();
+			if (!currentFrame) {
+				log("Frame pool exhausted, skipping frame");
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+				continue;
+			}
+
+			// 전송률 제어: UDP 출력이면 받는 쪽 보고로 추정한 링크 속도도 예산에 넣음
+			if (session.udpSender.isOpen()) {
+				session.rateController.setEstimatedBitrate(session.udpSender.counters().estimatedMbps);
+			}
+			RateDecision rate = session.rateController.decide();
+			if (rate.frameDivisor != frameDivisor) {
+				frameDivisor = rate.frameDivisor;
+				session.framePacer.setInterval(session.frameTime * frameDivisor);
+			}
+
+			// 새 프레임 가져오기 (보낼 프레임을 들고 있으면 기다리지 않음)
+			result = AcquireFrame(session, frameInfo, desktopResource, pendingFrame ? 0 : 16);
+			if (result == 0 || !session.capturing)
 			{
 				continue;
 			}
 			logd("AcquireFrame", startEpochTime);
 
 			// CPU로 프레임 데이터 복사 
+			bool changed = true;
 			if (result != NOFRAMECHANGE) {
-				if (!MapFrameToCPU(desktopResource, acquiredTexture) || !capturing) {
+				if (rate.scaleDivisor != captureScaleDivisor) {
+					captureScaleDivisor = rate.scaleDivisor;
+					pendingFrame.reset();
+					captureWidth = captureScaleDivisor == 1 ? session.frameWidth : (std::max)(2, session.frameWidth / captureScaleDivisor & ~1);
+					captureHeight = captureScaleDivisor == 1 ? session.frameHeight : (std::max)(2, session.frameHeight / captureScaleDivisor & ~1);
+				}
+				if (!MapFrameToCPU(session, desktopResource, acquiredTexture, currentFrame.data(), captureWidth, captureHeight) || !session.capturing) {
 					continue;
 				}
 				logd("MapFrameToCPU", startEpochTime);
+				// 새 프레임이 들고 있던 프레임을 대신함
+				pendingFrame.reset();
+			}
+			else if (pendingFrame)
+			{
+				// 화면 변화는 없지만 아직 보내지 못한 최신 프레임이 있음
+				currentFrame = std::move(pendingFrame);
+				logd("Send Pending Frame", startEpochTime);
 			}
-			else if (result == NOFRAMECHANGE)
+			else
 			{
-				frameBuffer = previousFrameBuffer;
+				// diff 단계가 기준 프레임으로 채움
+				changed = false;
+				currentFrame.reset();
 				logd("No Frame Change", startEpochTime);
 			}
 
-
-			pool.enqueueTask([=]() {
-				// 프레임 압축
-				//std::vector<unsigned char> compressedData;
-				//compressFrame(frameBuffer.data(), previousFrameBuffer.data(), compressedData);
-				//log("Compressed frame size: " + std::to_string(compressedData.size()) + "/" + std::to_string(frameBuffer.size()));
-				//logd("CompressFrame", startEpochTime);
-
-				// 콜백용 프레임 데이터 생성
-				FrameData frameData;
-				//frameData.data = compressedData.data();
-				frameData.data = frameBuffer.data();
-				frameData.width = _frameWidth;
-				frameData.height = _frameHeight;
-				frameData.frameRate = _targetFPS;
-
-				//frameData.dataSize = compressedData.size();
-				frameData.dataSize = frameBuffer.size();
-				frameData.timeStamp = startEpochTime;
-
-				try {
-					frameCallback(frameData);
-				}
-				catch (std::exception& e) {
-					loge("Failed to call frame callback");
+			// 전달 순번. 창이 가득 차면 정책에 따라 기다리거나 이 프레임을 인코딩하지 않음
+			// (변경 탐지/해시/모션 기준은 인코딩한 프레임으로만 갱신되어야 하므로 그 전에 결정)
+			uint64_t sequence;
+			if (!session.frameDelivery.reserve(sequence)) {
+				if (!session.capturing) {
+					continue;
 				}
-				});
-			
-			// 이전 프레임 버퍼 업데이트
-			previousFrameBuffer = frameBuffer;
-
-			while (true) {
-				auto now = std::chrono::high_resolution_clock::now();
-				double elapsedTime = std::chrono::duration<double, std::milli>(now - startTime).count();
-				if (elapsedTime >= frameTime) {
-					break;
+				if (changed) {
+					pendingFrame = std::move(currentFrame);
 				}
+				log("Delivery window full, holding frame");
+				waitForNextFrame();
+				continue;
 			}
+
+			PipelineFrame item;
+			item.sequence = sequence;
+			item.startEpochTime = startEpochTime;
+			item.changed = changed;
+			item.width = captureWidth;
+			item.height = captureHeight;
+			item.rate = rate;
+			item.rate.scaleDivisor = captureScaleDivisor;
+			item.frame = std::move(currentFrame);
+			session.diffQueue.push(std::move(item));
+
+			waitForNextFrame();
 		}
 	}
 	catch (std::exception& e) {
 		loge("Capture loop exception");
 	}
+
+	// 뒤 단계들이 남은 프레임을 마저 처리하고 끝나도록 알림
+	PipelineFrame stopItem;
+	stopItem.stop = true;
+	session.diffQueue.push(std::move(stopItem));
 }
 
+// DirectX 자원 해제
+static void releaseCapture(CaptureSession& session) {
+	if (session.desktopDuplication) {
+		log("Releasing desktopDuplication");
+		session.desktopDuplication = nullptr;
+	}
+	if (session.d3dContext) {
+		log("Releasing d3dContext");
+		session.d3dContext = nullptr;
+	}
+	if (session.d3dDevice) {
+		log("Releasing d3dDevice");
+		session.d3dDevice = nullptr;
+	}
+}
 
+// 캡처 시작 (이미 캡처 중이면 그대로 둠)
+static bool startSession(CaptureSession& session, void (*frameCallback)(FrameData frameData), int frameWidth, int frameHeight, int frameRate) {
+	std::lock_guard<std::mutex> lock(session.captureMutex);
+	if (session.capturing) {
+		return true;
+	}
+	// frameTime = 1000 / frameRate 이므로 0이나 음수면 페이싱/전송률 제어가 모두 깨짐
+	if (frameRate <= 0) {
+		loge("Invalid frame rate " + std::to_string(frameRate));
+		return false;
+	}
+	if (frameWidth <= 0 || frameHeight <= 0) {
+		loge("Invalid frame size " + std::to_string(frameWidth) + "x" + std::to_string(frameHeight));
+		return false;
+	}
 
-// 캡처 시작
-extern "C" __declspec(dllexport) void StartCapture(void (*frameCallback)(FrameData frameData), int frameWidth, int frameHeight, int frameRate) {
-	_frameWidth = frameWidth;
-	_frameHeight = frameHeight;
-	FRAME_SIZE = _frameWidth * _frameHeight * 4;
-	_targetFPS = frameRate;
-	frameTime = 1000.0 / _targetFPS;
-
-	std::lock_guard<std::mutex> lock(captureMutex);
-	if (!capturing) {
-		if (!InitializeCapture()) {
-			capturing = false;
-			loge("Failed to initialize capture");
-			return;
+	session.frameWidth = frameWidth;
+	session.frameHeight = frameHeight;
+	session.frameSize = session.frameWidth * session.frameHeight * 4;
+	session.targetFPS = frameRate;
+	session.frameTime = 1000.0 / session.targetFPS;
+	session.frameCallback = frameCallback;
+
+	if (!InitializeCapture(session)) {
+		releaseCapture(session);
+		loge("Failed to initialize capture");
+		return false;
+	}
+
+	if (!session.sharedMemoryName.empty()) {
+		// LZ4 최악 크기 (n + n/255 + 16)에 타일/모션 헤더 여유
+		int maxFrameBytes = session.sharedMemoryFrameBytes > 0 ? session.sharedMemoryFrameBytes : session.frameSize + session.frameSize / 255 + 65536;
+		if (!session.sharedFrames.create(session.sharedMemoryName, session.sharedMemorySlots, maxFrameBytes)) {
+			releaseCapture(session);
+			loge("Failed to create shared memory ring " + session.sharedMemoryName);
+			return false;
 		}
+	}
+
+	session.udpSender.configureFec(session.udpFecGroupSize);
+	if (!session.udpHost.empty() && !session.udpSender.open(session.udpHost, session.udpPort, session.udpPacketSize)) {
+		session.sharedFrames.close();
+		releaseCapture(session);
+		loge("Failed to open UDP output " + session.udpHost);
+		return false;
+	}
 
-		capturing = true;
-		captureThread = std::thread(CaptureLoop, frameCallback);
+	session.encodedFrames.open();
+	if (!session.frameDelivery.start(session.deliveryWindow, EffectiveBackpressurePolicy(session))) {
+		session.encodedFrames.close();
+		session.sharedFrames.close();
+		session.udpSender.close();
+		releaseCapture(session);
+		loge("Capture cannot be restarted from its own frame callback");
+		return false;
 	}
+	session.capturing = true;
+	// acquire -> diff -> convert -> compress -> deliver 단계마다 쓰레드 하나
+	session.compressThread = std::thread(CompressStage, std::ref(session));
+	session.convertThread = std::thread(ConvertStage, std::ref(session));
+	session.diffThread = std::thread(DiffStage, std::ref(session));
+	session.captureThread = std::thread(CaptureLoop, std::ref(session));
+	return true;
 }
 
 // 캡처 중지
-extern "C" __declspec(dllexport) void StopCapture() {
+static void stopSession(CaptureSession& session) {
 	log("Stop capture");
-	std::lock_guard<std::mutex> lock(captureMutex);
-	capturing = false;
+	std::lock_guard<std::mutex> lock(session.captureMutex);
+	session.capturing = false;
+
+	// 콜백 안에서 멈춤: 전달 쓰레드는 자신을 기다릴 수 없으므로 먼저 멈춤 표시만 함
+	// 창을 기다리던 캡처 쓰레드가 깨어나고, 남은 프레임은 전달하지 않고 버림
+	if (session.frameDelivery.isDeliveryThread()) {
+		log("Stop capture from the frame callback");
+		session.frameDelivery.stop();
+	}
 
-	if (captureThread.joinable()) {
+	if (session.captureThread.joinable()) {
 		try {
 			log("Joining captureThread");
-			captureThread.join();
+			session.captureThread.join();
 		}
 		catch (...) {
 			loge("Error while joining captureThread");
 		}
 	}
 
-	// DirectX 자원 해제
-	if (desktopDuplication) {
-		log("Releasing desktopDuplication");
-		desktopDuplication->Release();
-		desktopDuplication = nullptr;
+	// 캡처 루프가 보낸 종료 항목을 따라 뒤 단계들이 차례로 끝남
+	for (std::thread* stage : { &session.diffThread, &session.convertThread, &session.compressThread }) {
+		if (stage->joinable()) {
+			stage->join();
+		}
 	}
-	if (d3dContext) {
-		log("Releasing d3dContext");
-		d3dContext->Release();
-		d3dContext = nullptr;
+
+	// 인코딩 중인 프레임까지 모두 전달한 뒤 반환
+	// 풀 방식은 링을 먼저 닫아 호스트가 꺼내 가지 않아도 멈출 수 있게 함 (자리가 없는 프레임은 버림)
+	log("Flushing frame delivery");
+	session.encodedFrames.close();
+	session.sharedFrames.stop();
+	session.frameDelivery.stop();
+	session.sharedFrames.close();
+	session.udpSender.close();
+
+	releaseCapture(session);
+	log("Capture stopped");
+}
+
+// 설정 함수 공통: 캡처 중에는 바꿀 수 없음
+static bool canConfigure(CaptureSession& session, const char* name) {
+	if (session.capturing) {
+		loge(std::string(name) + " must be called before StartCapture");
+		return false;
 	}
-	if (d3dDevice) {
-		log("Releasing d3dDevice");
-		d3dDevice->Release();
-		d3dDevice = nullptr;
+	return true;
+}
+
+// 캡처할 모니터 설정 (어댑터 0의 출력 번호)
+static void setOutput(CaptureSession& session, int outputIndex) {
+	std::lock_guard<std::mutex> lock(session.captureMutex);
+	if (!canConfigure(session, "SetOutput")) {
+		return;
 	}
-	log("Capture stopped");
-}
\ No newline at end of file
+	if (outputIndex < 0) {
+		loge("Invalid output index");
+		return;
+	}
+	session.outputIndex = outputIndex;
+}
+
+// 인코딩 방식 설정
+static void setEncodeMode(CaptureSession& session, int encodeMode) {
+	std::lock_guard<std::mutex> lock(session.captureMutex);
+	if (!canConfigure(session, "SetEncodeMode")) {
+		return;
+	}
+	if (encodeMode < ENCODE_RAW || encodeMode > ENCODE_LZ4_DICT) {
+		loge("Invalid encode mode");
+		return;
+	}
+	session.encodeMode = encodeMode;
+}
+
+// 타일 크기 설정 (8의 배수, 8~256 픽셀)
+static void setTileSize(CaptureSession& session, int tileSize) {
+	std::lock_guard<std::mutex> lock(session.captureMutex);
+	if (!canConfigure(session, "SetTileSize")) {
+		return;
+	}
+	tileSize = (std::max)(8, (std::min)(256, tileSize));
+	session.tileSize = tileSize & ~7;
+}
+
+// 변경 타일 탐지 방식 설정 (ENCODE_TILE 전용)
+static void setChangeDetection(CaptureSession& session, int changeDetection) {
+	std::lock_guard<std::mutex> lock(session.captureMutex);
+	if (!canConfigure(session, "SetChangeDetection")) {
+		return;
+	}
+	if (changeDetection < CHANGE_DETECT_COMPARE || changeDetection > CHANGE_DETECT_HASH) {
+		loge("Invalid change detection");
+		return;
+	}
+	session.changeDetection = changeDetection;
+}
+
+// 스크롤/창 이동 검출 설정 (이전 프레임을 쓰는 모드 전용)
+static void setMotionDetection(CaptureSession& session, int enabled) {
+	std::lock_guard<std::mutex> lock(session.captureMutex);
+	if (!canConfigure(session, "SetMotionDetection")) {
+		return;
+	}
+	session.motionDetection = enabled != 0;
+}
+
+// 압축 전 채널 배치 설정 (ChannelLayout)
+static void setChannelLayout(CaptureSession& session, int channelLayout) {
+	std::lock_guard<std::mutex> lock(session.captureMutex);
+	if (!canConfigure(session, "SetChannelLayout")) {
+		return;
+	}
+	if (channelLayout < CHANNEL_BGRA || channelLayout > CHANNEL_PLANAR) {
+		loge("Invalid channel layout");
+		return;
+	}
+	session.channelLayout = channelLayout;
+}
+
+// 압축 전 픽셀 형식 설정 (PixelFormat, ColorMatrix)
+static void setPixelFormat(CaptureSession& session, int pixelFormat, int colorMatrix, int fullRange) {
+	std::lock_guard<std::mutex> lock(session.captureMutex);
+	if (!canConfigure(session, "SetPixelFormat")) {
+		return;
+	}
+	if (pixelFormat < PIXEL_FORMAT_BGRA || pixelFormat > PIXEL_FORMAT_I420 || colorMatrix < COLOR_MATRIX_BT601 || colorMatrix > COLOR_MATRIX_BT709) {
+		loge("Invalid pixel format");
+		return;
+	}
+	session.pixelFormat = pixelFormat;
+	session.colorMatrix = colorMatrix;
+	session.fullRange = fullRange != 0;
+}
+
+// 리샘플링 필터 설정 (ScaleFilter)
+static void setScaleFilter(CaptureSession& session, int scaleFilter) {
+	std::lock_guard<std::mutex> lock(session.captureMutex);
+	if (!canConfigure(session, "SetScaleFilter")) {
+		return;
+	}
+	if (scaleFilter < SCALE_FILTER_AUTO || scaleFilter > SCALE_FILTER_AREA) {
+		loge("Invalid scale filter");
+		return;
+	}
+	session.scaleFilter = scaleFilter;
+}
+
+// LZ4 acceleration 범위 설정 (1~65537, 낮을수록 압축률 우선)
+// 범위 안에서 프레임 예산에 맞춰 자동 조정되며, min == max 이면 고정값
+static void setCompressionAcceleration(CaptureSession& session, int minAcceleration, int maxAcceleration) {
+	std::lock_guard<std::mutex> lock(session.captureMutex);
+	if (!canConfigure(session, "SetCompressionAcceleration")) {
+		return;
+	}
+	session.accelerationController.configure(minAcceleration, maxAcceleration);
+}
+
+// 전달 창 크기 설정 (1~64 프레임)
+static void setDeliveryWindow(CaptureSession& session, int frames) {
+	std::lock_guard<std::mutex> lock(session.captureMutex);
+	if (!canConfigure(session, "SetDeliveryWindow")) {
+		return;
+	}
+	session.deliveryWindow = (std::max)(1, (std::min)(64, frames));
+}
+
+// 공유 메모리 출력 설정. name이 비어 있으면 끔
+static void setSharedMemoryOutput(CaptureSession& session, const char* name, int slotCount, int maxFrameBytes) {
+	std::lock_guard<std::mutex> lock(session.captureMutex);
+	if (!canConfigure(session, "SetSessionSharedMemoryOutput")) {
+		return;
+	}
+	session.sharedMemoryName = name ? name : "";
+	session.sharedMemorySlots = (std::max)(2, (std::min)(256, slotCount));
+	session.sharedMemoryFrameBytes = (std::max)(0, maxFrameBytes);
+}
+
+// UDP 출력 설정. host가 비어 있으면 끔
+static void setUdpOutput(CaptureSession& session, const char* host, int port, int packetSize) {
+	std::lock_guard<std::mutex> lock(session.captureMutex);
+	if (!canConfigure(session, "SetSessionUdpOutput")) {
+		return;
+	}
+	if (host && *host && (port <= 0 || port > 65535)) {
+		loge("Invalid UDP port");
+		return;
+	}
+	session.udpHost = host ? host : "";
+	session.udpPort = port;
+	// 헤더보다 크고 IPv4 UDP 최대 페이로드 이하
+	session.udpPacketSize = packetSize > 0 ? (std::max)(256, (std::min)(65507, packetSize)) : 1200;
+}
+
+// UDP 패리티 그룹 크기 설정
+static void setUdpFec(CaptureSession& session, int groupSize) {
+	std::lock_guard<std::mutex> lock(session.captureMutex);
+	if (!canConfigure(session, "SetSessionUdpFec")) {
+		return;
+	}
+	if (groupSize < FecController::FEC_GROUP_ADAPTIVE || groupSize == 1 || groupSize > 255) {
+		loge("Invalid FEC group size");
+		return;
+	}
+	session.udpFecGroupSize = groupSize;
+}
+
+// 전달 창이 가득 찼을 때 동작 설정
+static void setBackpressurePolicy(CaptureSession& session, int policy) {
+	std::lock_guard<std::mutex> lock(session.captureMutex);
+	if (!canConfigure(session, "SetBackpressurePolicy")) {
+		return;
+	}
+	if (policy < BACKPRESSURE_BLOCK || policy > BACKPRESSURE_COALESCE) {
+		loge("Invalid backpressure policy");
+		return;
+	}
+	session.backpressurePolicy = policy;
+}
+
+// 전송률 제어 목표 (캡처 중에도 바꿀 수 있음)
+static void setTargetBitrate(CaptureSession& session, double targetMbps) {
+	session.rateController.configure(targetMbps);
+}
+
+static void getRateStats(CaptureSession& session, RateControlStats* stats) {
+	if (!stats) {
+		return;
+	}
+	RateControlCounters counters = session.rateController.counters();
+	stats->targetMbps = counters.targetMbps;
+	stats->estimatedMbps = counters.estimatedMbps;
+	stats->budgetMbps = counters.budgetMbps;
+	stats->measuredMbps = counters.measuredMbps;
+	stats->bufferDelayMs = counters.bufferDelayMs;
+	stats->frameRate = session.targetFPS / counters.decision.frameDivisor;
+	stats->scaleDivisor = counters.decision.scaleDivisor;
+	stats->compressBudgetRatio = counters.decision.compressBudgetRatio;
+	stats->levelChanges = counters.levelChanges;
+	stats->scaleChanges = counters.scaleChanges;
+}
+
+static void getDeliveryStats(CaptureSession& session, DeliveryStats* stats) {
+	if (!stats) {
+		return;
+	}
+	DeliveryCounters counters = session.frameDelivery.counters();
+	stats->deliveredFrames = counters.deliveredFrames;
+	stats->reorderedFrames = counters.reorderedFrames;
+	stats->averageWaitMs = counters.deliveredFrames > 0 ? counters.totalWaitMs / counters.deliveredFrames : 0;
+	stats->maxWaitMs = counters.maxWaitMs;
+	stats->windowStalls = counters.windowStalls;
+	stats->totalStallMs = counters.totalStallMs;
+	stats->droppedFrames = counters.droppedFrames;
+	stats->coalescedFrames = counters.coalescedFrames;
+	stats->failedDeliveries = counters.failedDeliveries;
+}
+
+static void getPacerStats(CaptureSession& session, PacerStats* stats) {
+	if (!stats) {
+		return;
+	}
+	PacerCounters counters = session.framePacer.counters();
+	stats->frames = counters.frames;
+	stats->missedDeadlines = counters.missedDeadlines;
+	stats->averageLatenessMs = counters.frames > 0 ? counters.totalLatenessMs / counters.frames : 0;
+	stats->maxLatenessMs = counters.maxLatenessMs;
+	for (int i = 0; i < PACER_HISTOGRAM_BUCKETS; ++i) {
+		stats->latenessHistogram[i] = counters.latenessHistogram[i];
+	}
+}
+
+// 세션 API: 세션마다 해상도/설정/파이프라인이 따로 있고 쓰레드 풀만 공유
+extern "C" __declspec(dllexport) CaptureSessionHandle CreateSession() {
+	return new CaptureSession();
+}
+
+extern "C" __declspec(dllexport) int StartSession(CaptureSessionHandle session, void (*frameCallback)(FrameData frameData), int frameWidth, int frameHeight, int frameRate) {
+	if (!session) {
+		loge("Invalid session");
+		return 0;
+	}
+	return startSession(*session, frameCallback, frameWidth, frameHeight, frameRate) ? 1 : 0;
+}
+
+extern "C" __declspec(dllexport) void StopSession(CaptureSessionHandle session) {
+	if (session) {
+		stopSession(*session);
+	}
+}
+
+// 캡처 중이면 멈춘 뒤 해제
+extern "C" __declspec(dllexport) void DestroySession(CaptureSessionHandle session) {
+	if (session) {
+		stopSession(*session);
+		// 콜백이 돌아온 뒤에도 전달 쓰레드가 세션을 만지므로 해제하지 않음
+		if (session->frameDelivery.isDeliveryThread()) {
+			loge("DestroySession cannot be called from the frame callback; the session was only stopped");
+			return;
+		}
+		delete session;
+	}
+}
+
+// 풀 방식 (StartSession에 frameCallback 없이 시작한 세션)
+// 반환된 FrameData와 data는 ReleaseEncodedFrame 전까지 유효
+extern "C" __declspec(dllexport) const FrameData* AcquireEncodedFrame(CaptureSessionHandle session, int timeoutMs) {
+	if (!session) {
+		return nullptr;
+	}
+	return session->encodedFrames.acquire(timeoutMs);
+}
+
+extern "C" __declspec(dllexport) void ReleaseEncodedFrame(CaptureSessionHandle session, const FrameData* frame) {
+	if (!session || !frame) {
+		return;
+	}
+	if (!session->encodedFrames.release(frame)) {
+		loge("ReleaseEncodedFrame must be called in AcquireEncodedFrame order");
+	}
+}
+
+extern "C" __declspec(dllexport) void SetSessionSharedMemoryOutput(CaptureSessionHandle session, const char* name, int slotCount, int maxFrameBytes) {
+	if (session) {
+		setSharedMemoryOutput(*session, name, slotCount, maxFrameBytes);
+	}
+}
+
+extern "C" __declspec(dllexport) void SetSessionUdpOutput(CaptureSessionHandle session, const char* host, int port, int packetSize) {
+	if (session) {
+		setUdpOutput(*session, host, port, packetSize);
+	}
+}
+
+extern "C" __declspec(dllexport) void GetSessionUdpStats(CaptureSessionHandle session, UdpSenderStats* stats) {
+	if (!session || !stats) {
+		return;
+	}
+	UdpSenderCounters counters = session->udpSender.counters();
+	stats->framesSent = counters.framesSent;
+	stats->packetsSent = counters.packetsSent;
+	stats->bytesSent = counters.bytesSent;
+	stats->sendErrors = counters.sendErrors;
+	stats->oversizedFrames = counters.oversizedFrames;
+	stats->averageSendMs = counters.framesSent > 0 ? counters.totalSendMs / counters.framesSent : 0;
+	stats->maxSendMs = counters.maxSendMs;
+	stats->parityPacketsSent = counters.parityPacketsSent;
+	stats->fecGroupSize = counters.fecGroupSize;
+	stats->reportedLossRate = counters.reportedLossRate;
+	double megabits = counters.bytesSent * 8 / 1e6;
+	stats->fecEncodeUsPerMbit = megabits > 0 ? counters.totalFecMs * 1000 / megabits : 0;
+	stats->estimatedMbps = counters.estimatedMbps;
+	stats->queueDelayMs = counters.queueDelayMs;
+	stats->sendBlocked = counters.sendBlocked;
+	stats->keyframeRequests = counters.keyframeRequests;
+}
+
+extern "C" __declspec(dllexport) void SetSessionUdpFec(CaptureSessionHandle session, int groupSize) {
+	if (session) {
+		setUdpFec(*session, groupSize);
+	}
+}
+
+// UDP로 보낸 프레임을 받는 쪽
+struct UdpFrameReceiver {
+	UdpReceiver receiver;
+};
+
+extern "C" __declspec(dllexport) UdpReceiverHandle CreateUdpReceiver(int port, void (*frameCallback)(FrameData frameData)) {
+	if (!frameCallback) {
+		return nullptr;
+	}
+	UdpFrameReceiver* receiver = new UdpFrameReceiver();
+	bool started = receiver->receiver.start(port, [frameCallback](const FrameData& frameData) {
+		frameCallback(frameData);
+		});
+	if (!started) {
+		delete receiver;
+		return nullptr;
+	}
+	return receiver;
+}
+
+extern "C" __declspec(dllexport) void DestroyUdpReceiver(UdpReceiverHandle receiver) {
+	if (receiver) {
+		receiver->receiver.stop();
+		// 콜백이 돌아온 뒤에도 받는 쓰레드가 receiver를 만지므로 해제하지 않음
+		if (receiver->receiver.isReceiveThread()) {
+			loge("DestroyUdpReceiver cannot be called from the frame callback; the receiver was only stopped");
+			return;
+		}
+		delete receiver;
+	}
+}
+
+extern "C" __declspec(dllexport) void GetUdpReceiverStats(UdpReceiverHandle receiver, UdpReceiverStats* stats) {
+	if (!receiver || !stats) {
+		return;
+	}
+	ReassemblyCounters counters = receiver->receiver.counters();
+	stats->packetsReceived = counters.packetsReceived;
+	stats->packetsLost = counters.packetsLost;
+	stats->packetsReordered = counters.packetsReordered;
+	stats->invalidPackets = counters.invalidPackets;
+	stats->framesReceived = counters.framesReceived;
+	stats->framesDropped = counters.framesDropped;
+	stats->bytesReceived = counters.bytesReceived;
+	stats->averageLatencyMs = counters.framesReceived > 0 ? counters.totalLatencyMs / counters.framesReceived : 0;
+	stats->maxLatencyMs = counters.maxLatencyMs;
+	stats->parityPacketsReceived = counters.parityPacketsReceived;
+	stats->packetsRecovered = counters.packetsRecovered;
+	stats->recoveryRate = counters.packetsLost > 0 ? (std::min)(1.0, static_cast<double>(counters.packetsRecovered) / counters.packetsLost) : 0;
+	double megabits = counters.bytesReceived * 8 / 1e6;
+	stats->fecDecodeUsPerMbit = megabits > 0 ? counters.totalRecoveryMs * 1000 / megabits : 0;
+	LinkEmulatorCounters link = receiver->receiver.linkCounters();
+	stats->simulatedDrops = link.queueDrops + link.lossDrops;
+}
+
+extern "C" __declspec(dllexport) int GetLinkEmulationPreset(int preset, LinkEmulationSettings* settings) {
+	if (!settings) {
+		return 0;
+	}
+	return LinkEmulator::preset(preset, *settings) ? 1 : 0;
+}
+
+extern "C" __declspec(dllexport) void SetUdpReceiverLinkEmulation(UdpReceiverHandle receiver, const LinkEmulationSettings* settings, int seed) {
+	if (receiver) {
+		receiver->receiver.setLinkEmulation(settings, static_cast<uint32_t>(seed));
+	}
+}
+
+extern "C" __declspec(dllexport) void GetUdpReceiverLinkStats(UdpReceiverHandle receiver, LinkEmulatorStats* stats) {
+	if (!receiver || !stats) {
+		return;
+	}
+	LinkEmulatorCounters counters = receiver->receiver.linkCounters();
+	stats->packetsIn = counters.packetsIn;
+	stats->packetsDelivered = counters.packetsDelivered;
+	stats->queueDrops = counters.queueDrops;
+	stats->lossDrops = counters.lossDrops;
+	stats->burstLosses = counters.burstLosses;
+	stats->reorderedPackets = counters.reorderedPackets;
+	stats->averageDelayMs = counters.packetsDelivered > 0 ? counters.totalDelayMs / counters.packetsDelivered : 0;
+	stats->maxDelayMs = counters.maxDelayMs;
+	stats->maxQueueBytes = counters.maxQueueBytes;
+}
+
+// 공유 메모리 링을 읽는 쪽 (다른 프로세스에서 이 DLL로 읽을 때)
+struct SharedFrameReader {
+	SharedFrameRing ring;
+	FrameData frameData;
+};
+
+extern "C" __declspec(dllexport) SharedFrameReaderHandle OpenSharedFrameReader(const char* name) {
+	if (!name) {
+		return nullptr;
+	}
+	SharedFrameReader* reader = new SharedFrameReader();
+	if (!reader->ring.open(name)) {
+		delete reader;
+		return nullptr;
+	}
+	return reader;
+}
+
+extern "C" __declspec(dllexport) const FrameData* AcquireSharedFrame(SharedFrameReaderHandle reader, int timeoutMs) {
+	if (!reader) {
+		return nullptr;
+	}
+	const SharedFrameHeader* frame = reader->ring.acquire(timeoutMs);
+	if (!frame) {
+		return nullptr;
+	}
+	reader->frameData.data = const_cast<unsigned char*>(SharedFrameRing::data(frame));
+	reader->frameData.width = frame->width;
+	reader->frameData.height = frame->height;
+	reader->frameData.frameRate = frame->frameRate;
+	reader->frameData.dataSize = frame->dataSize;
+	reader->frameData.timeStamp = frame->timeStamp;
+	return &reader->frameData;
+}
+
+extern "C" __declspec(dllexport) void ReleaseSharedFrame(SharedFrameReaderHandle reader) {
+	if (reader) {
+		reader->ring.release();
+	}
+}
+
+extern "C" __declspec(dllexport) void CloseSharedFrameReader(SharedFrameReaderHandle reader) {
+	delete reader;
+}
+
+extern "C" __declspec(dllexport) void SetSessionOutput(CaptureSessionHandle session, int outputIndex) {
+	if (session) {
+		setOutput(*session, outputIndex);
+	}
+}
+
+extern "C" __declspec(dllexport) void SetSessionEncodeMode(CaptureSessionHandle session, int encodeMode) {
+	if (session) {
+		setEncodeMode(*session, encodeMode);
+	}
+}
+
+extern "C" __declspec(dllexport) void SetSessionTileSize(CaptureSessionHandle session, int tileSize) {
+	if (session) {
+		setTileSize(*session, tileSize);
+	}
+}
+
+extern "C" __declspec(dllexport) void SetSessionChangeDetection(CaptureSessionHandle session, int changeDetection) {
+	if (session) {
+		setChangeDetection(*session, changeDetection);
+	}
+}
+
+extern "C" __declspec(dllexport) void SetSessionMotionDetection(CaptureSessionHandle session, int enabled) {
+	if (session) {
+		setMotionDetection(*session, enabled);
+	}
+}
+
+extern "C" __declspec(dllexport) void SetSessionChannelLayout(CaptureSessionHandle session, int channelLayout) {
+	if (session) {
+		setChannelLayout(*session, channelLayout);
+	}
+}
+
+extern "C" __declspec(dllexport) void SetSessionPixelFormat(CaptureSessionHandle session, int pixelFormat, int colorMatrix, int fullRange) {
+	if (session) {
+		setPixelFormat(*session, pixelFormat, colorMatrix, fullRange);
+	}
+}
+
+extern "C" __declspec(dllexport) void SetSessionScaleFilter(CaptureSessionHandle session, int scaleFilter) {
+	if (session) {
+		setScaleFilter(*session, scaleFilter);
+	}
+}
+
+extern "C" __declspec(dllexport) void SetSessionCompressionAcceleration(CaptureSessionHandle session, int minAcceleration, int maxAcceleration) {
+	if (session) {
+		setCompressionAcceleration(*session, minAcceleration, maxAcceleration);
+	}
+}
+
+extern "C" __declspec(dllexport) void SetSessionDeliveryWindow(CaptureSessionHandle session, int frames) {
+	if (session) {
+		setDeliveryWindow(*session, frames);
+	}
+}
+
+extern "C" __declspec(dllexport) void SetSessionBackpressurePolicy(CaptureSessionHandle session, int policy) {
+	if (session) {
+		setBackpressurePolicy(*session, policy);
+	}
+}
+
+extern "C" __declspec(dllexport) void GetSessionDeliveryStats(CaptureSessionHandle session, DeliveryStats* stats) {
+	if (session) {
+		getDeliveryStats(*session, stats);
+	}
+}
+
+extern "C" __declspec(dllexport) void GetSessionPacerStats(CaptureSessionHandle session, PacerStats* stats) {
+	if (session) {
+		getPacerStats(*session, stats);
+	}
+}
+
+extern "C" __declspec(dllexport) void SetSessionTargetBitrate(CaptureSessionHandle session, double targetMbps) {
+	if (session) {
+		setTargetBitrate(*session, targetMbps);
+	}
+}
+
+extern "C" __declspec(dllexport) void GetSessionRateStats(CaptureSessionHandle session, RateControlStats* stats) {
+	if (session) {
+		getRateStats(*session, stats);
+	}
+}
+
+// 기존 API: 기본 세션 하나를 사용
+extern "C" __declspec(dllexport) void StartCapture(void (*frameCallback)(FrameData frameData), int frameWidth, int frameHeight, int frameRate) {
+	startSession(defaultSession, frameCallback, frameWidth, frameHeight, frameRate);
+}
+
+extern "C" __declspec(dllexport) void StopCapture() {
+	stopSession(defaultSession);
+}
+
+extern "C" __declspec(dllexport) void SetEncodeMode(int encodeMode) {
+	setEncodeMode(defaultSession, encodeMode);
+}
+
+extern "C" __declspec(dllexport) void SetTileSize(int tileSize) {
+	setTileSize(defaultSession, tileSize);
+}
+
+extern "C" __declspec(dllexport) void SetChangeDetection(int changeDetection) {
+	setChangeDetection(defaultSession, changeDetection);
+}
+
+extern "C" __declspec(dllexport) void SetMotionDetection(int enabled) {
+	setMotionDetection(defaultSession, enabled);
+}
+
+extern "C" __declspec(dllexport) void SetChannelLayout(int channelLayout) {
+	setChannelLayout(defaultSession, channelLayout);
+}
+
+extern "C" __declspec(dllexport) void SetPixelFormat(int pixelFormat, int colorMatrix, int fullRange) {
+	setPixelFormat(defaultSession, pixelFormat, colorMatrix, fullRange);
+}
+
+extern "C" __declspec(dllexport) void SetScaleFilter(int scaleFilter) {
+	setScaleFilter(defaultSession, scaleFilter);
+}
+
+extern "C" __declspec(dllexport) void SetCompressionAcceleration(int minAcceleration, int maxAcceleration) {
+	setCompressionAcceleration(defaultSession, minAcceleration, maxAcceleration);
+}
+
+extern "C" __declspec(dllexport) void SetDeliveryWindow(int frames) {
+	setDeliveryWindow(defaultSession, frames);
+}
+
+extern "C" __declspec(dllexport) void SetBackpressurePolicy(int policy) {
+	setBackpressurePolicy(defaultSession, policy);
+}
+
+extern "C" __declspec(dllexport) void GetDeliveryStats(DeliveryStats* stats) {
+	getDeliveryStats(defaultSession, stats);
+}
+
+extern "C" __declspec(dllexport) void GetPacerStats(PacerStats* stats) {
+	getPacerStats(defaultSession, stats);
+}
+
+extern "C" __declspec(dllexport) void SetTargetBitrate(double targetMbps) {
+	setTargetBitrate(defaultSession, targetMbps);
+}
+
+extern "C" __declspec(dllexport) void GetRateStats(RateControlStats* stats) {
+	getRateStats(defaultSession, stats);
+}
+
+// 인코딩 경로 힙 할당 통계 (모든 세션 합계)
+extern "C" __declspec(dllexport) void GetAllocationStats(AllocationStats* stats) {
+	if (stats == nullptr) {
+		return;
+	}
+	getAllocationCounters(stats->allocationCount, stats->allocatedBytes);
+}
@@ -13,8 +13,284 @@ struct FrameData {
     long long timeStamp;
 };
 
+// FrameData.data의 인코딩 방식
+enum EncodeMode {
+    ENCODE_RAW = 0,  // BGRA 원본 (width * height * 4, ChannelLayout이 BGRA가 아니면 width * height * 3)
+    ENCODE_TILE = 1, // TileFrameHeader | 변경 타일 비트맵 | LZ4(변경된 타일 픽셀)
+    ENCODE_XOR_LZ4 = 2, // XorFrameHeader | 블록별 LZ4(현재 ^ 이전 프레임)
+    ENCODE_LZ4_DICT = 3, // XorFrameHeader | 블록별 LZ4(현재 프레임, 이전 프레임 같은 블록을 사전으로)
+};
+// 헤더 flags에 FRAME_FLAG_ZERO_BASE가 있으면 이전 프레임 대신 0 프레임 기준 (해상도 변경, 보내지 못한 프레임 뒤 전체 갱신)
+
+// ENCODE_TILE에서 변경된 타일을 찾는 방식
+enum ChangeDetection {
+    CHANGE_DETECT_COMPARE = 0, // 이전 프레임과 바이트 비교
+    CHANGE_DETECT_HASH = 1,    // 타일 해시 비교 (이전 프레임 버퍼를 유지하지 않음)
+};
+
+// 압축 전 픽셀 채널 배치 (모든 인코딩 모드에 적용)
+// 알파를 뺀 배치는 받는 쪽에서 복원할 때 알파를 0xFF로 채움 (RAW/타일/XOR/사전 모드 모두)
+enum ChannelLayout {
+    CHANNEL_BGRA = 0,   // 원본 그대로
+    CHANNEL_BGR = 1,    // 알파 제거 (픽셀당 3바이트)
+    CHANNEL_PLANAR = 2, // 알파 제거 후 B/G/R 평면으로 분리 (압축 모드는 32 KB 블록 단위, RAW는 프레임 전체)
+};
+
+// 압축 전 픽셀 형식 (ENCODE_RAW / ENCODE_XOR_LZ4 / ENCODE_LZ4_DICT에 적용, 타일 모드는 항상 BGRA)
+// YUV는 Y 평면(width * height) 뒤에 크로마 평면((width + 1) / 2 * (height + 1) / 2 * 2)이 오며 ChannelLayout은 무시됨
+enum PixelFormat {
+    PIXEL_FORMAT_BGRA = 0,
+    PIXEL_FORMAT_NV12 = 1, // Y | UV 교차
+    PIXEL_FORMAT_I420 = 2, // Y | U | V
+};
+
+enum ColorMatrix {
+    COLOR_MATRIX_BT601 = 0,
+    COLOR_MATRIX_BT709 = 1,
+};
+
+// 데스크톱 해상도와 StartCapture의 frameWidth/frameHeight가 다를 때 쓰는 리샘플링 필터
+enum ScaleFilter {
+    SCALE_FILTER_AUTO = 0,     // 정확히 2:1/4:1이면 BOX, 축소는 AREA, 확대는 BILINEAR
+    SCALE_FILTER_BOX = 1,      // 2x2 / 4x4 평균 (정수 배율이 아니면 AREA)
+    SCALE_FILTER_BILINEAR = 2,
+    SCALE_FILTER_AREA = 3,     // 원본 픽셀 겹침 면적 가중 평균
+};
+
+// 전달 창(SetDeliveryWindow)이 가득 찼을 때 새 프레임 처리 방식
+// 버리거나 합친 프레임의 변경분은 다음에 보내는 프레임의 delta에 그대로 포함됨
+enum BackpressurePolicy {
+    BACKPRESSURE_BLOCK = 0,       // 가장 오래된 프레임이 전달될 때까지 캡처 대기
+    BACKPRESSURE_DROP_OLDEST = 1, // 아직 전달되지 않은 가장 오래된 프레임을 버림 (ENCODE_RAW 전용, 다른 모드는 COALESCE로 동작)
+    BACKPRESSURE_DROP_NEWEST = 2, // 새 프레임을 보내지 않음. 화면이 멈추면 다음 프레임 시각에 최신 화면을 보냄
+    BACKPRESSURE_COALESCE = 3,    // 새 프레임을 최신 것 하나로 합쳐 들고 있다가 창이 비면 바로 보냄 (기본값)
+};
+
+// 인코딩 경로의 힙 할당 누적 통계 (프레임 간 차이가 0이면 정상 상태에서 할당 없음)
+struct AllocationStats {
+    long long allocationCount;
+    long long allocatedBytes;
+};
+
+// 프레임 전달 단계 누적 통계. 콜백은 캡처 순서대로 한 쓰레드에서만 호출됨
+struct DeliveryStats {
+    long long deliveredFrames;
+    long long reorderedFrames; // 앞 프레임보다 먼저 인코딩이 끝나 순서를 기다린 프레임
+    double averageWaitMs;      // 인코딩 완료부터 콜백 시작까지
+    double maxWaitMs;
+    long long windowStalls;    // 전달 창이 가득 차 캡처가 멈춘 횟수
+    double totalStallMs;
+    long long droppedFrames;   // BACKPRESSURE_DROP_OLDEST / DROP_NEWEST로 보내지 않은 프레임
+    long long coalescedFrames; // BACKPRESSURE_COALESCE로 다음 프레임에 합쳐진 프레임
+    long long failedDeliveries; // 콜백/출력 중 예외로 잃은 프레임
+};
+
+// 프레임 시각 통계. 지각 = 프레임을 시작한 시각 - 목표 시각
+struct PacerStats {
+    long long frames;
+    long long missedDeadlines;      // 한 프레임 이상 늦어 건너뛴 목표 시각
+    double averageLatenessMs;
+    double maxLatenessMs;
+    long long latenessHistogram[8]; // 상한 50us, 100us, 250us, 500us, 1ms, 2ms, 5ms, 그 이상
+};
+
+// 전송률 제어 상태 (SetTargetBitrate)
+struct RateControlStats {
+    double targetMbps;
+    double estimatedMbps;       // UDP 수신 보고로 추정한 링크 속도 (0이면 모름)
+    double budgetMbps;          // 목표와 추정치 중 작은 값 (0이면 제어 안 함)
+    double measuredMbps;        // 최근 출력 비트레이트 (평활)
+    double bufferDelayMs;       // 예산 속도로 보낼 때 밀려 있는 양 (링크 큐 지연 추정)
+    int frameRate;              // 지금 캡처하는 fps
+    int scaleDivisor;           // 지금 출력 해상도 = 세션 해상도 / scaleDivisor
+    double compressBudgetRatio; // 압축에 쓰는 프레임 시간 비율 (1 미만이면 acceleration을 올려 지연 우선)
+    long long levelChanges;
+    long long scaleChanges;     // 출력 해상도가 바뀐 횟수
+};
+
+// UDP 출력 누적 통계
+struct UdpSenderStats {
+    long long framesSent;
+    long long packetsSent;
+    long long bytesSent;
+    long long sendErrors;      // 보내지 못한 패킷 (sendto 오류, 다음 프레임 시각까지 소켓 버퍼가 비지 않음)
+    long long oversizedFrames; // 패킷 65535개를 넘어 보내지 못한 프레임
+    double averageSendMs;      // 프레임 하나의 첫 패킷부터 마지막 패킷까지 (페이싱 포함)
+    double maxSendMs;
+    long long parityPacketsSent;
+    int fecGroupSize;          // 지금 쓰는 패리티 그룹 크기 (0이면 FEC 없음)
+    double reportedLossRate;   // 받는 쪽이 보고한 손실률 (평활)
+    double fecEncodeUsPerMbit; // 보낸 데이터 1Mbit당 패리티 계산 CPU 시간
+    double estimatedMbps;      // 수신 보고로 추정한 링크 속도 (0이면 혼잡을 본 적 없음)
+    double queueDelayMs;       // 수신 보고로 추정한 링크 큐 지연 (전송 시간이 최소보다 늘어난 만큼)
+    long long sendBlocked;     // 소켓 버퍼가 가득 차 기다렸다 다시 보낸 횟수
+    long long keyframeRequests; // 받는 쪽이 프레임을 놓쳤거나 새로 붙어 전체 갱신(FRAME_FLAG_ZERO_BASE)을 요청한 횟수
+};
+
+// UDP 받는 쪽 누적 통계
+struct UdpReceiverStats {
+    long long packetsReceived;
+    long long packetsLost;      // 패킷 순번이 건너뛴 수 (늦게 도착하면 다시 뺌)
+    long long packetsReordered;
+    long long invalidPackets;
+    long long framesReceived;
+    long long framesDropped;    // 패킷이 빠져 다 모이지 못하고 건너뛴 프레임
+    long long bytesReceived;
+    double averageLatencyMs;    // 첫 패킷을 보낸 시각부터 프레임 완성까지 (두 컴퓨터의 시계가 맞을 때만 의미 있음)
+    double maxLatencyMs;
+    long long parityPacketsReceived;
+    long long packetsRecovered; // 패리티로 복구한 데이터 패킷
+    double recoveryRate;        // packetsRecovered / packetsLost (잃은 패리티도 분모에 들어감)
+    double fecDecodeUsPerMbit;  // 받은 데이터 1Mbit당 복구 CPU 시간
+    long long simulatedDrops;   // 링크 에뮬레이터가 버린 패킷 (packetsLost에도 포함)
+};
+
+// 받는 쪽 링크 에뮬레이터 설정 (시험용). 0인 항목은 끔
+// 토큰 버킷 + 병목 큐 -> Gilbert-Elliott 손실 -> 기본 지연 + 지터 -> 순서 바꿈 순서로 적용
+struct LinkEmulationSettings {
+    double bandwidthMbps;  // 토큰 버킷 속도 (0이면 제한 없음)
+    int burstBytes;        // 토큰 버킷 깊이 (쉬던 링크가 한 번에 내보낼 수 있는 양)
+    int queueBytes;        // 병목 큐 크기. 넘치면 새 패킷을 버림 (0이면 무제한)
+    double delayMs;        // 기본 단방향 지연
+    double jitterMs;       // 추가 지연 평균 (지수 분포). 패킷 순서는 유지
+    double reorderRate;    // 이 확률로 reorderDelayMs만큼 더 늦춰 뒤 패킷에 추월당하게 함
+    double reorderDelayMs;
+    double goodToBadRate;  // 패킷마다 좋음 -> 나쁨 상태로 바뀔 확률
+    double badToGoodRate;  // 나쁨 -> 좋음 (나쁨 상태 평균 길이 = 1 / badToGoodRate 패킷)
+    double goodLossRate;   // 상태별 손실 확률
+    double badLossRate;
+};
+
+// GetLinkEmulationPreset 시나리오
+enum LinkEmulationPreset {
+    LINK_PRESET_HOME_WIFI = 1,  // 120Mbps, 지연 2ms + 지터 3ms, 큐 약 25ms, 평균 손실 약 0.3% (짧은 뭉치)
+    LINK_PRESET_USB_TETHER = 2, // LTE 테더링 30Mbps, 지연 25ms + 지터 6ms, 큐 약 200ms, 평균 손실 약 0.5% (긴 뭉치)
+};
+
+// 링크 에뮬레이터 누적 통계
+struct LinkEmulatorStats {
+    long long packetsIn;
+    long long packetsDelivered;
+    long long queueDrops;       // 병목 큐가 넘쳐 버린 패킷
+    long long lossDrops;        // 확률 손실로 버린 패킷
+    long long burstLosses;      // lossDrops 중 나쁨 상태에서 잃은 패킷
+    long long reorderedPackets;
+    double averageDelayMs;      // 받은 시각부터 넘긴 시각까지 (큐 + 지연)
+    double maxDelayMs;
+    long long maxQueueBytes;
+};
+
+// 캡처 세션 핸들. 세션마다 모니터/해상도/인코딩 설정/파이프라인이 따로 있고 쓰레드 풀만 공유
+typedef struct CaptureSession* CaptureSessionHandle;
+// 공유 메모리 프레임 링을 읽는 쪽 핸들 (메모리 배치는 SharedFrameRing.h)
+typedef struct SharedFrameReader* SharedFrameReaderHandle;
+// UDP 받는 쪽 핸들
+typedef struct UdpFrameReceiver* UdpReceiverHandle;
+
 extern "C" {
     CAPTUREDLL_API const char* TestDLL();
     CAPTUREDLL_API void StartCapture(void (*frameCallback)(FrameData frameData), int frameWidth, int frameHeight, int frameRate);
     CAPTUREDLL_API void StopCapture();
+
+    // 인코딩 설정 (StartCapture 전에 호출)
+    CAPTUREDLL_API void SetEncodeMode(int encodeMode);
+    CAPTUREDLL_API void SetTileSize(int tileSize);
+    CAPTUREDLL_API void SetChangeDetection(int changeDetection);
+    // 켜면 RAW 이외 모드의 페이로드 앞에 uint32 copyRectCount | CopyRect[] 가 붙음
+    CAPTUREDLL_API void SetMotionDetection(int enabled);
+    CAPTUREDLL_API void SetChannelLayout(int channelLayout);
+    // fullRange: 0이면 제한 범위 (Y 16~235, UV 16~240)
+    CAPTUREDLL_API void SetPixelFormat(int pixelFormat, int colorMatrix, int fullRange);
+    CAPTUREDLL_API void SetScaleFilter(int scaleFilter);
+    // LZ4 acceleration 자동 조정 범위 (기본 1~10000, min == max 이면 고정)
+    CAPTUREDLL_API void SetCompressionAcceleration(int minAcceleration, int maxAcceleration);
+
+    // 인코딩 중이거나 전달을 기다릴 수 있는 프레임 수 (기본 4). 가득 차면 캡처가 앞 프레임 전달을 기다림
+    CAPTUREDLL_API void SetDeliveryWindow(int frames);
+    CAPTUREDLL_API void SetBackpressurePolicy(int policy);
+
+    // 인코딩 경로 힙 할당 누적 통계 (모든 세션 합계)
+    CAPTUREDLL_API void GetAllocationStats(AllocationStats* stats);
+    // 전달 창 대기/재정렬/버린 프레임 통계
+    CAPTUREDLL_API void GetDeliveryStats(DeliveryStats* stats);
+    // 프레임 시작 시각의 지각 통계
+    CAPTUREDLL_API void GetPacerStats(PacerStats* stats);
+
+    // 전송률 제어 (캡처 중에도 바꿀 수 있음). 0: 끔 (기본값), 양수: 목표 Mbps, 음수: UDP 수신 보고로 추정한 링크 속도만 따름
+    // 켜면 프레임마다 예산 안에서 fps(1/2~1/4), 출력 해상도(1/2, 1/4), 압축 예산을 고름
+    // 출력 해상도가 바뀐 프레임은 FrameData의 width/height가 바뀌고 delta 모드에서는 0 프레임 기준 (받는 쪽도 이전 프레임을 0으로)
+    CAPTUREDLL_API void SetTargetBitrate(double targetMbps);
+    CAPTUREDLL_API void GetRateStats(RateControlStats* stats);
+
+    // 세션 API. 위의 StartCapture/StopCapture/Set*/Get*Stats는 기본 세션 하나에 대한 같은 함수
+    CAPTUREDLL_API CaptureSessionHandle CreateSession();
+    // 성공하면 1. frameCallback이 없으면 풀 방식으로 AcquireEncodedFrame에서 꺼냄
+    // frameRate, frameWidth, frameHeight가 0 이하이면 시작하지 않음 (0)
+    CAPTUREDLL_API int StartSession(CaptureSessionHandle session, void (*frameCallback)(FrameData frameData), int frameWidth, int frameHeight, int frameRate);
+    // frameCallback 안에서도 부를 수 있음. 이때는 아직 전달하지 않은 프레임을 버리고 바로 반환
+    // (같은 콜백 안에서 다시 StartSession하면 실패하고, DestroySession은 멈추기만 함)
+    CAPTUREDLL_API void StopSession(CaptureSessionHandle session);
+    // 캡처 중이면 멈춘 뒤 해제
+    CAPTUREDLL_API void DestroySession(CaptureSessionHandle session);
+
+    // 풀 방식: 호스트 쓰레드 하나에서 캡처 순서대로 꺼냄 (복사 없이 내부 버퍼를 가리킴)
+    // timeoutMs < 0이면 무한 대기, 0이면 기다리지 않음. 시간이 지났거나 멈춘 세션에 남은 프레임이 없으면 NULL
+    // 꺼낸 순서대로 ReleaseEncodedFrame해야 하며, 반납 전에는 버퍼가 재사용되지 않음
+    // 꺼내 가지 않으면 링(8 프레임)과 전달 창이 차서 BackpressurePolicy에 따라 캡처가 밀림
+    CAPTUREDLL_API const FrameData* AcquireEncodedFrame(CaptureSessionHandle session, int timeoutMs);
+    CAPTUREDLL_API void ReleaseEncodedFrame(CaptureSessionHandle session, const FrameData* frame);
+
+    // 공유 메모리 출력: 이름 있는 링(칸 slotCount개, 프레임당 최대 maxFrameBytes, 0이면 압축 최악 크기)으로 프레임을 보냄
+    // 설정하면 frameCallback/풀 방식 대신 사용. name이 NULL이거나 비어 있으면 끔
+    // 읽는 쪽이 반납하지 않아 링이 차면 전달 창을 통해 캡처가 밀림. 칸보다 큰 프레임은 버림
+    CAPTUREDLL_API void SetSessionSharedMemoryOutput(CaptureSessionHandle session, const char* name, int slotCount, int maxFrameBytes);
+    // 읽는 쪽 (다른 프로세스): data는 공유 메모리를 그대로 가리키며 ReleaseSharedFrame 전까지 유효
+    // timeoutMs는 AcquireEncodedFrame과 같음. 캡처가 멈추고 남은 프레임이 없으면 NULL
+    CAPTUREDLL_API SharedFrameReaderHandle OpenSharedFrameReader(const char* name);
+    CAPTUREDLL_API const FrameData* AcquireSharedFrame(SharedFrameReaderHandle reader, int timeoutMs);
+    CAPTUREDLL_API void ReleaseSharedFrame(SharedFrameReaderHandle reader);
+    CAPTUREDLL_API void CloseSharedFrameReader(SharedFrameReaderHandle reader);
+
+    // UDP 출력: 프레임을 packetSize(헤더 포함, 0이면 1200) 바이트 패킷으로 나눠 host:port(IPv4)로 보냄
+    // 한 프레임의 패킷은 프레임 간격의 80% 동안 고르게 나눠 보냄. 설정하면 frameCallback/풀 방식 대신 사용 (공유 메모리가 우선)
+    // host가 NULL이거나 비어 있으면 끔. 패킷 형식은 FramePacket.h
+    CAPTUREDLL_API void SetSessionUdpOutput(CaptureSessionHandle session, const char* host, int port, int packetSize);
+    CAPTUREDLL_API void GetSessionUdpStats(CaptureSessionHandle session, UdpSenderStats* stats);
+    // 패리티 FEC: 데이터 패킷 groupSize개마다 XOR 패리티 하나 (그룹당 한 패킷 손실 복구)
+    // -1: 받는 쪽 손실 보고에 맞춰 자동 (기본값, 손실이 0.1% 미만이면 끔), 0: 끔, 2~255: 고정
+    CAPTUREDLL_API void SetSessionUdpFec(CaptureSessionHandle session, int groupSize);
+    // 받는 쪽: port에서 패킷을 모아 완성된 프레임을 받는 쓰레드에서 캡처 순서대로 콜백 (data는 콜백 안에서만 유효)
+    // 다 모이지 못한 프레임은 건너뛰고 수신 보고로 바로 알림. 보내는 쪽은 다음 프레임을 0 프레임 기준 전체 갱신으로 보냄
+    // (delta 모드에서 그 사이 도착한 프레임은 기준이 어긋나므로 FRAME_FLAG_ZERO_BASE 프레임부터 다시 맞음)
+    CAPTUREDLL_API UdpReceiverHandle CreateUdpReceiver(int port, void (*frameCallback)(FrameData frameData));
+    // frameCallback 안에서 부르면 받기만 멈추고 해제하지 않음 (콜백 밖에서 다시 불러야 해제됨)
+    CAPTUREDLL_API void DestroyUdpReceiver(UdpReceiverHandle receiver);
+    CAPTUREDLL_API void GetUdpReceiverStats(UdpReceiverHandle receiver, UdpReceiverStats* stats);
+    // 시험용: 받은 패킷을 모으기 전에 링크 에뮬레이터에 통과시킴 (settings가 NULL이면 끔)
+    // 손실만 흉내내려면 goodLossRate만 채움 (독립 손실). 뭉치 손실은 goodToBadRate/badToGoodRate/badLossRate, 실제 링크 비슷한 값은 GetLinkEmulationPreset
+    // 패킷마다 난수를 같은 개수만큼 뽑으므로 seed가 같으면 같은 패킷이 같은 손실/지연/순서 결과를 받음
+    // 수신 보고도 에뮬레이터를 거친 손실을 보내므로 보내는 쪽 FEC가 그에 맞춰 바뀜
+    CAPTUREDLL_API void SetUdpReceiverLinkEmulation(UdpReceiverHandle receiver, const LinkEmulationSettings* settings, int seed);
+    CAPTUREDLL_API void GetUdpReceiverLinkStats(UdpReceiverHandle receiver, LinkEmulatorStats* stats);
+    // preset(LinkEmulationPreset)의 설정을 채움. 모르는 값이면 0
+    CAPTUREDLL_API int GetLinkEmulationPreset(int preset, LinkEmulationSettings* settings);
+
+    // 세션 설정 (StartSession 전에 호출)
+    // outputIndex: 어댑터 0의 출력(모니터) 번호 (기본 0)
+    CAPTUREDLL_API void SetSessionOutput(CaptureSessionHandle session, int outputIndex);
+    CAPTUREDLL_API void SetSessionEncodeMode(CaptureSessionHandle session, int encodeMode);
+    CAPTUREDLL_API void SetSessionTileSize(CaptureSessionHandle session, int tileSize);
+    CAPTUREDLL_API void SetSessionChangeDetection(CaptureSessionHandle session, int changeDetection);
+    CAPTUREDLL_API void SetSessionMotionDetection(CaptureSessionHandle session, int enabled);
+    CAPTUREDLL_API void SetSessionChannelLayout(CaptureSessionHandle session, int channelLayout);
+    CAPTUREDLL_API void SetSessionPixelFormat(CaptureSessionHandle session, int pixelFormat, int colorMatrix, int fullRange);
+    CAPTUREDLL_API void SetSessionScaleFilter(CaptureSessionHandle session, int scaleFilter);
+    CAPTUREDLL_API void SetSessionCompressionAcceleration(CaptureSessionHandle session, int minAcceleration, int maxAcceleration);
+    CAPTUREDLL_API void SetSessionDeliveryWindow(CaptureSessionHandle session, int frames);
+    CAPTUREDLL_API void SetSessionBackpressurePolicy(CaptureSessionHandle session, int policy);
+
+    CAPTUREDLL_API void GetSessionDeliveryStats(CaptureSessionHandle session, DeliveryStats* stats);
+    CAPTUREDLL_API void GetSessionPacerStats(CaptureSessionHandle session, PacerStats* stats);
+    CAPTUREDLL_API void SetSessionTargetBitrate(CaptureSessionHandle session, double targetMbps);
+    CAPTUREDLL_API void GetSessionRateStats(CaptureSessionHandle session, RateControlStats* stats);
 }
\ No newline at end of file
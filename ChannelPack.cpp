@@ -0,0 +1,279 @@
+#include "ChannelPack.h"
+#include "CpuFeatures.h"
+
+#include <cstring>
+#include <immintrin.h>
+
+// 16바이트(픽셀 4개)에서 BGR 12바이트를 앞으로 모으고 나머지는 0
+#define STRIP_ALPHA_MASK 0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1
+// BGR 12바이트를 픽셀 4개로 펼치고 알파 자리는 0
+#define RESTORE_ALPHA_MASK 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1
+// 픽셀 4개를 B 4바이트 | G 4바이트 | R 4바이트 | A 4바이트로 모음
+#define SPLIT_PLANES_MASK 0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15
+
+void stripAlphaScalar(const uint8_t* bgra, uint8_t* bgr, size_t pixelCount) {
+	for (size_t i = 0; i < pixelCount; ++i) {
+		bgr[i * 3 + 0] = bgra[i * 4 + 0];
+		bgr[i * 3 + 1] = bgra[i * 4 + 1];
+		bgr[i * 3 + 2] = bgra[i * 4 + 2];
+	}
+}
+
+TARGET_SSSE3
+void stripAlphaSSSE3(const uint8_t* bgra, uint8_t* bgr, size_t pixelCount) {
+	const __m128i mask = _mm_setr_epi8(STRIP_ALPHA_MASK);
+	size_t i = 0;
+
+	// 픽셀 16개(64바이트)를 48바이트로
+	for (; i + 16 <= pixelCount; i += 16) {
+		__m128i p0 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(bgra + i * 4)), mask);
+		__m128i p1 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(bgra + i * 4 + 16)), mask);
+		__m128i p2 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(bgra + i * 4 + 32)), mask);
+		__m128i p3 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(bgra + i * 4 + 48)), mask);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(bgr + i * 3), _mm_or_si128(p0, _mm_slli_si128(p1, 12)));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(bgr + i * 3 + 16), _mm_or_si128(_mm_srli_si128(p1, 4), _mm_slli_si128(p2, 8)));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(bgr + i * 3 + 32), _mm_or_si128(_mm_srli_si128(p2, 8), _mm_slli_si128(p3, 4)));
+	}
+
+	stripAlphaScalar(bgra + i * 4, bgr + i * 3, pixelCount - i);
+}
+
+TARGET_AVX2
+void stripAlphaAVX2(const uint8_t* bgra, uint8_t* bgr, size_t pixelCount) {
+	const __m256i mask = _mm256_setr_epi8(STRIP_ALPHA_MASK, STRIP_ALPHA_MASK);
+	// 레인마다 앞 12바이트에 모인 결과를 하위 24바이트로 붙임
+	const __m256i compact = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7);
+	size_t i = 0;
+
+	// 픽셀 8개씩 32바이트로 저장하고 다음 저장이 뒤 8바이트를 덮어씀 (끝을 넘지 않는 동안만)
+	for (; i + 11 <= pixelCount; i += 8) {
+		__m256i p = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bgra + i * 4));
+		p = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(p, mask), compact);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(bgr + i * 3), p);
+	}
+	_mm256_zeroupper();
+
+	stripAlphaScalar(bgra + i * 4, bgr + i * 3, pixelCount - i);
+}
+
+void restoreAlphaScalar(const uint8_t* bgr, uint8_t* bgra, size_t pixelCount, uint8_t alpha) {
+	for (size_t i = 0; i < pixelCount; ++i) {
+		bgra[i * 4 + 0] = bgr[i * 3 + 0];
+		bgra[i * 4 + 1] = bgr[i * 3 + 1];
+		bgra[i * 4 + 2] = bgr[i * 3 + 2];
+		bgra[i * 4 + 3] = alpha;
+	}
+}
+
+TARGET_SSSE3
+void restoreAlphaSSSE3(const uint8_t* bgr, uint8_t* bgra, size_t pixelCount, uint8_t alpha) {
+	const __m128i mask = _mm_setr_epi8(RESTORE_ALPHA_MASK);
+	const __m128i alphaBits = _mm_set1_epi32(static_cast<int>(static_cast<uint32_t>(alpha) << 24));
+	size_t i = 0;
+
+	for (; i + 16 <= pixelCount; i += 16) {
+		__m128i in0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bgr + i * 3));
+		__m128i in1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bgr + i * 3 + 16));
+		__m128i in2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bgr + i * 3 + 32));
+		__m128i p0 = _mm_shuffle_epi8(in0, mask);
+		__m128i p1 = _mm_shuffle_epi8(_mm_alignr_epi8(in1, in0, 12), mask);
+		__m128i p2 = _mm_shuffle_epi8(_mm_alignr_epi8(in2, in1, 8), mask);
+		__m128i p3 = _mm_shuffle_epi8(_mm_srli_si128(in2, 4), mask);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(bgra + i * 4), _mm_or_si128(p0, alphaBits));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(bgra + i * 4 + 16), _mm_or_si128(p1, alphaBits));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(bgra + i * 4 + 32), _mm_or_si128(p2, alphaBits));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(bgra + i * 4 + 48), _mm_or_si128(p3, alphaBits));
+	}
+
+	restoreAlphaScalar(bgr + i * 3, bgra + i * 4, pixelCount - i, alpha);
+}
+
+TARGET_AVX2
+void restoreAlphaAVX2(const uint8_t* bgr, uint8_t* bgra, size_t pixelCount, uint8_t alpha) {
+	const __m256i mask = _mm256_setr_epi8(RESTORE_ALPHA_MASK, RESTORE_ALPHA_MASK);
+	// 하위 24바이트를 레인마다 12바이트씩 나눔
+	const __m256i spread = _mm256_setr_epi32(0, 1, 2, 0, 3, 4, 5, 0);
+	const __m256i alphaBits = _mm256_set1_epi32(static_cast<int>(static_cast<uint32_t>(alpha) << 24));
+	size_t i = 0;
+
+	// 32바이트를 읽어 24바이트만 쓰므로 읽기가 끝을 넘지 않는 동안만
+	for (; i + 11 <= pixelCount; i += 8) {
+		__m256i p = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bgr + i * 3));
+		p = _mm256_shuffle_epi8(_mm256_permutevar8x32_epi32(p, spread), mask);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(bgra + i * 4), _mm256_or_si256(p, alphaBits));
+	}
+	_mm256_zeroupper();
+
+	restoreAlphaScalar(bgr + i * 3, bgra + i * 4, pixelCount - i, alpha);
+}
+
+void splitPlanesScalar(const uint8_t* bgra, uint8_t* b, uint8_t* g, uint8_t* r, size_t pixelCount) {
+	for (size_t i = 0; i < pixelCount; ++i) {
+		b[i] = bgra[i * 4 + 0];
+		g[i] = bgra[i * 4 + 1];
+		r[i] = bgra[i * 4 + 2];
+	}
+}
+
+TARGET_SSSE3
+void splitPlanesSSSE3(const uint8_t* bgra, uint8_t* b, uint8_t* g, uint8_t* r, size_t pixelCount) {
+	const __m128i mask = _mm_setr_epi8(SPLIT_PLANES_MASK);
+	size_t i = 0;
+
+	for (; i + 16 <= pixelCount; i += 16) {
+		// 벡터마다 dword 0..3 = 픽셀 4개의 B, G, R, A
+		__m128i p0 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(bgra + i * 4)), mask);
+		__m128i p1 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(bgra + i * 4 + 16)), mask);
+		__m128i p2 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(bgra + i * 4 + 32)), mask);
+		__m128i p3 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(bgra + i * 4 + 48)), mask);
+
+		// 4x4 dword 전치
+		__m128i bg01 = _mm_unpacklo_epi32(p0, p1);
+		__m128i bg23 = _mm_unpacklo_epi32(p2, p3);
+		__m128i ra01 = _mm_unpackhi_epi32(p0, p1);
+		__m128i ra23 = _mm_unpackhi_epi32(p2, p3);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(b + i), _mm_unpacklo_epi64(bg01, bg23));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(g + i), _mm_unpackhi_epi64(bg01, bg23));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(r + i), _mm_unpacklo_epi64(ra01, ra23));
+	}
+
+	splitPlanesScalar(bgra + i * 4, b + i, g + i, r + i, pixelCount - i);
+}
+
+TARGET_AVX2
+void splitPlanesAVX2(const uint8_t* bgra, uint8_t* b, uint8_t* g, uint8_t* r, size_t pixelCount) {
+	const __m256i mask = _mm256_setr_epi8(SPLIT_PLANES_MASK, SPLIT_PLANES_MASK);
+	// 레인 단위 전치 결과는 (0-3, 8-11, 16-19, 24-27 | 4-7, ...) 순서이므로 dword를 다시 정렬
+	const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+	size_t i = 0;
+
+	for (; i + 32 <= pixelCount; i += 32) {
+		__m256i p0 = _mm256_shuffle_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(bgra + i * 4)), mask);
+		__m256i p1 = _mm256_shuffle_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(bgra + i * 4 + 32)), mask);
+		__m256i p2 = _mm256_shuffle_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(bgra + i * 4 + 64)), mask);
+		__m256i p3 = _mm256_shuffle_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(bgra + i * 4 + 96)), mask);
+
+		__m256i bg01 = _mm256_unpacklo_epi32(p0, p1);
+		__m256i bg23 = _mm256_unpacklo_epi32(p2, p3);
+		__m256i ra01 = _mm256_unpackhi_epi32(p0, p1);
+		__m256i ra23 = _mm256_unpackhi_epi32(p2, p3);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(b + i), _mm256_permutevar8x32_epi32(_mm256_unpacklo_epi64(bg01, bg23), order));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(g + i), _mm256_permutevar8x32_epi32(_mm256_unpackhi_epi64(bg01, bg23), order));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(r + i), _mm256_permutevar8x32_epi32(_mm256_unpacklo_epi64(ra01, ra23), order));
+	}
+	_mm256_zeroupper();
+
+	splitPlanesScalar(bgra + i * 4, b + i, g + i, r + i, pixelCount - i);
+}
+
+void mergePlanesScalar(const uint8_t* b, const uint8_t* g, const uint8_t* r, uint8_t* bgra, size_t pixelCount, uint8_t alpha) {
+	for (size_t i = 0; i < pixelCount; ++i) {
+		bgra[i * 4 + 0] = b[i];
+		bgra[i * 4 + 1] = g[i];
+		bgra[i * 4 + 2] = r[i];
+		bgra[i * 4 + 3] = alpha;
+	}
+}
+
+void mergePlanesSSE2(const uint8_t* b, const uint8_t* g, const uint8_t* r, uint8_t* bgra, size_t pixelCount, uint8_t alpha) {
+	const __m128i a = _mm_set1_epi8(static_cast<char>(alpha));
+	size_t i = 0;
+
+	for (; i + 16 <= pixelCount; i += 16) {
+		__m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+		__m128i vg = _mm_loadu_si128(reinterpret_cast<const __m128i*>(g + i));
+		__m128i vr = _mm_loadu_si128(reinterpret_cast<const __m128i*>(r + i));
+		__m128i bgLo = _mm_unpacklo_epi8(vb, vg);
+		__m128i bgHi = _mm_unpackhi_epi8(vb, vg);
+		__m128i raLo = _mm_unpacklo_epi8(vr, a);
+		__m128i raHi = _mm_unpackhi_epi8(vr, a);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(bgra + i * 4), _mm_unpacklo_epi16(bgLo, raLo));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(bgra + i * 4 + 16), _mm_unpackhi_epi16(bgLo, raLo));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(bgra + i * 4 + 32), _mm_unpacklo_epi16(bgHi, raHi));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(bgra + i * 4 + 48), _mm_unpackhi_epi16(bgHi, raHi));
+	}
+
+	mergePlanesScalar(b + i, g + i, r + i, bgra + i * 4, pixelCount - i, alpha);
+}
+
+TARGET_AVX2
+void mergePlanesAVX2(const uint8_t* b, const uint8_t* g, const uint8_t* r, uint8_t* bgra, size_t pixelCount, uint8_t alpha) {
+	const __m256i a = _mm256_set1_epi8(static_cast<char>(alpha));
+	size_t i = 0;
+
+	for (; i + 32 <= pixelCount; i += 32) {
+		__m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+		__m256i vg = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(g + i));
+		__m256i vr = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(r + i));
+		__m256i bgLo = _mm256_unpacklo_epi8(vb, vg);
+		__m256i bgHi = _mm256_unpackhi_epi8(vb, vg);
+		__m256i raLo = _mm256_unpacklo_epi8(vr, a);
+		__m256i raHi = _mm256_unpackhi_epi8(vr, a);
+
+		// 레인 안에서 펼친 결과: q0 = (0-3 | 16-19), q1 = (4-7 | 20-23), q2 = (8-11 | 24-27), q3 = (12-15 | 28-31)
+		__m256i q0 = _mm256_unpacklo_epi16(bgLo, raLo);
+		__m256i q1 = _mm256_unpackhi_epi16(bgLo, raLo);
+		__m256i q2 = _mm256_unpacklo_epi16(bgHi, raHi);
+		__m256i q3 = _mm256_unpackhi_epi16(bgHi, raHi);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(bgra + i * 4), _mm256_permute2x128_si256(q0, q1, 0x20));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(bgra + i * 4 + 32), _mm256_permute2x128_si256(q2, q3, 0x20));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(bgra + i * 4 + 64), _mm256_permute2x128_si256(q0, q1, 0x31));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(bgra + i * 4 + 96), _mm256_permute2x128_si256(q2, q3, 0x31));
+	}
+	_mm256_zeroupper();
+
+	mergePlanesScalar(b + i, g + i, r + i, bgra + i * 4, pixelCount - i, alpha);
+}
+
+// 시작 시 CPUID로 한 번 고른 커널
+struct ChannelKernels {
+	void (*stripAlpha)(const uint8_t*, uint8_t*, size_t);
+	void (*restoreAlpha)(const uint8_t*, uint8_t*, size_t, uint8_t);
+	void (*splitPlanes)(const uint8_t*, uint8_t*, uint8_t*, uint8_t*, size_t);
+	void (*mergePlanes)(const uint8_t*, const uint8_t*, const uint8_t*, uint8_t*, size_t, uint8_t);
+};
+
+static ChannelKernels selectChannelKernels() {
+	const CpuFeatures& features = getCpuFeatures();
+	if (features.avx2) {
+		return { stripAlphaAVX2, restoreAlphaAVX2, splitPlanesAVX2, mergePlanesAVX2 };
+	}
+	if (features.ssse3) {
+		return { stripAlphaSSSE3, restoreAlphaSSSE3, splitPlanesSSSE3, mergePlanesSSE2 };
+	}
+	return { stripAlphaScalar, restoreAlphaScalar, splitPlanesScalar, mergePlanesSSE2 };
+}
+
+static const ChannelKernels channelKernels = selectChannelKernels();
+
+size_t packedChannelSize(size_t pixelCount, int channelLayout) {
+	return channelLayout == CHANNEL_BGRA ? pixelCount * 4 : pixelCount * 3;
+}
+
+void packChannels(const uint8_t* bgra, uint8_t* packed, size_t pixelCount, int channelLayout) {
+	switch (channelLayout) {
+	case CHANNEL_BGR:
+		channelKernels.stripAlpha(bgra, packed, pixelCount);
+		break;
+	case CHANNEL_PLANAR:
+		channelKernels.splitPlanes(bgra, packed, packed + pixelCount, packed + pixelCount * 2, pixelCount);
+		break;
+	default:
+		memcpy(packed, bgra, pixelCount * 4);
+		break;
+	}
+}
+
+void unpackChannels(const uint8_t* packed, uint8_t* bgra, size_t pixelCount, int channelLayout, uint8_t alpha) {
+	switch (channelLayout) {
+	case CHANNEL_BGR:
+		channelKernels.restoreAlpha(packed, bgra, pixelCount, alpha);
+		break;
+	case CHANNEL_PLANAR:
+		channelKernels.mergePlanes(packed, packed + pixelCount, packed + pixelCount * 2, bgra, pixelCount, alpha);
+		break;
+	default:
+		memcpy(bgra, packed, pixelCount * 4);
+		break;
+	}
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#include "CaptureDLL.h"
+
+// BGRA 픽셀의 채널 배치 변환 (ChannelLayout)
+// 데스크톱 캡처의 알파는 항상 같은 값이라 버리고, 평면 분리는 같은 채널끼리 붙어 LZ4 일치가 길어짐
+
+// 개별 커널 (Scalar는 정확성 비교용 기준 구현)
+void stripAlphaScalar(const uint8_t* bgra, uint8_t* bgr, size_t pixelCount);
+void stripAlphaSSSE3(const uint8_t* bgra, uint8_t* bgr, size_t pixelCount);
+void stripAlphaAVX2(const uint8_t* bgra, uint8_t* bgr, size_t pixelCount);
+
+void restoreAlphaScalar(const uint8_t* bgr, uint8_t* bgra, size_t pixelCount, uint8_t alpha);
+void restoreAlphaSSSE3(const uint8_t* bgr, uint8_t* bgra, size_t pixelCount, uint8_t alpha);
+void restoreAlphaAVX2(const uint8_t* bgr, uint8_t* bgra, size_t pixelCount, uint8_t alpha);
+
+void splitPlanesScalar(const uint8_t* bgra, uint8_t* b, uint8_t* g, uint8_t* r, size_t pixelCount);
+void splitPlanesSSSE3(const uint8_t* bgra, uint8_t* b, uint8_t* g, uint8_t* r, size_t pixelCount);
+void splitPlanesAVX2(const uint8_t* bgra, uint8_t* b, uint8_t* g, uint8_t* r, size_t pixelCount);
+
+void mergePlanesScalar(const uint8_t* b, const uint8_t* g, const uint8_t* r, uint8_t* bgra, size_t pixelCount, uint8_t alpha);
+void mergePlanesSSE2(const uint8_t* b, const uint8_t* g, const uint8_t* r, uint8_t* bgra, size_t pixelCount, uint8_t alpha);
+void mergePlanesAVX2(const uint8_t* b, const uint8_t* g, const uint8_t* r, uint8_t* bgra, size_t pixelCount, uint8_t alpha);
+
+// 변환 후 바이트 수
+size_t packedChannelSize(size_t pixelCount, int channelLayout);
+
+// bgra(pixelCount * 4) -> packed(packedChannelSize). CHANNEL_PLANAR는 B 평면 | G 평면 | R 평면
+void packChannels(const uint8_t* bgra, uint8_t* packed, size_t pixelCount, int channelLayout);
+
+// packChannels의 역. 버려진 알파는 alpha로 채움 (복원한 프레임은 0xFF)
+void unpackChannels(const uint8_t* packed, uint8_t* bgra, size_t pixelCount, int channelLayout, uint8_t alpha);
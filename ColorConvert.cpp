@@ -0,0 +1,380 @@
+#include "ColorConvert.h"
+#include "CpuFeatures.h"
+
+#include <algorithm>
+#include <cmath>
+#include <immintrin.h>
+#include <limits>
+
+// 정방향 계수는 2^14, 역방향 계수는 2^13 고정소수점 (제한 범위 B 계수 2.02가 int16에 들어가도록)
+static const int FORWARD_SHIFT = 14;
+static const int INVERSE_SHIFT = 13;
+
+struct ForwardCoefficients {
+	int16_t yB, yG, yR;
+	int16_t uB, uG, uR;
+	int16_t vB, vG, vR;
+	int yOffset;
+};
+
+struct InverseCoefficients {
+	int16_t yScale;
+	int16_t rV, gU, gV, bU;
+	int yOffset;
+};
+
+static int16_t toFixed(double value, int shift) {
+	return static_cast<int16_t>(std::lround(value * (1 << shift)));
+}
+
+static void getLumaWeights(int colorMatrix, double& kr, double& kb) {
+	if (colorMatrix == COLOR_MATRIX_BT709) {
+		kr = 0.2126;
+		kb = 0.0722;
+	}
+	else {
+		kr = 0.299;
+		kb = 0.114;
+	}
+}
+
+static ForwardCoefficients makeForwardCoefficients(int colorMatrix, bool fullRange) {
+	double kr, kb;
+	getLumaWeights(colorMatrix, kr, kb);
+	double kg = 1.0 - kr - kb;
+	double yScale = fullRange ? 1.0 : 219.0 / 255.0;
+	double cScale = fullRange ? 1.0 : 224.0 / 255.0;
+
+	ForwardCoefficients c;
+	c.yB = toFixed(kb * yScale, FORWARD_SHIFT);
+	c.yG = toFixed(kg * yScale, FORWARD_SHIFT);
+	c.yR = toFixed(kr * yScale, FORWARD_SHIFT);
+	c.uB = toFixed(0.5 * cScale, FORWARD_SHIFT);
+	c.uG = toFixed(-0.5 * cScale * kg / (1.0 - kb), FORWARD_SHIFT);
+	c.uR = toFixed(-0.5 * cScale * kr / (1.0 - kb), FORWARD_SHIFT);
+	c.vB = toFixed(-0.5 * cScale * kb / (1.0 - kr), FORWARD_SHIFT);
+	c.vG = toFixed(-0.5 * cScale * kg / (1.0 - kr), FORWARD_SHIFT);
+	c.vR = toFixed(0.5 * cScale, FORWARD_SHIFT);
+	c.yOffset = fullRange ? 0 : 16;
+	return c;
+}
+
+static InverseCoefficients makeInverseCoefficients(int colorMatrix, bool fullRange) {
+	double kr, kb;
+	getLumaWeights(colorMatrix, kr, kb);
+	double kg = 1.0 - kr - kb;
+	double yScale = fullRange ? 1.0 : 255.0 / 219.0;
+	double cScale = fullRange ? 1.0 : 255.0 / 224.0;
+
+	InverseCoefficients c;
+	c.yScale = toFixed(yScale, INVERSE_SHIFT);
+	c.rV = toFixed(2.0 * (1.0 - kr) * cScale, INVERSE_SHIFT);
+	c.gU = toFixed(-2.0 * kb * (1.0 - kb) / kg * cScale, INVERSE_SHIFT);
+	c.gV = toFixed(-2.0 * kr * (1.0 - kr) / kg * cScale, INVERSE_SHIFT);
+	c.bU = toFixed(2.0 * (1.0 - kb) * cScale, INVERSE_SHIFT);
+	c.yOffset = fullRange ? 0 : 16;
+	return c;
+}
+
+static inline uint8_t clampByte(int value) {
+	return static_cast<uint8_t>((std::min)(255, (std::max)(0, value)));
+}
+
+static inline int dot(const uint8_t* pixel, int cb, int cg, int cr) {
+	return pixel[0] * cb + pixel[1] * cg + pixel[2] * cr;
+}
+
+// 한 행 쌍을 변환. yRowB == nullptr 이면 마지막 홀수 행 (rowB == rowA)
+// uvStep: NV12는 2 (vRow = uRow + 1), I420은 1
+static void bgraToYuvRowPairScalar(const uint8_t* rowA, const uint8_t* rowB, uint8_t* yRowA, uint8_t* yRowB, uint8_t* uRow, uint8_t* vRow, int uvStep, int x0, int width, const ForwardCoefficients& c) {
+	const int yBias = (c.yOffset << FORWARD_SHIFT) + (1 << (FORWARD_SHIFT - 1));
+	const int cBias = (128 << (FORWARD_SHIFT + 2)) + (1 << (FORWARD_SHIFT + 1));
+
+	for (int x = x0; x < width; x += 2) {
+		int x1 = (std::min)(x + 1, width - 1);
+		const uint8_t* a0 = rowA + x * 4;
+		const uint8_t* a1 = rowA + x1 * 4;
+		const uint8_t* b0 = rowB + x * 4;
+		const uint8_t* b1 = rowB + x1 * 4;
+
+		yRowA[x] = clampByte((dot(a0, c.yB, c.yG, c.yR) + yBias) >> FORWARD_SHIFT);
+		if (x + 1 < width) {
+			yRowA[x + 1] = clampByte((dot(a1, c.yB, c.yG, c.yR) + yBias) >> FORWARD_SHIFT);
+		}
+		if (yRowB) {
+			yRowB[x] = clampByte((dot(b0, c.yB, c.yG, c.yR) + yBias) >> FORWARD_SHIFT);
+			if (x + 1 < width) {
+				yRowB[x + 1] = clampByte((dot(b1, c.yB, c.yG, c.yR) + yBias) >> FORWARD_SHIFT);
+			}
+		}
+
+		// 2x2 픽셀 합에 계수를 곱한 것 = 평균의 4배
+		int u = dot(a0, c.uB, c.uG, c.uR) + dot(a1, c.uB, c.uG, c.uR) + dot(b0, c.uB, c.uG, c.uR) + dot(b1, c.uB, c.uG, c.uR);
+		int v = dot(a0, c.vB, c.vG, c.vR) + dot(a1, c.vB, c.vG, c.vR) + dot(b0, c.vB, c.vG, c.vR) + dot(b1, c.vB, c.vG, c.vR);
+		uRow[(x / 2) * uvStep] = clampByte((u + cBias) >> (FORWARD_SHIFT + 2));
+		vRow[(x / 2) * uvStep] = clampByte((v + cBias) >> (FORWARD_SHIFT + 2));
+	}
+}
+
+// 픽셀 8개의 (B, G, R) . coefficient를 픽셀 순서대로 int32 8개로
+TARGET_AVX2
+static inline __m256i dotPixels(__m256i pixels, __m256i coefficient) {
+	const __m256i zero = _mm256_setzero_si256();
+	__m256i lo = _mm256_madd_epi16(_mm256_unpacklo_epi8(pixels, zero), coefficient); // (0, 1 | 4, 5)
+	__m256i hi = _mm256_madd_epi16(_mm256_unpackhi_epi8(pixels, zero), coefficient); // (2, 3 | 6, 7)
+	return _mm256_hadd_epi32(lo, hi);
+}
+
+// int32 16개(픽셀 순서) -> 바이트 16개 (포화)
+TARGET_AVX2
+static inline __m128i packPixels(__m256i first, __m256i second) {
+	__m256i words = _mm256_permute4x64_epi64(_mm256_packs_epi32(first, second), 0xD8);
+	return _mm_packus_epi16(_mm256_castsi256_si128(words), _mm256_extracti128_si256(words, 1));
+}
+
+TARGET_AVX2
+static void bgraToYuvRowPairAVX2(const uint8_t* rowA, const uint8_t* rowB, uint8_t* yRowA, uint8_t* yRowB, uint8_t* uRow, uint8_t* vRow, int uvStep, int width, const ForwardCoefficients& c) {
+	const __m256i yCoefficient = _mm256_setr_epi16(c.yB, c.yG, c.yR, 0, c.yB, c.yG, c.yR, 0, c.yB, c.yG, c.yR, 0, c.yB, c.yG, c.yR, 0);
+	const __m256i uCoefficient = _mm256_setr_epi16(c.uB, c.uG, c.uR, 0, c.uB, c.uG, c.uR, 0, c.uB, c.uG, c.uR, 0, c.uB, c.uG, c.uR, 0);
+	const __m256i vCoefficient = _mm256_setr_epi16(c.vB, c.vG, c.vR, 0, c.vB, c.vG, c.vR, 0, c.vB, c.vG, c.vR, 0, c.vB, c.vG, c.vR, 0);
+	const __m256i yBias = _mm256_set1_epi32((c.yOffset << FORWARD_SHIFT) + (1 << (FORWARD_SHIFT - 1)));
+	const __m256i cBias = _mm256_set1_epi32((128 << (FORWARD_SHIFT + 2)) + (1 << (FORWARD_SHIFT + 1)));
+	// 가로 쌍 합은 (0, 1, 4, 5 | 2, 3, 6, 7) 순서로 나옴
+	const __m256i chromaOrder = _mm256_setr_epi32(0, 1, 4, 5, 2, 3, 6, 7);
+
+	int x = 0;
+	for (; x + 16 <= width; x += 16) {
+		__m256i a0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rowA + x * 4));
+		__m256i a1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rowA + x * 4 + 32));
+		__m256i b0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rowB + x * 4));
+		__m256i b1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rowB + x * 4 + 32));
+
+		__m256i ya0 = _mm256_srai_epi32(_mm256_add_epi32(dotPixels(a0, yCoefficient), yBias), FORWARD_SHIFT);
+		__m256i ya1 = _mm256_srai_epi32(_mm256_add_epi32(dotPixels(a1, yCoefficient), yBias), FORWARD_SHIFT);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(yRowA + x), packPixels(ya0, ya1));
+		if (yRowB) {
+			__m256i yb0 = _mm256_srai_epi32(_mm256_add_epi32(dotPixels(b0, yCoefficient), yBias), FORWARD_SHIFT);
+			__m256i yb1 = _mm256_srai_epi32(_mm256_add_epi32(dotPixels(b1, yCoefficient), yBias), FORWARD_SHIFT);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(yRowB + x), packPixels(yb0, yb1));
+		}
+
+		// 세로 합 후 가로 쌍 합 = 2x2 합
+		__m256i u = _mm256_hadd_epi32(
+			_mm256_add_epi32(dotPixels(a0, uCoefficient), dotPixels(b0, uCoefficient)),
+			_mm256_add_epi32(dotPixels(a1, uCoefficient), dotPixels(b1, uCoefficient)));
+		__m256i v = _mm256_hadd_epi32(
+			_mm256_add_epi32(dotPixels(a0, vCoefficient), dotPixels(b0, vCoefficient)),
+			_mm256_add_epi32(dotPixels(a1, vCoefficient), dotPixels(b1, vCoefficient)));
+		u = _mm256_srai_epi32(_mm256_add_epi32(_mm256_permutevar8x32_epi32(u, chromaOrder), cBias), FORWARD_SHIFT + 2);
+		v = _mm256_srai_epi32(_mm256_add_epi32(_mm256_permutevar8x32_epi32(v, chromaOrder), cBias), FORWARD_SHIFT + 2);
+
+		__m128i uv = packPixels(u, v); // u0..u7 | v0..v7
+		if (uvStep == 2) {
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(uRow + x), _mm_unpacklo_epi8(uv, _mm_srli_si128(uv, 8)));
+		}
+		else {
+			_mm_storel_epi64(reinterpret_cast<__m128i*>(uRow + x / 2), uv);
+			_mm_storel_epi64(reinterpret_cast<__m128i*>(vRow + x / 2), _mm_srli_si128(uv, 8));
+		}
+	}
+	_mm256_zeroupper();
+
+	bgraToYuvRowPairScalar(rowA, rowB, yRowA, yRowB, uRow, vRow, uvStep, x, width, c);
+}
+
+static void yuvToBgraRowScalar(const uint8_t* yRow, const uint8_t* uRow, const uint8_t* vRow, int uvStep, uint8_t* bgra, int x0, int width, const InverseCoefficients& c) {
+	const int round = 1 << (INVERSE_SHIFT - 1);
+
+	for (int x = x0; x < width; ++x) {
+		int y = (yRow[x] - c.yOffset) * c.yScale + round;
+		int u = uRow[(x / 2) * uvStep] - 128;
+		int v = vRow[(x / 2) * uvStep] - 128;
+		bgra[x * 4 + 0] = clampByte((y + c.bU * u) >> INVERSE_SHIFT);
+		bgra[x * 4 + 1] = clampByte((y + c.gU * u + c.gV * v) >> INVERSE_SHIFT);
+		bgra[x * 4 + 2] = clampByte((y + c.rV * v) >> INVERSE_SHIFT);
+		bgra[x * 4 + 3] = 0xFF;
+	}
+}
+
+// madd용 int16 두 개 (low, high)를 int32 하나로
+static inline int coefficientPair(int16_t low, int16_t high) {
+	return static_cast<int>((static_cast<uint32_t>(static_cast<uint16_t>(high)) << 16) | static_cast<uint16_t>(low));
+}
+
+TARGET_AVX2
+static void yuvToBgraRowAVX2(const uint8_t* yRow, const uint8_t* uRow, const uint8_t* vRow, int uvStep, uint8_t* bgra, int width, const InverseCoefficients& c) {
+	const __m256i yOffset = _mm256_set1_epi16(static_cast<short>(c.yOffset));
+	const __m256i chromaOffset = _mm256_set1_epi16(128);
+	const __m256i round = _mm256_set1_epi32(1 << (INVERSE_SHIFT - 1));
+	const __m256i alpha = _mm256_set1_epi16(0xFF);
+	// (Y, U) / (Y, V) 쌍에 곱할 계수
+	const __m256i yuToB = _mm256_set1_epi32(coefficientPair(c.yScale, c.bU));
+	const __m256i yuToG = _mm256_set1_epi32(coefficientPair(c.yScale, c.gU));
+	const __m256i yvToG = _mm256_set1_epi32(coefficientPair(0, c.gV));
+	const __m256i yvToR = _mm256_set1_epi32(coefficientPair(c.yScale, c.rV));
+	const __m128i deinterleave = _mm_setr_epi8(0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15);
+
+	int x = 0;
+	for (; x + 16 <= width; x += 16) {
+		__m128i uv; // u0..u7 | v0..v7
+		if (uvStep == 2) {
+			uv = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(uRow + x)), deinterleave);
+		}
+		else {
+			uv = _mm_unpacklo_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(uRow + x / 2)), _mm_loadl_epi64(reinterpret_cast<const __m128i*>(vRow + x / 2)));
+		}
+
+		// 크로마는 가로로 두 번씩 반복
+		__m256i y = _mm256_sub_epi16(_mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(yRow + x))), yOffset);
+		__m256i u = _mm256_sub_epi16(_mm256_cvtepu8_epi16(_mm_unpacklo_epi8(uv, uv)), chromaOffset);
+		__m256i v = _mm256_sub_epi16(_mm256_cvtepu8_epi16(_mm_unpackhi_epi8(uv, uv)), chromaOffset);
+
+		// 레인 안 unpack 순서 (0-3 | 8-11), (4-7 | 12-15)는 packs에서 다시 픽셀 순서로 돌아옴
+		__m256i yuLo = _mm256_unpacklo_epi16(y, u);
+		__m256i yuHi = _mm256_unpackhi_epi16(y, u);
+		__m256i yvLo = _mm256_unpacklo_epi16(y, v);
+		__m256i yvHi = _mm256_unpackhi_epi16(y, v);
+
+		__m256i b = _mm256_packs_epi32(
+			_mm256_srai_epi32(_mm256_add_epi32(_mm256_madd_epi16(yuLo, yuToB), round), INVERSE_SHIFT),
+			_mm256_srai_epi32(_mm256_add_epi32(_mm256_madd_epi16(yuHi, yuToB), round), INVERSE_SHIFT));
+		__m256i g = _mm256_packs_epi32(
+			_mm256_srai_epi32(_mm256_add_epi32(_mm256_add_epi32(_mm256_madd_epi16(yuLo, yuToG), _mm256_madd_epi16(yvLo, yvToG)), round), INVERSE_SHIFT),
+			_mm256_srai_epi32(_mm256_add_epi32(_mm256_add_epi32(_mm256_madd_epi16(yuHi, yuToG), _mm256_madd_epi16(yvHi, yvToG)), round), INVERSE_SHIFT));
+		__m256i r = _mm256_packs_epi32(
+			_mm256_srai_epi32(_mm256_add_epi32(_mm256_madd_epi16(yvLo, yvToR), round), INVERSE_SHIFT),
+			_mm256_srai_epi32(_mm256_add_epi32(_mm256_madd_epi16(yvHi, yvToR), round), INVERSE_SHIFT));
+
+		__m256i br = _mm256_packus_epi16(b, r); // (B0-7 R0-7 | B8-15 R8-15)
+		__m256i ga = _mm256_packus_epi16(g, alpha);
+		__m256i bg = _mm256_unpacklo_epi8(br, ga);
+		__m256i ra = _mm256_unpackhi_epi8(br, ga);
+		__m256i p0 = _mm256_unpacklo_epi16(bg, ra); // (0-3 | 8-11)
+		__m256i p1 = _mm256_unpackhi_epi16(bg, ra); // (4-7 | 12-15)
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(bgra + x * 4), _mm256_permute2x128_si256(p0, p1, 0x20));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(bgra + x * 4 + 32), _mm256_permute2x128_si256(p0, p1, 0x31));
+	}
+	_mm256_zeroupper();
+
+	yuvToBgraRowScalar(yRow, uRow, vRow, uvStep, bgra, x, width, c);
+}
+
+static const bool useAvx2 = getCpuFeatures().avx2;
+
+// 크로마 평면 위치. NV12는 U/V가 한 평면에 교차
+struct ChromaPlanes {
+	uint8_t* u;
+	uint8_t* v;
+	size_t stride;
+	int step;
+};
+
+static ChromaPlanes getChromaPlanes(uint8_t* yuv, int width, int height, int pixelFormat) {
+	size_t chromaWidth = (width + 1) / 2;
+	size_t chromaHeight = (height + 1) / 2;
+	uint8_t* chroma = yuv + static_cast<size_t>(width) * height;
+	if (pixelFormat == PIXEL_FORMAT_NV12) {
+		return { chroma, chroma + 1, chromaWidth * 2, 2 };
+	}
+	return { chroma, chroma + chromaWidth * chromaHeight, chromaWidth, 1 };
+}
+
+// count개 행(또는 행 쌍)을 밴드로 나눠 body(first, last) 실행
+template <typename Body>
+static void forEachBand(size_t count, ThreadPool* pool, Body body) {
+	size_t bandCount = pool ? (std::min)(count, (pool->size() + 1) * 2) : 1;
+	if (bandCount <= 1) {
+		body(0, count);
+		return;
+	}
+	pool->parallelFor(bandCount, [&](size_t band) {
+		body(band * count / bandCount, (band + 1) * count / bandCount);
+	});
+}
+
+size_t yuvFrameSize(int width, int height) {
+	size_t chromaSize = static_cast<size_t>((width + 1) / 2) * ((height + 1) / 2);
+	return static_cast<size_t>(width) * height + chromaSize * 2;
+}
+
+void convertBgraToYuv(const uint8_t* bgra, int width, int height, uint8_t* yuv, int pixelFormat, int colorMatrix, bool fullRange, ThreadPool* pool) {
+	const ForwardCoefficients c = makeForwardCoefficients(colorMatrix, fullRange);
+	const ChromaPlanes chroma = getChromaPlanes(yuv, width, height, pixelFormat);
+	const size_t stride = static_cast<size_t>(width) * 4;
+
+	forEachBand((height + 1) / 2, pool, [&](size_t firstPair, size_t lastPair) {
+		for (size_t pair = firstPair; pair < lastPair; ++pair) {
+			size_t y = pair * 2;
+			bool hasSecondRow = y + 1 < static_cast<size_t>(height);
+			const uint8_t* rowA = bgra + y * stride;
+			const uint8_t* rowB = hasSecondRow ? rowA + stride : rowA;
+			uint8_t* yRowA = yuv + y * width;
+			uint8_t* yRowB = hasSecondRow ? yRowA + width : nullptr;
+			uint8_t* uRow = chroma.u + pair * chroma.stride;
+			uint8_t* vRow = chroma.v + pair * chroma.stride;
+
+			if (useAvx2) {
+				bgraToYuvRowPairAVX2(rowA, rowB, yRowA, yRowB, uRow, vRow, chroma.step, width, c);
+			}
+			else {
+				bgraToYuvRowPairScalar(rowA, rowB, yRowA, yRowB, uRow, vRow, chroma.step, 0, width, c);
+			}
+		}
+	});
+}
+
+void convertYuvToBgra(const uint8_t* yuv, int width, int height, uint8_t* bgra, int pixelFormat, int colorMatrix, bool fullRange, ThreadPool* pool) {
+	const InverseCoefficients c = makeInverseCoefficients(colorMatrix, fullRange);
+	const ChromaPlanes chroma = getChromaPlanes(const_cast<uint8_t*>(yuv), width, height, pixelFormat);
+	const size_t stride = static_cast<size_t>(width) * 4;
+
+	forEachBand(height, pool, [&](size_t firstRow, size_t lastRow) {
+		for (size_t y = firstRow; y < lastRow; ++y) {
+			const uint8_t* yRow = yuv + y * width;
+			const uint8_t* uRow = chroma.u + (y / 2) * chroma.stride;
+			const uint8_t* vRow = chroma.v + (y / 2) * chroma.stride;
+
+			if (useAvx2) {
+				yuvToBgraRowAVX2(yRow, uRow, vRow, chroma.step, bgra + y * stride, width, c);
+			}
+			else {
+				yuvToBgraRowScalar(yRow, uRow, vRow, chroma.step, bgra + y * stride, 0, width, c);
+			}
+		}
+	});
+}
+
+double computePsnr(const uint8_t* bgraA, const uint8_t* bgraB, size_t pixelCount) {
+	const __m128i colorMask = _mm_set1_epi32(0x00FFFFFF);
+	const __m128i zero = _mm_setzero_si128();
+	unsigned long long sum = 0;
+	size_t i = 0;
+
+	// 32비트 누적이 넘치지 않도록 일정 간격마다 64비트로 옮김
+	while (i + 4 <= pixelCount) {
+		__m128i acc = _mm_setzero_si128();
+		size_t end = (std::min)(pixelCount & ~static_cast<size_t>(3), i + 4 * 4096);
+		for (; i < end; i += 4) {
+			__m128i a = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(bgraA + i * 4)), colorMask);
+			__m128i b = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(bgraB + i * 4)), colorMask);
+			__m128i dLo = _mm_sub_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+			__m128i dHi = _mm_sub_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+			acc = _mm_add_epi32(acc, _mm_add_epi32(_mm_madd_epi16(dLo, dLo), _mm_madd_epi16(dHi, dHi)));
+		}
+		alignas(16) uint32_t lanes[4];
+		_mm_store_si128(reinterpret_cast<__m128i*>(lanes), acc);
+		sum += static_cast<unsigned long long>(lanes[0]) + lanes[1] + lanes[2] + lanes[3];
+	}
+	for (; i < pixelCount; ++i) {
+		for (int channel = 0; channel < 3; ++channel) {
+			int d = bgraA[i * 4 + channel] - bgraB[i * 4 + channel];
+			sum += d * d;
+		}
+	}
+
+	if (sum == 0) {
+		return std::numeric_limits<double>::infinity();
+	}
+	double mse = static_cast<double>(sum) / (static_cast<double>(pixelCount) * 3);
+	return 10.0 * std::log10(255.0 * 255.0 / mse);
+}
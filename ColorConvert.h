@@ -0,0 +1,22 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#include "CaptureDLL.h"
+#include "ThreadPool.h"
+
+// BGRA <-> 4:2:0 YUV 변환 (PixelFormat / ColorMatrix)
+// NV12: Y 평면 | UV 교차 평면, I420: Y 평면 | U 평면 | V 평면. 크로마는 2x2 픽셀 평균
+// 홀수 크기는 마지막 열/행을 복제해 크로마를 만듦
+
+// Y 평면 + 크로마 평면 전체 바이트 수
+size_t yuvFrameSize(int width, int height);
+
+// bgra(width * height * 4) -> yuv(yuvFrameSize). pool이 있으면 행 쌍 밴드로 나눠 병렬 처리
+void convertBgraToYuv(const uint8_t* bgra, int width, int height, uint8_t* yuv, int pixelFormat, int colorMatrix, bool fullRange, ThreadPool* pool = nullptr);
+
+// 수신 측: yuv -> bgra (알파는 0xFF)
+void convertYuvToBgra(const uint8_t* yuv, int width, int height, uint8_t* bgra, int pixelFormat, int colorMatrix, bool fullRange, ThreadPool* pool = nullptr);
+
+// 두 BGRA 이미지의 B/G/R 채널 PSNR (dB, 같으면 무한대)
+double computePsnr(const uint8_t* bgraA, const uint8_t* bgraB, size_t pixelCount);
@@ -0,0 +1,70 @@
+#include "CpuFeatures.h"
+
+#include <cstdint>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+
+static void cpuid(int leaf, int subLeaf, int regs[4]) {
+#if defined(_MSC_VER)
+	__cpuidex(regs, leaf, subLeaf);
+#else
+	unsigned int a = 0, b = 0, c = 0, d = 0;
+	__cpuid_count(leaf, subLeaf, a, b, c, d);
+	regs[0] = (int)a; regs[1] = (int)b; regs[2] = (int)c; regs[3] = (int)d;
+#endif
+}
+
+// OS가 YMM/ZMM 레지스터 상태를 저장하는지 확인 (XCR0)
+static uint64_t xgetbv0() {
+#if defined(_MSC_VER)
+	return _xgetbv(0);
+#else
+	uint32_t eax, edx;
+	__asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+	return ((uint64_t)edx << 32) | eax;
+#endif
+}
+
+static CpuFeatures detectCpuFeatures() {
+	CpuFeatures features;
+	int regs[4] = { 0 };
+
+	cpuid(0, 0, regs);
+	int maxLeaf = regs[0];
+	if (maxLeaf < 1) {
+		return features;
+	}
+
+	cpuid(1, 0, regs);
+	features.sse2 = (regs[3] & (1 << 26)) != 0;
+	features.ssse3 = (regs[2] & (1 << 9)) != 0;
+	features.sse41 = (regs[2] & (1 << 19)) != 0;
+	features.sse42 = (regs[2] & (1 << 20)) != 0;
+
+	bool osxsave = (regs[2] & (1 << 27)) != 0;
+	bool avx = (regs[2] & (1 << 28)) != 0;
+	if (!osxsave || !avx || maxLeaf < 7) {
+		return features;
+	}
+
+	uint64_t xcr0 = xgetbv0();
+	bool ymmEnabled = (xcr0 & 0x6) == 0x6;     // XMM + YMM
+	bool zmmEnabled = (xcr0 & 0xE6) == 0xE6;   // XMM + YMM + opmask + ZMM
+
+	cpuid(7, 0, regs);
+	features.avx2 = ymmEnabled && (regs[1] & (1 << 5)) != 0;
+	features.avx512bw = zmmEnabled && features.avx2
+		&& (regs[1] & (1 << 16)) != 0   // AVX512F
+		&& (regs[1] & (1 << 30)) != 0;  // AVX512BW
+
+	return features;
+}
+
+const CpuFeatures& getCpuFeatures() {
+	static const CpuFeatures features = detectCpuFeatures();
+	return features;
+}
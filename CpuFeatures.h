@@ -0,0 +1,27 @@
+#pragma once
+
+// SIMD 커널이 없는 ISA를 MSVC는 /arch 없이도 컴파일하지만, GCC/Clang은 함수 단위로 지정해야 함
+#if defined(_MSC_VER)
+#define TARGET_SSSE3
+#define TARGET_SSE42
+#define TARGET_AVX2
+#define TARGET_AVX512BW
+#else
+#define TARGET_SSSE3 __attribute__((target("ssse3")))
+#define TARGET_SSE42 __attribute__((target("sse4.2")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#define TARGET_AVX512BW __attribute__((target("avx512f,avx512bw")))
+#endif
+
+// CPU가 지원하는 SIMD 기능 (CPUID + XGETBV 기준)
+struct CpuFeatures {
+	bool sse2 = false;
+	bool ssse3 = false;
+	bool sse41 = false;
+	bool sse42 = false;
+	bool avx2 = false;
+	bool avx512bw = false;
+};
+
+// 첫 호출 시 한 번만 CPUID를 조회하고 이후에는 캐시된 값을 반환
+const CpuFeatures& getCpuFeatures();
@@ -0,0 +1,109 @@
+#include "EncodedFrameRing.h"
+
+#include <chrono>
+
+EncodedFrameRing::EncodedFrameRing(size_t capacity) {
+	size_t size = 2;
+	while (size < capacity) {
+		size <<= 1;
+	}
+	slots.reset(new Slot[size]);
+	mask = size - 1;
+}
+
+EncodedFrameRing::~EncodedFrameRing() {
+	for (size_t position = head.load(); position != tail.load(); ++position) {
+		Task& release = slots[position & mask].release;
+		if (release) {
+			release();
+		}
+	}
+}
+
+void EncodedFrameRing::open() {
+	closed.store(false);
+}
+
+void EncodedFrameRing::close() {
+	{
+		std::lock_guard<std::mutex> lock(waitMutex);
+		closed.store(true);
+	}
+	waitCondition.notify_all();
+}
+
+bool EncodedFrameRing::push(const FrameData& frameData, Task release) {
+	size_t position = tail.load(std::memory_order_relaxed);
+	auto hasRoom = [this, position] { return position - head.load(std::memory_order_acquire) <= mask; };
+	if (!hasRoom()) {
+		std::unique_lock<std::mutex> lock(waitMutex);
+		waiters.fetch_add(1);
+		waitCondition.wait(lock, [this, &hasRoom] { return hasRoom() || closed.load(); });
+		waiters.fetch_sub(1);
+		if (!hasRoom()) {
+			lock.unlock();
+			if (release) {
+				release();
+			}
+			return false;
+		}
+	}
+
+	Slot& slot = slots[position & mask];
+	slot.frameData = frameData;
+	slot.release = std::move(release);
+	tail.store(position + 1, std::memory_order_release);
+	wake();
+	return true;
+}
+
+const FrameData* EncodedFrameRing::acquire(int timeoutMs) {
+	size_t position = acquired;
+	auto hasFrame = [this, position] { return position != tail.load(std::memory_order_acquire); };
+	if (!hasFrame()) {
+		if (timeoutMs == 0) {
+			return nullptr;
+		}
+		std::unique_lock<std::mutex> lock(waitMutex);
+		waiters.fetch_add(1);
+		auto ready = [this, &hasFrame] { return hasFrame() || closed.load(); };
+		if (timeoutMs < 0) {
+			waitCondition.wait(lock, ready);
+		}
+		else {
+			waitCondition.wait_for(lock, std::chrono::milliseconds(timeoutMs), ready);
+		}
+		waiters.fetch_sub(1);
+		if (!hasFrame()) {
+			return nullptr;
+		}
+	}
+
+	acquired = position + 1;
+	return &slots[position & mask].frameData;
+}
+
+bool EncodedFrameRing::release(const FrameData* frameData) {
+	size_t position = head.load(std::memory_order_relaxed);
+	Slot& slot = slots[position & mask];
+	if (position == acquired || &slot.frameData != frameData) {
+		return false;
+	}
+
+	if (slot.release) {
+		slot.release();
+		slot.release.reset();
+	}
+	head.store(position + 1, std::memory_order_release);
+	wake();
+	return true;
+}
+
+void EncodedFrameRing::wake() {
+	// 잠들려는 쪽은 waiters를 올린 뒤 위치를 다시 읽으므로, 위치를 쓴 뒤 waiters가 0이면 깨울 대상이 없음
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (waiters.load(std::memory_order_relaxed) > 0) {
+		std::lock_guard<std::mutex> lock(waitMutex);
+		waitCondition.notify_all();
+	}
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+
+#include "CaptureDLL.h"
+#include "TaskQueue.h"
+
+// 풀 방식(AcquireEncodedFrame)으로 넘기는 인코딩된 프레임 링
+// 전달 쓰레드 하나가 넣고 호스트 쓰레드 하나가 꺼냄. 칸 이동은 lock-free이고 비었거나 가득 찼을 때만 조건 변수로 잠듦
+// 호스트는 칸 안의 FrameData를 그대로 빌려 가고(복사 없음) 반납할 때 버퍼가 풀로 돌아감
+class EncodedFrameRing {
+public:
+	// capacity는 2의 거듭제곱으로 올림. 호스트가 들고 있는 프레임도 칸을 차지함
+	explicit EncodedFrameRing(size_t capacity);
+	// 반납되지 않은 프레임의 버퍼도 모두 돌려줌
+	~EncodedFrameRing();
+
+	size_t capacity() const { return mask + 1; }
+
+	// 캡처 시작. 이전 캡처에서 꺼내지 않은 프레임은 새 프레임보다 먼저 나옴
+	void open();
+	// 캡처 중지. 기다리던 push/acquire를 깨우고, 이후 acquire는 링이 비면 바로 반환
+	void close();
+
+	// 전달 쓰레드: 자리가 날 때까지 대기 (전달 창을 통해 캡처까지 밀림)
+	// 닫힌 뒤 자리가 없으면 기다리지 않고 release를 실행해 버린 뒤 false
+	bool push(const FrameData& frameData, Task release);
+
+	// 호스트: 가장 오래된 프레임. timeoutMs < 0이면 무한 대기, 0이면 기다리지 않음
+	// 시간이 지났거나 닫힌 링이 비었으면 nullptr
+	const FrameData* acquire(int timeoutMs);
+	// 호스트: acquire한 순서대로 반납. 순서가 틀리면 false
+	bool release(const FrameData* frameData);
+
+private:
+	struct Slot {
+		FrameData frameData{};
+		Task release; // 버퍼를 풀로 돌려주는 작업
+	};
+
+	void wake();
+
+	std::unique_ptr<Slot[]> slots;
+	size_t mask;
+	alignas(64) std::atomic<size_t> head{ 0 }; // 다음에 반납될 칸 (호스트)
+	size_t acquired = 0;                       // 다음에 빌려 줄 칸 (호스트 전용)
+	alignas(64) std::atomic<size_t> tail{ 0 }; // 다음에 넣을 칸 (전달 쓰레드)
+
+	// 잠들 때만 사용
+	alignas(64) std::atomic<int> waiters{ 0 };
+	std::atomic<bool> closed{ true };
+	std::mutex waitMutex;
+	std::condition_variable waitCondition;
+};
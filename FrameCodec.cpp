@@ -0,0 +1,329 @@
+#include "FrameCodec.h"
+#include "FrameDiff.h"
+#define LZ4_STATIC_LINKING_ONLY
+#include "lz4.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <iostream>
+#include <memory>
+
+// 한 번에 처리하는 밴드 최대 수 (밴드별 결과 크기 배열을 스택에 둠)
+static const size_t MAX_BANDS = 256;
+
+// 워커 쓰레드마다 한 번만 만들어 재사용하는 LZ4 상태
+// LZ4_compress_fast는 호출마다 16 KB 상태를 스택에 만들고 초기화하므로 이를 피함
+static LZ4_stream_t* workerLz4State() {
+	thread_local std::unique_ptr<LZ4_stream_t> state;
+	if (!state) {
+		state.reset(new LZ4_stream_t);
+		countAllocation(sizeof(LZ4_stream_t));
+		LZ4_initStream(state.get(), sizeof(LZ4_stream_t));
+	}
+	return state.get();
+}
+
+// 블록(BGRA)을 채널 배치대로 변환해 packed에 씀. BGRA면 변환 없이 원본을 돌려줌
+static const uint8_t* packBlock(const uint8_t* block, size_t blockSize, int channelLayout, uint8_t* packed, int& packedSize) {
+	packedSize = static_cast<int>(packedChannelSize(blockSize / 4, channelLayout));
+	if (channelLayout == CHANNEL_BGRA) {
+		return block;
+	}
+	packChannels(block, packed, blockSize / 4, channelLayout);
+	return packed;
+}
+
+static bool isValidLayout(uint32_t channelLayout, size_t rawSize) {
+	return channelLayout <= CHANNEL_PLANAR && (channelLayout == CHANNEL_BGRA || rawSize % 4 == 0);
+}
+
+// 블록 단위 압축 공통 루틴. out[outOffset..]에 blockCount x (int32 압축 크기 | LZ4 블록)을 씀
+// compressBlock(offset, size, dst, dstCapacity, scratch)은 블록 하나를 압축하고 압축 크기를 돌려줌
+// 연속된 블록을 밴드로 묶어 밴드마다 자기 영역에만 쓰고, 끝난 뒤 앞으로 당겨 붙임
+template <typename CompressBlock>
+static bool compressBlocks(size_t rawSize, ThreadPool* pool, CompressBlock compressBlock, ByteBuffer& compressedData, size_t outOffset) {
+	const size_t blockCount = (rawSize + FUSED_BLOCK_SIZE - 1) / FUSED_BLOCK_SIZE;
+	const int maxBlockSize = LZ4_compressBound(static_cast<int>(FUSED_BLOCK_SIZE));
+	const size_t slotSize = sizeof(int32_t) + maxBlockSize;
+
+	compressedData.resize(outOffset + blockCount * slotSize);
+	if (blockCount == 0) {
+		return true;
+	}
+
+	size_t bandCount = pool ? (std::min)((std::min)(blockCount, (pool->size() + 1) * 2), MAX_BANDS) : 1;
+	size_t bandSizes[MAX_BANDS] = { 0 };
+	// 여러 밴드가 동시에 쓸 수 있음. parallelFor가 끝난 뒤에만 읽음
+	std::atomic<bool> failed{ false };
+
+	auto compressBand = [&](size_t band) {
+		alignas(64) uint8_t scratch[FUSED_BLOCK_SIZE];
+		size_t firstBlock = band * blockCount / bandCount;
+		size_t lastBlock = (band + 1) * blockCount / bandCount;
+		unsigned char* out = compressedData.data() + outOffset + firstBlock * slotSize;
+		size_t written = 0;
+
+		for (size_t block = firstBlock; block < lastBlock; ++block) {
+			size_t offset = block * FUSED_BLOCK_SIZE;
+			size_t blockSize = (std::min)(FUSED_BLOCK_SIZE, rawSize - offset);
+			int32_t compressedSize = compressBlock(offset, blockSize, reinterpret_cast<char*>(out + written + sizeof(int32_t)), maxBlockSize, scratch);
+			if (compressedSize <= 0) {
+				failed.store(true, std::memory_order_relaxed);
+				return;
+			}
+
+			memcpy(out + written, &compressedSize, sizeof(int32_t));
+			written += sizeof(int32_t) + compressedSize;
+		}
+		bandSizes[band] = written;
+	};
+
+	if (pool && bandCount > 1) {
+		pool->parallelFor(bandCount, compressBand);
+	}
+	else {
+		compressBand(0);
+	}
+
+	if (failed.load(std::memory_order_relaxed)) {
+		std::cerr << "Compression failed!" << std::endl;
+		return false;
+	}
+
+	size_t packed = outOffset;
+	for (size_t band = 0; band < bandCount; ++band) {
+		size_t firstBlock = band * blockCount / bandCount;
+		memmove(compressedData.data() + packed, compressedData.data() + outOffset + firstBlock * slotSize, bandSizes[band]);
+		packed += bandSizes[band];
+	}
+	compressedData.resize(packed); // 실제 크기로 축소
+	return true;
+}
+
+// compressBlocks의 역. decompressBlock(offset, size, src, srcSize, scratch)이 블록 하나를 풀어 제자리에 씀
+template <typename DecompressBlock>
+static bool decompressBlocks(const uint8_t* compressedData, size_t compressedSize, size_t inOffset, size_t rawSize, DecompressBlock decompressBlock) {
+	alignas(64) uint8_t block[FUSED_BLOCK_SIZE];
+
+	for (size_t offset = 0; offset < rawSize; offset += FUSED_BLOCK_SIZE) {
+		size_t blockSize = (std::min)(FUSED_BLOCK_SIZE, rawSize - offset);
+
+		int32_t blockCompressedSize;
+		if (inOffset + sizeof(int32_t) > compressedSize) {
+			return false;
+		}
+		memcpy(&blockCompressedSize, compressedData + inOffset, sizeof(int32_t));
+		inOffset += sizeof(int32_t);
+		if (blockCompressedSize <= 0 || inOffset + blockCompressedSize > compressedSize) {
+			return false;
+		}
+
+		if (!decompressBlock(offset, blockSize, reinterpret_cast<const char*>(compressedData + inOffset), blockCompressedSize, block)) {
+			return false;
+		}
+		inOffset += blockCompressedSize;
+	}
+
+	return true;
+}
+
+bool compressFrame(const uint8_t* currentFrame, const uint8_t* previousFrame, size_t frameSize, int acceleration, ByteBuffer& compressedData, ThreadPool* pool, int channelLayout, uint32_t frameFlags) {
+	XorFrameHeader header = {};
+	header.rawSize = static_cast<uint32_t>(frameSize);
+	header.blockSize = static_cast<uint32_t>(FUSED_BLOCK_SIZE);
+	header.blockCount = static_cast<uint32_t>((frameSize + FUSED_BLOCK_SIZE - 1) / FUSED_BLOCK_SIZE);
+	header.channelLayout = static_cast<uint16_t>(channelLayout);
+	header.flags = static_cast<uint16_t>(frameFlags);
+
+	// 변경된 부분 계산 (캐시에 남아있는 블록 버퍼로) 후 바로 압축
+	auto diffBlock = [&](size_t offset, size_t blockSize, char* dst, int dstCapacity, uint8_t* scratch) {
+		alignas(64) uint8_t packed[FUSED_BLOCK_SIZE];
+		int packedSize;
+		calculateDiffSIMD(currentFrame + offset, previousFrame + offset, scratch, blockSize);
+		const uint8_t* src = packBlock(scratch, blockSize, channelLayout, packed, packedSize);
+		return LZ4_compress_fast_extState_fastReset(workerLz4State(), reinterpret_cast<const char*>(src), dst, packedSize, dstCapacity, acceleration);
+	};
+
+	if (!compressBlocks(frameSize, pool, diffBlock, compressedData, sizeof(XorFrameHeader))) {
+		return false;
+	}
+	memcpy(compressedData.data(), &header, sizeof(XorFrameHeader));
+	return true;
+}
+
+bool decompressFrame(const uint8_t* compressedData, size_t compressedSize, const uint8_t* previousFrame, uint8_t* frame, size_t frameSize) {
+	XorFrameHeader header;
+	if (compressedSize < sizeof(XorFrameHeader)) {
+		return false;
+	}
+	memcpy(&header, compressedData, sizeof(XorFrameHeader));
+	if (header.rawSize != frameSize || header.blockSize != FUSED_BLOCK_SIZE || !isValidLayout(header.channelLayout, frameSize)) {
+		return false;
+	}
+
+	bool zeroBase = (header.flags & FRAME_FLAG_ZERO_BASE) != 0;
+	return decompressBlocks(compressedData, compressedSize, sizeof(XorFrameHeader), frameSize,
+		[&](size_t offset, size_t blockSize, const char* src, int srcSize, uint8_t* scratch) {
+			int packedSize = static_cast<int>(packedChannelSize(blockSize / 4, header.channelLayout));
+			int decompressedSize = LZ4_decompress_safe(src, reinterpret_cast<char*>(scratch), srcSize, packedSize);
+			if (decompressedSize != packedSize) {
+				return false;
+			}
+			// 0 프레임과의 XOR는 그대로이므로 풀린 블록이 곧 현재 프레임
+			if (header.channelLayout == CHANNEL_BGRA) {
+				if (zeroBase) {
+					memcpy(frame + offset, scratch, blockSize);
+				}
+				else {
+					calculateDiffSIMD(scratch, previousFrame + offset, frame + offset, blockSize);
+				}
+				return true;
+			}
+			// 이전 블록도 같은 배치로 바꿔 XOR한 뒤 펼침 (알파는 다른 모드와 같이 0xFF)
+			// previousFrame == frame 일 수 있으므로 이전 블록을 먼저 떼어 둠
+			if (!zeroBase) {
+				alignas(64) uint8_t packedPrevious[FUSED_BLOCK_SIZE];
+				const uint8_t* previous = packBlock(previousFrame + offset, blockSize, header.channelLayout, packedPrevious, packedSize);
+				calculateDiffSIMD(scratch, previous, scratch, packedSize);
+			}
+			unpackChannels(scratch, frame + offset, blockSize / 4, header.channelLayout, 0xFF);
+			return true;
+		});
+}
+
+bool compressFrameWithDict(const uint8_t* currentFrame, const uint8_t* previousFrame, size_t frameSize, int acceleration, ByteBuffer& compressedData, ThreadPool* pool, int channelLayout, uint32_t frameFlags) {
+	XorFrameHeader header = {};
+	header.rawSize = static_cast<uint32_t>(frameSize);
+	header.blockSize = static_cast<uint32_t>(FUSED_BLOCK_SIZE);
+	header.blockCount = static_cast<uint32_t>((frameSize + FUSED_BLOCK_SIZE - 1) / FUSED_BLOCK_SIZE);
+	header.channelLayout = static_cast<uint16_t>(channelLayout);
+	header.flags = static_cast<uint16_t>(frameFlags);
+
+	// 이전 프레임의 같은 위치 블록을 사전으로 걸고 현재 블록을 압축
+	// 같은 위치의 일치는 거리 = 블록 크기(32 KB 이하)라 LZ4 최대 거리(64 KB) 안에 들어옴
+	// 채널 배치를 바꾸면 사전도 같은 배치로 바꿔야 일치가 유지됨
+	// LZ4_loadDict는 사전을 드문드문 색인해 같은 위치 일치를 자주 놓침. 모든 위치를 색인하는 LZ4_loadDictSlow를 씀
+	// (정적/부분 변경 UI 화면에서 출력이 약 10% 작아지고 사전 적재 시간은 늘어남, tests/DictCompressBench)
+	auto dictBlock = [&](size_t offset, size_t blockSize, char* dst, int dstCapacity, uint8_t* scratch) {
+		alignas(64) uint8_t packedDict[FUSED_BLOCK_SIZE];
+		int packedSize;
+		const uint8_t* dict = packBlock(previousFrame + offset, blockSize, channelLayout, packedDict, packedSize);
+		const uint8_t* src = packBlock(currentFrame + offset, blockSize, channelLayout, scratch, packedSize);
+
+		LZ4_stream_t* stream = workerLz4State();
+		LZ4_resetStream_fast(stream);
+		LZ4_loadDictSlow(stream, reinterpret_cast<const char*>(dict), packedSize);
+		return LZ4_compress_fast_continue(stream, reinterpret_cast<const char*>(src), dst, packedSize, dstCapacity, acceleration);
+	};
+
+	if (!compressBlocks(frameSize, pool, dictBlock, compressedData, sizeof(XorFrameHeader))) {
+		return false;
+	}
+	memcpy(compressedData.data(), &header, sizeof(XorFrameHeader));
+	return true;
+}
+
+bool decompressFrameWithDict(const uint8_t* compressedData, size_t compressedSize, const uint8_t* previousFrame, uint8_t* frame, size_t frameSize) {
+	XorFrameHeader header;
+	if (compressedSize < sizeof(XorFrameHeader)) {
+		return false;
+	}
+	memcpy(&header, compressedData, sizeof(XorFrameHeader));
+	if (header.rawSize != frameSize || header.blockSize != FUSED_BLOCK_SIZE || !isValidLayout(header.channelLayout, frameSize)) {
+		return false;
+	}
+
+	// 사전(이전 블록)과 출력이 겹치면 안 되므로 scratch에 풀고 복사
+	// 0 프레임 기준이면 0 블록을 사전으로 (0 블록은 채널 배치를 바꿔도 0)
+	alignas(64) static const uint8_t zeroBlock[FUSED_BLOCK_SIZE] = {};
+	bool zeroBase = (header.flags & FRAME_FLAG_ZERO_BASE) != 0;
+	return decompressBlocks(compressedData, compressedSize, sizeof(XorFrameHeader), frameSize,
+		[&](size_t offset, size_t blockSize, const char* src, int srcSize, uint8_t* scratch) {
+			alignas(64) uint8_t packedDict[FUSED_BLOCK_SIZE];
+			int packedSize = static_cast<int>(packedChannelSize(blockSize / 4, header.channelLayout));
+			const uint8_t* dict = zeroBase ? zeroBlock : packBlock(previousFrame + offset, blockSize, header.channelLayout, packedDict, packedSize);
+			int decompressedSize = LZ4_decompress_safe_usingDict(src, reinterpret_cast<char*>(scratch), srcSize, packedSize,
+				reinterpret_cast<const char*>(dict), packedSize);
+			if (decompressedSize != packedSize) {
+				return false;
+			}
+			unpackChannels(scratch, frame + offset, blockSize / 4, header.channelLayout, 0xFF);
+			return true;
+		});
+}
+
+bool compressTiles(const TileGrid& grid, const ByteBuffer& dirtyBitmap, int dirtyTileCount, const ByteBuffer& tilePixels, int acceleration, ByteBuffer& compressedData, ThreadPool* pool, int channelLayout, uint32_t frameFlags) {
+	TileFrameHeader header = {};
+	header.tileSize = static_cast<uint16_t>(grid.tileSize);
+	header.tilesX = static_cast<uint16_t>(grid.tilesX);
+	header.tilesY = static_cast<uint16_t>(grid.tilesY);
+	header.channelLayout = static_cast<uint8_t>(channelLayout);
+	header.flags = static_cast<uint8_t>(frameFlags);
+	header.dirtyTileCount = dirtyTileCount;
+	header.rawPixelSize = static_cast<uint32_t>(tilePixels.size());
+
+	// 변경된 타일이 없으면 헤더와 비트맵만 보냄
+	size_t headerSize = sizeof(TileFrameHeader) + dirtyBitmap.size();
+	auto tileBlock = [&](size_t offset, size_t blockSize, char* dst, int dstCapacity, uint8_t* scratch) {
+		int packedSize;
+		const uint8_t* src = packBlock(tilePixels.data() + offset, blockSize, channelLayout, scratch, packedSize);
+		return LZ4_compress_fast_extState_fastReset(workerLz4State(), reinterpret_cast<const char*>(src), dst, packedSize, dstCapacity, acceleration);
+	};
+
+	if (!compressBlocks(tilePixels.size(), pool, tileBlock, compressedData, headerSize)) {
+		return false;
+	}
+	memcpy(compressedData.data(), &header, sizeof(TileFrameHeader));
+	memcpy(compressedData.data() + sizeof(TileFrameHeader), dirtyBitmap.data(), dirtyBitmap.size());
+	return true;
+}
+
+bool decompressTiles(const uint8_t* compressedData, size_t compressedSize, uint8_t* frame, int frameWidth, int frameHeight) {
+	TileFrameHeader header;
+	if (compressedSize < sizeof(TileFrameHeader)) {
+		return false;
+	}
+	memcpy(&header, compressedData, sizeof(TileFrameHeader));
+
+	TileGrid grid = makeTileGrid(frameWidth, frameHeight, header.tileSize);
+	if (header.tileSize == 0 || grid.tilesX != header.tilesX || grid.tilesY != header.tilesY) {
+		return false;
+	}
+
+	size_t headerSize = sizeof(TileFrameHeader) + grid.bitmapSize();
+	if (compressedSize < headerSize) {
+		return false;
+	}
+	const uint8_t* dirtyBitmap = compressedData + sizeof(TileFrameHeader);
+	if (dirtyTilePixelSize(grid, dirtyBitmap) != header.rawPixelSize || !isValidLayout(header.channelLayout, header.rawPixelSize)) {
+		return false;
+	}
+	// 0 프레임 기준이면 변경되지 않은 타일도 0
+	if (header.flags & FRAME_FLAG_ZERO_BASE) {
+		memset(frame, 0, static_cast<size_t>(frameWidth) * frameHeight * 4);
+	}
+	if (header.rawPixelSize == 0) {
+		return true;
+	}
+
+	std::vector<unsigned char> tilePixels(header.rawPixelSize);
+	bool ok = decompressBlocks(compressedData, compressedSize, headerSize, tilePixels.size(),
+		[&](size_t offset, size_t blockSize, const char* src, int srcSize, uint8_t* scratch) {
+			int packedSize = static_cast<int>(packedChannelSize(blockSize / 4, header.channelLayout));
+			if (header.channelLayout == CHANNEL_BGRA) {
+				return LZ4_decompress_safe(src, reinterpret_cast<char*>(tilePixels.data() + offset), srcSize, packedSize) == packedSize;
+			}
+			if (LZ4_decompress_safe(src, reinterpret_cast<char*>(scratch), srcSize, packedSize) != packedSize) {
+				return false;
+			}
+			unpackChannels(scratch, tilePixels.data() + offset, blockSize / 4, header.channelLayout, 0xFF);
+			return true;
+		});
+	if (!ok) {
+		return false;
+	}
+
+	unpackDirtyTiles(frame, grid, dirtyBitmap, tilePixels.data());
+	return true;
+}
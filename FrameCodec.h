@@ -0,0 +1,52 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "ByteBuffer.h"
+#include "ChannelPack.h"
+#include "ThreadPool.h"
+#include "TileDiff.h"
+
+// 융합 diff+압축 블록 크기. XOR 결과가 L1/L2에 머문 채로 바로 LZ4에 들어가도록 작게 유지
+const size_t FUSED_BLOCK_SIZE = 32 * 1024;
+
+// XorFrameHeader/TileFrameHeader의 flags
+// 보내는 쪽이 기준을 0 프레임으로 다시 잡은 프레임 (해상도 변경, 뒤 단계 실패 뒤 전체 갱신). 받는 쪽도 이전 프레임 대신 0 프레임 기준으로 풂
+const uint32_t FRAME_FLAG_ZERO_BASE = 1;
+
+#pragma pack(push, 1)
+// ENCODE_XOR_LZ4 / ENCODE_LZ4_DICT 페이로드: XorFrameHeader | blockCount x (int32 압축 크기 | LZ4 블록)
+// 각 블록은 blockSize 바이트(마지막 블록은 나머지)를 channelLayout대로 변환한 뒤 독립적으로 압축한 것
+// XOR 모드는 현재 ^ 이전 프레임을, 사전 모드는 이전 프레임의 같은 블록을 사전으로 현재 프레임을 압축
+struct XorFrameHeader {
+	uint32_t rawSize;
+	uint32_t blockSize;
+	uint32_t blockCount;
+	uint16_t channelLayout;
+	uint16_t flags; // FRAME_FLAG_*
+};
+#pragma pack(pop)
+
+// 블록 단위로 XOR 후 즉시 LZ4 압축 (전체 크기 diff 버퍼를 만들지 않음)
+// pool이 있으면 연속된 블록을 가로 밴드로 묶어 병렬 처리 (출력 형식은 동일)
+// 압축에 실패하면 false (compressedData는 쓸 수 없음). 세 압축 함수 모두 같음
+bool compressFrame(const uint8_t* currentFrame, const uint8_t* previousFrame, size_t frameSize, int acceleration, ByteBuffer& compressedData, ThreadPool* pool = nullptr, int channelLayout = CHANNEL_BGRA, uint32_t frameFlags = 0);
+
+// 수신 측: previousFrame과 XOR해 frame 복원. previousFrame == frame 이어도 됨 (FRAME_FLAG_ZERO_BASE면 읽지 않음)
+// 알파를 뺀 배치면 알파는 0xFF로 채움 (모든 모드 동일)
+bool decompressFrame(const uint8_t* compressedData, size_t compressedSize, const uint8_t* previousFrame, uint8_t* frame, size_t frameSize);
+
+// 블록마다 이전 프레임의 같은 위치 블록을 LZ4 사전으로 사용해 현재 프레임을 그대로 압축
+// XOR 없이도 반복되는 내용은 사전 일치로, 이동한 내용은 블록 내부 일치로 잡힘
+bool compressFrameWithDict(const uint8_t* currentFrame, const uint8_t* previousFrame, size_t frameSize, int acceleration, ByteBuffer& compressedData, ThreadPool* pool = nullptr, int channelLayout = CHANNEL_BGRA, uint32_t frameFlags = 0);
+
+// 수신 측: previousFrame의 같은 블록을 사전으로 풀어 frame에 씀. previousFrame == frame 이어도 됨 (FRAME_FLAG_ZERO_BASE면 읽지 않음)
+// 알파를 뺀 배치면 알파는 0xFF로 채움 (모든 모드 동일)
+bool decompressFrameWithDict(const uint8_t* compressedData, size_t compressedSize, const uint8_t* previousFrame, uint8_t* frame, size_t frameSize);
+
+// 타일 페이로드 생성: TileFrameHeader | 비트맵 | 타일 픽셀 LZ4 블록들
+bool compressTiles(const TileGrid& grid, const ByteBuffer& dirtyBitmap, int dirtyTileCount, const ByteBuffer& tilePixels, int acceleration, ByteBuffer& compressedData, ThreadPool* pool = nullptr, int channelLayout = CHANNEL_BGRA, uint32_t frameFlags = 0);
+
+// 수신 측: 변경된 타일을 frame(width * height * 4)에 덮어씀 (FRAME_FLAG_ZERO_BASE면 먼저 frame을 0으로)
+bool decompressTiles(const uint8_t* compressedData, size_t compressedSize, uint8_t* frame, int frameWidth, int frameHeight);
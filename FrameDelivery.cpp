@@ -0,0 +1,206 @@
+#include "FrameDelivery.h"
+
+#include <algorithm>
+
+bool FrameDelivery::start(size_t windowSize, int backpressurePolicy) {
+	// 전달 작업 안에서는 아직 돌고 있는 자기 쓰레드를 바꿀 수 없음
+	if (isDeliveryThread()) {
+		return false;
+	}
+	stop();
+
+	std::lock_guard<std::mutex> lock(deliveryMutex);
+	window = (std::max)(windowSize, static_cast<size_t>(1));
+	policy = backpressurePolicy;
+	slots.clear();
+	slots.resize(policy == BACKPRESSURE_DROP_OLDEST ? window * 2 : window);
+	nextReserve = 0;
+	nextDeliver = 0;
+	droppedPending = 0;
+	delivering = false;
+	stopping = false;
+	abandoning = false;
+	running = true;
+	stats = DeliveryCounters();
+	deliveryThread = std::thread(&FrameDelivery::deliveryLoop, this);
+	return true;
+}
+
+void FrameDelivery::stop() {
+	bool fromDeliveryThread = isDeliveryThread();
+	{
+		std::lock_guard<std::mutex> lock(deliveryMutex);
+		if (!running) {
+			return;
+		}
+		stopping = true;
+		if (fromDeliveryThread) {
+			abandoning = true;
+		}
+	}
+	readyCondition.notify_all();
+	windowCondition.notify_all();
+	if (fromDeliveryThread) {
+		// join은 다음 start()/stop()에서 (작업이 돌아오면 루프가 남은 순번을 버리고 끝남)
+		return;
+	}
+	deliveryThread.join();
+
+	std::lock_guard<std::mutex> lock(deliveryMutex);
+	running = false;
+}
+
+bool FrameDelivery::reserve(uint64_t& sequence) {
+	std::unique_lock<std::mutex> lock(deliveryMutex);
+	if (!running || stopping) {
+		return false;
+	}
+
+	if (occupied() >= window) {
+		switch (policy) {
+		case BACKPRESSURE_DROP_NEWEST:
+			stats.droppedFrames++;
+			return false;
+		case BACKPRESSURE_COALESCE:
+			stats.coalescedFrames++;
+			return false;
+		case BACKPRESSURE_DROP_OLDEST:
+			// 콜백 중인 프레임만 남았으면 버릴 수 없으므로 아래에서 대기
+			dropOldest();
+			break;
+		}
+	}
+
+	auto hasSlot = [this] { return occupied() < window && nextReserve - nextDeliver < slots.size(); };
+	if (!hasSlot()) {
+		auto stallStart = std::chrono::steady_clock::now();
+		windowCondition.wait(lock, [this, &hasSlot] { return stopping || hasSlot(); });
+		stats.windowStalls++;
+		stats.totalStallMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - stallStart).count();
+		if (stopping) {
+			return false;
+		}
+	}
+
+	sequence = nextReserve++;
+	return true;
+}
+
+bool FrameDelivery::hasRoom() {
+	std::lock_guard<std::mutex> lock(deliveryMutex);
+	return running && !stopping && occupied() < window;
+}
+
+bool FrameDelivery::dropOldest() {
+	// 콜백이 이미 시작된 프레임은 건너뜀
+	for (uint64_t sequence = nextDeliver + (delivering ? 1 : 0); sequence < nextReserve; ++sequence) {
+		Slot& slot = slots[sequence % slots.size()];
+		if (slot.dropped) {
+			continue;
+		}
+		slot.dropped = true;
+		droppedPending++;
+		stats.droppedFrames++;
+		// 인코딩이 끝나 기다리던 프레임이면 버퍼를 바로 돌려줌
+		slot.deliver.reset();
+		readyCondition.notify_one();
+		return true;
+	}
+	return false;
+}
+
+void FrameDelivery::complete(uint64_t sequence, Task deliver) {
+	// 잠금 안에서 알림: 마지막 프레임이면 알림 직후 stop()이 끝날 수 있음
+	std::lock_guard<std::mutex> lock(deliveryMutex);
+	if (abandoning) {
+		// 전달 작업 안에서 멈춘 뒤 끝난 프레임은 버림
+		deliver.reset();
+		return;
+	}
+	Slot& slot = slots[sequence % slots.size()];
+	if (slot.dropped) {
+		deliver.reset();
+	}
+	else {
+		slot.deliver = std::move(deliver);
+		if (sequence != nextDeliver) {
+			stats.reorderedFrames++;
+		}
+	}
+	slot.ready = true;
+	slot.readyTime = std::chrono::steady_clock::now();
+	readyCondition.notify_one();
+}
+
+DeliveryCounters FrameDelivery::counters() {
+	std::lock_guard<std::mutex> lock(deliveryMutex);
+	return stats;
+}
+
+void FrameDelivery::deliveryLoop() {
+	std::unique_lock<std::mutex> lock(deliveryMutex);
+	while (true) {
+		// 멈출 때도 이미 예약된 프레임은 인코딩이 끝나길 기다려 모두 전달
+		readyCondition.wait(lock, [this] {
+			return slots[nextDeliver % slots.size()].ready || (stopping && nextDeliver == nextReserve) || abandoning;
+			});
+		if (abandoning) {
+			// 전달 작업 안에서 멈춤: 출력이 이미 닫혔을 수 있으므로 남은 작업은 실행하지 않고 버퍼만 돌려줌
+			for (Slot& slot : slots) {
+				slot.deliver.reset();
+				slot.ready = false;
+				slot.dropped = false;
+			}
+			nextDeliver = nextReserve;
+			droppedPending = 0;
+			windowCondition.notify_all();
+			return;
+		}
+		Slot& slot = slots[nextDeliver % slots.size()];
+		if (!slot.ready) {
+			return;
+		}
+
+		Task deliver = std::move(slot.deliver);
+		slot.ready = false;
+		if (slot.dropped) {
+			// 버린 프레임은 순번만 넘김
+			slot.dropped = false;
+			droppedPending--;
+			nextDeliver++;
+			windowCondition.notify_all();
+			continue;
+		}
+
+		double waitMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - slot.readyTime).count();
+		stats.totalWaitMs += waitMs;
+		stats.maxWaitMs = (std::max)(stats.maxWaitMs, waitMs);
+
+		// 콜백은 잠금 밖에서 (콜백이 느려도 워커의 complete는 막히지 않음)
+		bool hasFrame = static_cast<bool>(deliver);
+		bool failed = false;
+		delivering = true;
+		lock.unlock();
+		if (hasFrame) {
+			// 작업의 예외로 전달 쓰레드가 끝나면 뒤 순번과 stop()이 멈추므로 이 프레임만 실패로 셈
+			try {
+				deliver();
+			}
+			catch (...) {
+				failed = true;
+			}
+			deliver.reset();
+		}
+		lock.lock();
+		delivering = false;
+
+		if (failed) {
+			stats.failedDeliveries++;
+		}
+		else if (hasFrame) {
+			stats.deliveredFrames++;
+		}
+		nextDeliver++;
+		windowCondition.notify_all();
+	}
+}
@@ -0,0 +1,104 @@
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "CaptureDLL.h"
+#include "TaskQueue.h"
+
+// 전달 단계 누적 통계
+struct DeliveryCounters {
+	long long deliveredFrames = 0;
+	long long reorderedFrames = 0;  // 앞 프레임보다 먼저 인코딩이 끝나 기다린 프레임
+	double totalWaitMs = 0;         // 인코딩이 끝난 뒤 전달될 때까지 기다린 시간
+	double maxWaitMs = 0;
+	long long windowStalls = 0;     // 창이 가득 차 캡처 쓰레드가 멈춘 횟수
+	double totalStallMs = 0;
+	long long droppedFrames = 0;    // BACKPRESSURE_DROP_OLDEST로 버린 프레임 + BACKPRESSURE_DROP_NEWEST로 받지 않은 프레임
+	long long coalescedFrames = 0;  // BACKPRESSURE_COALESCE로 받지 않은 프레임
+	long long failedDeliveries = 0; // 전달 작업이 예외로 끝난 프레임
+};
+
+// 워커들이 병렬로 인코딩한 프레임을 캡처 순서대로 한 쓰레드에서 전달
+// 캡처 쓰레드가 순번을 예약하고, 워커는 끝난 순번의 전달 작업을 넘김
+class FrameDelivery {
+public:
+	// window: 예약됐지만 아직 전달되지 않은 프레임의 최대 수
+	// policy: 창이 가득 찼을 때 동작 (BackpressurePolicy)
+	// 전달 작업 안에서는 시작할 수 없음 (false)
+	bool start(size_t window, int policy);
+	// 예약된 프레임을 모두 전달한 뒤 전달 쓰레드를 끝냄
+	// 전달 작업 안에서 부르면 자기 쓰레드를 기다릴 수 없으므로 멈춤 표시만 하고 바로 반환
+	// 남은 프레임은 전달하지 않고 버리며, 쓰레드는 작업이 돌아온 뒤 끝나고 다음 start()/stop()에서 정리
+	void stop();
+	// 지금 쓰레드가 전달 쓰레드인지 (전달 작업 안에서 호출 중)
+	bool isDeliveryThread() const { return std::this_thread::get_id() == deliveryThread.get_id(); }
+
+	// 캡처 쓰레드: 다음 순번. 창이 가득 차면 정책에 따라
+	// BLOCK은 가장 오래된 프레임이 전달될 때까지 대기, DROP_OLDEST는 가장 오래된 미전달 프레임을 버림,
+	// DROP_NEWEST/COALESCE는 바로 false (이 프레임은 인코딩하지 않음). 멈춘 뒤에도 false
+	bool reserve(uint64_t& sequence);
+	// 지금 reserve하면 창에 자리가 있는지
+	bool hasRoom();
+	// 워커: 인코딩이 끝난 프레임. deliver가 비어 있으면 순번만 넘김
+	void complete(uint64_t sequence, Task deliver);
+
+	DeliveryCounters counters();
+
+private:
+	struct Slot {
+		Task deliver;
+		bool ready = false;
+		bool dropped = false; // 전달하지 않고 넘김 (인코딩이 끝나면 버림)
+		std::chrono::steady_clock::time_point readyTime;
+	};
+
+	void deliveryLoop();
+	size_t occupied() const { return static_cast<size_t>(nextReserve - nextDeliver) - droppedPending; }
+	bool dropOldest();
+
+	std::mutex deliveryMutex;
+	std::condition_variable readyCondition;  // 전달 쓰레드: 다음 순번이 준비됨
+	std::condition_variable windowCondition; // 캡처 쓰레드: 창에 자리가 남
+	// 순번 % slots.size(). DROP_OLDEST는 버린 프레임이 인코딩을 마칠 때까지 칸을 잡고 있으므로 창의 두 배
+	std::vector<Slot> slots;
+	size_t window = 1;
+	int policy = BACKPRESSURE_BLOCK;
+	uint64_t nextReserve = 0;
+	uint64_t nextDeliver = 0;
+	size_t droppedPending = 0; // 버렸지만 아직 순번이 지나가지 않은 프레임
+	bool delivering = false;   // nextDeliver 프레임의 콜백 실행 중
+	bool running = false;
+	bool stopping = false;
+	bool abandoning = false;   // 전달 작업 안에서 멈춤: 남은 프레임은 전달하지 않음
+	std::thread deliveryThread;
+	DeliveryCounters stats;
+};
+
+// 예약한 순번 하나의 완료를 보장. complete() 전에 예외 등으로 빠져나가면 소멸자가 빈 작업으로 완료
+// (완료되지 않은 순번이 있으면 전달 쓰레드와 stop()이 그 순번을 영원히 기다림)
+class FrameCompletion {
+public:
+	FrameCompletion(FrameDelivery& delivery, uint64_t sequence) : delivery(delivery), sequence(sequence) {}
+	~FrameCompletion() {
+		if (!completed) {
+			delivery.complete(sequence, Task());
+		}
+	}
+
+	FrameCompletion(const FrameCompletion&) = delete;
+	FrameCompletion& operator=(const FrameCompletion&) = delete;
+
+	void complete(Task deliver) {
+		completed = true;
+		delivery.complete(sequence, std::move(deliver));
+	}
+
+private:
+	FrameDelivery& delivery;
+	uint64_t sequence;
+	bool completed = false;
+};
@@ -0,0 +1,127 @@
+#include "FrameDiff.h"
+#include "CpuFeatures.h"
+
+#include <immintrin.h>
+
+void calculateDiffScalar(const uint8_t* currentFrame, const uint8_t* previousFrame, uint8_t* diffBuffer, size_t frameSize) {
+	for (size_t i = 0; i < frameSize; ++i) {
+		diffBuffer[i] = currentFrame[i] ^ previousFrame[i];
+	}
+}
+
+void calculateDiffSSE2(const uint8_t* currentFrame, const uint8_t* previousFrame, uint8_t* diffBuffer, size_t frameSize) {
+	size_t i = 0;
+
+	for (; i + 16 <= frameSize; i += 16) { // 16바이트씩 처리
+		__m128i curr = _mm_loadu_si128(reinterpret_cast<const __m128i*>(currentFrame + i));
+		__m128i prev = _mm_loadu_si128(reinterpret_cast<const __m128i*>(previousFrame + i));
+		__m128i diff = _mm_xor_si128(curr, prev);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(diffBuffer + i), diff);
+	}
+
+	// 남은 부분 처리 (16바이트 단위 미만)
+	for (; i < frameSize; ++i) {
+		diffBuffer[i] = currentFrame[i] ^ previousFrame[i];
+	}
+}
+
+TARGET_AVX2
+void calculateDiffAVX2(const uint8_t* currentFrame, const uint8_t* previousFrame, uint8_t* diffBuffer, size_t frameSize) {
+	size_t i = 0;
+
+	// 64바이트(캐시 라인)씩 처리해 로드/스토어 포트를 계속 채움
+	for (; i + 64 <= frameSize; i += 64) {
+		__m256i curr0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(currentFrame + i));
+		__m256i curr1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(currentFrame + i + 32));
+		__m256i prev0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(previousFrame + i));
+		__m256i prev1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(previousFrame + i + 32));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(diffBuffer + i), _mm256_xor_si256(curr0, prev0));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(diffBuffer + i + 32), _mm256_xor_si256(curr1, prev1));
+	}
+
+	for (; i + 32 <= frameSize; i += 32) {
+		__m256i curr = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(currentFrame + i));
+		__m256i prev = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(previousFrame + i));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(diffBuffer + i), _mm256_xor_si256(curr, prev));
+	}
+	_mm256_zeroupper();
+
+	// 남은 부분 처리 (32바이트 단위 미만)
+	for (; i < frameSize; ++i) {
+		diffBuffer[i] = currentFrame[i] ^ previousFrame[i];
+	}
+}
+
+TARGET_AVX512BW
+void calculateDiffAVX512(const uint8_t* currentFrame, const uint8_t* previousFrame, uint8_t* diffBuffer, size_t frameSize) {
+	size_t i = 0;
+
+	for (; i + 128 <= frameSize; i += 128) {
+		__m512i curr0 = _mm512_loadu_si512(currentFrame + i);
+		__m512i curr1 = _mm512_loadu_si512(currentFrame + i + 64);
+		__m512i prev0 = _mm512_loadu_si512(previousFrame + i);
+		__m512i prev1 = _mm512_loadu_si512(previousFrame + i + 64);
+		_mm512_storeu_si512(diffBuffer + i, _mm512_xor_si512(curr0, prev0));
+		_mm512_storeu_si512(diffBuffer + i + 64, _mm512_xor_si512(curr1, prev1));
+	}
+
+	for (; i + 64 <= frameSize; i += 64) {
+		__m512i curr = _mm512_loadu_si512(currentFrame + i);
+		__m512i prev = _mm512_loadu_si512(previousFrame + i);
+		_mm512_storeu_si512(diffBuffer + i, _mm512_xor_si512(curr, prev));
+	}
+
+	// 남은 부분은 바이트 마스크로 한 번에 처리
+	if (i < frameSize) {
+		__mmask64 mask = (1ULL << (frameSize - i)) - 1;
+		__m512i curr = _mm512_maskz_loadu_epi8(mask, currentFrame + i);
+		__m512i prev = _mm512_maskz_loadu_epi8(mask, previousFrame + i);
+		_mm512_mask_storeu_epi8(diffBuffer + i, mask, _mm512_xor_si512(curr, prev));
+	}
+	_mm256_zeroupper();
+}
+
+DiffKernel getDiffKernel(DiffKernelType type) {
+	const CpuFeatures& cpu = getCpuFeatures();
+	switch (type) {
+	case DiffKernelType::Scalar:
+		return calculateDiffScalar;
+	case DiffKernelType::SSE2:
+		return cpu.sse2 ? calculateDiffSSE2 : nullptr;
+	case DiffKernelType::AVX2:
+		return cpu.avx2 ? calculateDiffAVX2 : nullptr;
+	case DiffKernelType::AVX512BW:
+		return cpu.avx512bw ? calculateDiffAVX512 : nullptr;
+	}
+	return nullptr;
+}
+
+const char* getDiffKernelName(DiffKernelType type) {
+	switch (type) {
+	case DiffKernelType::Scalar: return "Scalar";
+	case DiffKernelType::SSE2: return "SSE2";
+	case DiffKernelType::AVX2: return "AVX2";
+	case DiffKernelType::AVX512BW: return "AVX512BW";
+	}
+	return "Unknown";
+}
+
+static DiffKernelType selectDiffKernel() {
+	const CpuFeatures& cpu = getCpuFeatures();
+	if (cpu.avx512bw) return DiffKernelType::AVX512BW;
+	if (cpu.avx2) return DiffKernelType::AVX2;
+	if (cpu.sse2) return DiffKernelType::SSE2;
+	return DiffKernelType::Scalar;
+}
+
+// DLL 로드 시 한 번만 선택
+static const DiffKernelType activeDiffKernelType = selectDiffKernel();
+static const DiffKernel activeDiffKernel = getDiffKernel(activeDiffKernelType);
+
+DiffKernelType getActiveDiffKernel() {
+	return activeDiffKernelType;
+}
+
+void calculateDiffSIMD(const uint8_t* currentFrame, const uint8_t* previousFrame, uint8_t* diffBuffer, size_t frameSize) {
+	activeDiffKernel(currentFrame, previousFrame, diffBuffer, frameSize);
+}
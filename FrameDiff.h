@@ -0,0 +1,29 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// 프레임 XOR 차이 계산 커널 (diffBuffer = currentFrame ^ previousFrame)
+typedef void (*DiffKernel)(const uint8_t* currentFrame, const uint8_t* previousFrame, uint8_t* diffBuffer, size_t frameSize);
+
+enum class DiffKernelType {
+	Scalar,
+	SSE2,
+	AVX2,
+	AVX512BW,
+};
+
+// 개별 커널 (Scalar는 정확성 비교용 기준 구현)
+void calculateDiffScalar(const uint8_t* currentFrame, const uint8_t* previousFrame, uint8_t* diffBuffer, size_t frameSize);
+void calculateDiffSSE2(const uint8_t* currentFrame, const uint8_t* previousFrame, uint8_t* diffBuffer, size_t frameSize);
+void calculateDiffAVX2(const uint8_t* currentFrame, const uint8_t* previousFrame, uint8_t* diffBuffer, size_t frameSize);
+void calculateDiffAVX512(const uint8_t* currentFrame, const uint8_t* previousFrame, uint8_t* diffBuffer, size_t frameSize);
+
+// CPU가 지원하지 않는 타입이면 nullptr 반환
+DiffKernel getDiffKernel(DiffKernelType type);
+const char* getDiffKernelName(DiffKernelType type);
+
+// 시작 시 CPUID로 선택된 커널 타입
+DiffKernelType getActiveDiffKernel();
+
+// 선택된 커널로 프레임 차이 계산
+void calculateDiffSIMD(const uint8_t* currentFrame, const uint8_t* previousFrame, uint8_t* diffBuffer, size_t frameSize);
@@ -0,0 +1,141 @@
+#include "FramePacer.h"
+
+#include <algorithm>
+#include <thread>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <ctime>
+#include <cerrno>
+#endif
+
+#if defined(_WIN32) && !defined(CREATE_WAITABLE_TIMER_HIGH_RESOLUTION)
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+
+// 타이머가 늦게 깨는 만큼을 spin으로 메움
+// 고해상도 타이머 / clock_nanosleep은 수십~수백 us, 일반 waitable timer는 타이머 해상도(기본 15.6ms, timeBeginPeriod(1)이면 1ms) 단위
+static const auto PRECISE_SPIN_MARGIN = std::chrono::microseconds(500);
+static const auto COARSE_SPIN_MARGIN = std::chrono::microseconds(2000);
+// wakeEarly를 확인하는 간격
+static const auto WAKE_POLL_INTERVAL = std::chrono::microseconds(1000);
+
+static const double HISTOGRAM_LIMITS_MS[PACER_HISTOGRAM_BUCKETS - 1] = { 0.05, 0.1, 0.25, 0.5, 1, 2, 5 };
+
+FramePacer::FramePacer() : spinMargin(PRECISE_SPIN_MARGIN) {
+#if defined(_WIN32)
+	// Windows 10 1803 이상. 없으면 일반 타이머에 spin 구간을 늘림
+	timer = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+	if (!timer) {
+		timer = CreateWaitableTimerExW(nullptr, nullptr, 0, TIMER_ALL_ACCESS);
+		spinMargin = COARSE_SPIN_MARGIN;
+	}
+#endif
+}
+
+FramePacer::~FramePacer() {
+#if defined(_WIN32)
+	if (timer) {
+		CloseHandle(timer);
+	}
+#endif
+}
+
+void FramePacer::reset(double intervalMs) {
+	interval = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::milli>(intervalMs));
+	deadline = Clock::now() + interval;
+
+	std::lock_guard<std::mutex> lock(statsMutex);
+	stats = PacerCounters();
+}
+
+void FramePacer::setInterval(double intervalMs) {
+	interval = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::milli>(intervalMs));
+}
+
+bool FramePacer::wait(const std::function<bool()>& wakeEarly) {
+	if (interval.count() <= 0) {
+		return true;
+	}
+
+	while (true) {
+		Clock::time_point now = Clock::now();
+		if (wakeEarly && wakeEarly()) {
+			return false;
+		}
+		if (now >= deadline - spinMargin) {
+			break;
+		}
+		Clock::time_point wakeTime = deadline - spinMargin;
+		if (wakeEarly) {
+			wakeTime = (std::min)(wakeTime, now + WAKE_POLL_INTERVAL);
+		}
+		sleepUntil(wakeTime);
+	}
+
+	// 마지막 구간은 spin
+	Clock::time_point now = Clock::now();
+	while (now < deadline) {
+		std::this_thread::yield();
+		now = Clock::now();
+	}
+	record(deadline, now);
+
+	// 절대 시각 기준으로 다음 목표를 잡아 오차가 쌓이지 않게 함
+	// 한 간격 이상 늦었으면 놓친 시각은 건너뜀 (밀린 프레임을 몰아서 찍지 않음)
+	deadline += interval;
+	if (now >= deadline) {
+		auto missed = (now - deadline) / interval + 1;
+		deadline += interval * missed;
+		std::lock_guard<std::mutex> lock(statsMutex);
+		stats.missedDeadlines += missed;
+	}
+	return true;
+}
+
+void FramePacer::sleepUntil(Clock::time_point wakeTime) {
+#if defined(_WIN32)
+	auto remaining = std::chrono::duration_cast<std::chrono::nanoseconds>(wakeTime - Clock::now());
+	if (remaining.count() <= 0) {
+		return;
+	}
+	if (timer) {
+		// 음수 = 상대 시간 (100ns 단위)
+		LARGE_INTEGER dueTime;
+		dueTime.QuadPart = -static_cast<LONGLONG>(remaining.count() / 100);
+		if (SetWaitableTimer(timer, &dueTime, 0, nullptr, nullptr, FALSE)) {
+			WaitForSingleObject(timer, INFINITE);
+			return;
+		}
+	}
+	std::this_thread::sleep_until(wakeTime);
+#else
+	// steady_clock은 CLOCK_MONOTONIC 기반
+	auto sinceEpoch = std::chrono::duration_cast<std::chrono::nanoseconds>(wakeTime.time_since_epoch()).count();
+	timespec target;
+	target.tv_sec = static_cast<time_t>(sinceEpoch / 1000000000);
+	target.tv_nsec = static_cast<long>(sinceEpoch % 1000000000);
+	while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &target, nullptr) == EINTR) {
+	}
+#endif
+}
+
+void FramePacer::record(Clock::time_point target, Clock::time_point now) {
+	double latenessMs = std::chrono::duration<double, std::milli>(now - target).count();
+	int bucket = 0;
+	while (bucket < PACER_HISTOGRAM_BUCKETS - 1 && latenessMs >= HISTOGRAM_LIMITS_MS[bucket]) {
+		bucket++;
+	}
+
+	std::lock_guard<std::mutex> lock(statsMutex);
+	stats.frames++;
+	stats.totalLatenessMs += latenessMs;
+	stats.maxLatenessMs = (std::max)(stats.maxLatenessMs, latenessMs);
+	stats.latenessHistogram[bucket]++;
+}
+
+PacerCounters FramePacer::counters() {
+	std::lock_guard<std::mutex> lock(statsMutex);
+	return stats;
+}
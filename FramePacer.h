@@ -0,0 +1,49 @@
+#pragma once
+#include <chrono>
+#include <functional>
+#include <mutex>
+
+// 지각 히스토그램 구간 수 (상한: 50us, 100us, 250us, 500us, 1ms, 2ms, 5ms, 그 이상)
+const int PACER_HISTOGRAM_BUCKETS = 8;
+
+// 프레임 시각 누적 통계
+struct PacerCounters {
+	long long frames = 0;
+	long long missedDeadlines = 0; // 한 프레임 이상 늦어 건너뛴 시각
+	double totalLatenessMs = 0;    // 깨어난 시각 - 목표 시각
+	double maxLatenessMs = 0;
+	long long latenessHistogram[PACER_HISTOGRAM_BUCKETS] = {};
+};
+
+// 절대 목표 시각에 맞춰 프레임 간격을 유지
+// 목표 직전까지는 OS 타이머로 자고 (Windows: 고해상도 waitable timer, 그 외: clock_nanosleep) 마지막 구간만 spin
+class FramePacer {
+public:
+	FramePacer();
+	~FramePacer();
+
+	// 다음 목표 시각을 지금 + intervalMs로 다시 잡음
+	void reset(double intervalMs);
+	// 이미 잡힌 다음 목표 시각은 그대로 두고 그 뒤부터 간격을 바꿈 (통계 유지)
+	void setInterval(double intervalMs);
+
+	// 다음 목표 시각까지 대기한 뒤 목표를 한 간격 뒤로 옮김
+	// wakeEarly가 있으면 자는 동안 주기적으로 확인해 true면 바로 반환 (목표 시각은 그대로, 반환값 false)
+	bool wait(const std::function<bool()>& wakeEarly = nullptr);
+
+	PacerCounters counters();
+
+private:
+	using Clock = std::chrono::steady_clock;
+
+	void sleepUntil(Clock::time_point wakeTime);
+	void record(Clock::time_point deadline, Clock::time_point now);
+
+	Clock::duration interval{};
+	Clock::time_point deadline;
+	Clock::duration spinMargin;
+	void* timer = nullptr; // Windows waitable timer
+
+	std::mutex statsMutex;
+	PacerCounters stats;
+};
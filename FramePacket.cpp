@@ -0,0 +1,323 @@
+#include "FramePacket.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <random>
+
+#include "FrameDiff.h"
+#include "Log.h"
+
+// 순번 비교 (32비트 순번이 넘어가도 동작)
+static bool sequenceBefore(uint32_t a, uint32_t b) {
+	return static_cast<int32_t>(a - b) < 0;
+}
+
+void FramePacketizer::reset(size_t size) {
+	packetSize = (std::max)(size, sizeof(FramePacketHeader) + 1);
+	frameSequence = 0;
+	// 직전 세션과 다른 번호. 받는 쪽은 번호가 바뀌면 다시 시작한 것으로 봄
+	uint16_t previous = session;
+	std::random_device random;
+	do {
+		session = static_cast<uint16_t>(random());
+	} while (session == previous);
+}
+
+void FramePacketizer::setParityGroupSize(size_t size) {
+	groupSize = (std::min)(size, static_cast<size_t>(255));
+}
+
+size_t FramePacketizer::packetize(const FrameData& frameData) {
+	size_t payloadSize = packetSize - sizeof(FramePacketHeader);
+	size_t frameSize = static_cast<size_t>((std::max)(frameData.dataSize, 0));
+	size_t count = (std::max)(static_cast<size_t>(1), (frameSize + payloadSize - 1) / payloadSize);
+	if (count > 0xFFFF) {
+		return 0;
+	}
+	size_t groups = groupSize > 0 ? (count + groupSize - 1) / groupSize : 0;
+
+	packets.resize((count + groups) * packetSize);
+	sizes.resize(count + groups);
+	parityCount = groups;
+	parityMs = 0;
+
+	FramePacketHeader header = {};
+	header.magic = FRAME_PACKET_MAGIC;
+	header.frameSequence = frameSequence++;
+	header.frameSize = static_cast<uint32_t>(frameSize);
+	header.timeStamp = frameData.timeStamp;
+	header.packetCount = static_cast<uint16_t>(count);
+	header.payloadSize = static_cast<uint16_t>(payloadSize);
+	header.width = static_cast<uint16_t>(frameData.width);
+	header.height = static_cast<uint16_t>(frameData.height);
+	header.frameRate = static_cast<uint16_t>(frameData.frameRate);
+	header.flags = static_cast<uint32_t>(groupSize) << FRAME_PACKET_GROUP_SHIFT | static_cast<uint32_t>(session) << FRAME_PACKET_SESSION_SHIFT;
+
+	// 그룹의 데이터 패킷들 뒤에 그 그룹의 패리티
+	size_t position = 0;
+	for (size_t first = 0; first < count; first += (groupSize > 0 ? groupSize : count)) {
+		size_t last = groupSize > 0 ? (std::min)(first + groupSize, count) : count;
+		for (size_t i = first; i < last; ++i) {
+			size_t offset = i * payloadSize;
+			size_t length = (std::min)(payloadSize, frameSize - offset);
+			header.packetIndex = static_cast<uint16_t>(i);
+			uint8_t* target = packet(position);
+			memcpy(target, &header, sizeof(header));
+			if (length > 0) {
+				memcpy(target + sizeof(header), frameData.data + offset, length);
+			}
+			sizes[position++] = static_cast<uint16_t>(sizeof(header) + length);
+		}
+		if (groupSize == 0) {
+			break;
+		}
+
+		auto parityStart = std::chrono::steady_clock::now();
+		FramePacketHeader parityHeader = header;
+		parityHeader.packetIndex = static_cast<uint16_t>(first / groupSize);
+		parityHeader.flags |= FRAME_PACKET_PARITY;
+		uint8_t* target = packet(position);
+		memcpy(target, &parityHeader, sizeof(parityHeader));
+		uint8_t* parity = target + sizeof(parityHeader);
+		size_t parityLength = (std::min)(payloadSize, frameSize - first * payloadSize);
+		memset(parity, 0, parityLength);
+		for (size_t i = first; i < last; ++i) {
+			size_t offset = i * payloadSize;
+			calculateDiffSIMD(parity, frameData.data + offset, parity, (std::min)(payloadSize, frameSize - offset));
+		}
+		sizes[position++] = static_cast<uint16_t>(sizeof(parityHeader) + parityLength);
+		parityMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - parityStart).count();
+	}
+	return count + groups;
+}
+
+void FramePacketizer::stamp(size_t index, uint32_t packetSequence, int64_t sendTimeUs) {
+	FramePacketHeader* header = reinterpret_cast<FramePacketHeader*>(packet(index));
+	header->packetSequence = packetSequence;
+	header->sendTimeUs = sendTimeUs;
+}
+
+void FrameReassembler::reset(std::function<void(const FrameData&)> callback) {
+	frameCallback = std::move(callback);
+	for (Slot& slot : slots) {
+		slot.active = false;
+	}
+	started = false;
+	delivered = false;
+
+	std::lock_guard<std::mutex> lock(statsMutex);
+	stats = ReassemblyCounters();
+}
+
+void FrameReassembler::receive(const uint8_t* packet, size_t size) {
+	FramePacketHeader header;
+	if (size < sizeof(header)) {
+		std::lock_guard<std::mutex> lock(statsMutex);
+		stats.invalidPackets++;
+		return;
+	}
+	memcpy(&header, packet, sizeof(header));
+	size_t length = size - sizeof(header);
+	bool isParity = (header.flags & FRAME_PACKET_PARITY) != 0;
+	size_t groupSize = (header.flags >> FRAME_PACKET_GROUP_SHIFT) & 0xFF;
+	size_t groupCount = groupSize > 0 ? (header.packetCount + groupSize - 1) / groupSize : 0;
+	size_t offset = static_cast<size_t>(header.packetIndex) * header.payloadSize; // 데이터 패킷만
+	bool valid = header.magic == FRAME_PACKET_MAGIC && header.packetCount > 0 && length <= header.payloadSize;
+	if (valid && isParity) {
+		valid = header.packetIndex < groupCount;
+	}
+	else if (valid) {
+		valid = header.packetIndex < header.packetCount && offset + length <= header.frameSize
+			&& (header.packetIndex + 1 == header.packetCount || length == header.payloadSize);
+	}
+	if (!valid) {
+		std::lock_guard<std::mutex> lock(statsMutex);
+		stats.invalidPackets++;
+		return;
+	}
+
+	// 보내는 쪽이 다시 열렸으면 프레임/패킷 순번이 0부터 다시 시작하므로 모으던 프레임과 순번 기준을 버림
+	// 다시 시작한 뒤 늦게 도착한 이전 세션 패킷은 버림
+	uint16_t session = static_cast<uint16_t>(header.flags >> FRAME_PACKET_SESSION_SHIFT);
+	if (started && session != senderSession && session == previousSession) {
+		return;
+	}
+	if (started && session != senderSession) {
+		log("Frame stream restarted");
+		previousSession = senderSession;
+		for (Slot& slot : slots) {
+			slot.active = false;
+		}
+		started = false;
+		delivered = false;
+	}
+	senderSession = session;
+
+	int64_t receiveTimeUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+	{
+		std::lock_guard<std::mutex> lock(statsMutex);
+		stats.packetsReceived++;
+		stats.bytesReceived += size;
+		stats.totalTransitUs += receiveTimeUs - header.sendTimeUs;
+		if (isParity) {
+			stats.parityPacketsReceived++;
+		}
+		if (!started || !sequenceBefore(header.packetSequence, nextPacketSequence)) {
+			if (started) {
+				stats.packetsLost += header.packetSequence - nextPacketSequence;
+			}
+			nextPacketSequence = header.packetSequence + 1;
+			started = true;
+		}
+		else {
+			// 늦게 도착: 손실로 셌던 것을 되돌림
+			stats.packetsReordered++;
+			stats.packetsLost = (std::max)(0LL, stats.packetsLost - 1);
+		}
+	}
+
+	// 이미 전달했거나 건너뛴 프레임의 패킷
+	if (delivered && !sequenceBefore(lastFrameSequence, header.frameSequence)) {
+		return;
+	}
+
+	Slot& slot = slots[header.frameSequence % SLOT_COUNT];
+	if (!slot.active || slot.frameSequence != header.frameSequence) {
+		if (slot.active && sequenceBefore(header.frameSequence, slot.frameSequence)) {
+			return; // 이미 밀려난 오래된 프레임
+		}
+		slot.active = true;
+		slot.frameSequence = header.frameSequence;
+		slot.frameSize = header.frameSize;
+		slot.packetCount = header.packetCount;
+		slot.packetsReceived = 0;
+		slot.firstSendTimeUs = header.sendTimeUs;
+		slot.data.resize(header.frameSize);
+		slot.received.assign(header.packetCount, 0);
+		slot.payloadSize = header.payloadSize;
+		slot.groupSize = groupSize;
+		slot.groupReceived.assign(groupCount, 0);
+		slot.parityReceived.assign(groupCount, 0);
+		slot.parity.resize(groupCount * header.payloadSize);
+		slot.frameData.width = header.width;
+		slot.frameData.height = header.height;
+		slot.frameData.frameRate = header.frameRate;
+		slot.frameData.timeStamp = header.timeStamp;
+		slot.frameData.dataSize = static_cast<int>(header.frameSize);
+	}
+	if (slot.frameSize != header.frameSize || slot.packetCount != header.packetCount || slot.payloadSize != header.payloadSize || slot.groupSize != groupSize) {
+		return;
+	}
+	slot.firstSendTimeUs = (std::min)(slot.firstSendTimeUs, header.sendTimeUs);
+
+	size_t group;
+	if (isParity) {
+		group = header.packetIndex;
+		if (slot.parityReceived[group]) {
+			return; // 중복 패킷
+		}
+		// 짧은 패리티(마지막 그룹)는 나머지를 0으로
+		uint8_t* parity = slot.parity.data() + group * slot.payloadSize;
+		memcpy(parity, packet + sizeof(header), length);
+		memset(parity + length, 0, slot.payloadSize - length);
+		slot.parityReceived[group] = 1;
+	}
+	else {
+		if (slot.received[header.packetIndex]) {
+			return; // 중복 패킷
+		}
+		slot.received[header.packetIndex] = 1;
+		slot.packetsReceived++;
+		if (length > 0) {
+			memcpy(slot.data.data() + offset, packet + sizeof(header), length);
+		}
+		if (groupSize == 0) {
+			if (slot.packetsReceived == slot.packetCount) {
+				complete(slot);
+			}
+			return;
+		}
+		group = header.packetIndex / groupSize;
+		slot.groupReceived[group]++;
+	}
+
+	recover(slot, group);
+	if (slot.packetsReceived == slot.packetCount) {
+		complete(slot);
+	}
+}
+
+size_t FrameReassembler::packetLength(const Slot& slot, size_t index) const {
+	size_t offset = index * slot.payloadSize;
+	return (std::min)(static_cast<size_t>(slot.payloadSize), slot.frameSize - offset);
+}
+
+void FrameReassembler::recover(Slot& slot, size_t group) {
+	// 그룹에서 데이터 패킷 하나만 빠졌고 패리티가 있으면 나머지와 XOR해 복구
+	size_t first = group * slot.groupSize;
+	size_t last = (std::min)(first + slot.groupSize, static_cast<size_t>(slot.packetCount));
+	if (!slot.parityReceived[group] || static_cast<size_t>(slot.groupReceived[group]) + 1 != last - first) {
+		return;
+	}
+
+	auto recoveryStart = std::chrono::steady_clock::now();
+	size_t missing = first;
+	while (slot.received[missing]) {
+		missing++;
+	}
+	uint8_t* parity = slot.parity.data() + group * slot.payloadSize;
+	for (size_t i = first; i < last; ++i) {
+		if (i != missing) {
+			calculateDiffSIMD(parity, slot.data.data() + i * slot.payloadSize, parity, packetLength(slot, i));
+		}
+	}
+	size_t length = packetLength(slot, missing);
+	if (length > 0) {
+		memcpy(slot.data.data() + missing * slot.payloadSize, parity, length);
+	}
+	slot.received[missing] = 1;
+	slot.packetsReceived++;
+	slot.groupReceived[group]++;
+
+	std::lock_guard<std::mutex> lock(statsMutex);
+	stats.packetsRecovered++;
+	stats.totalRecoveryMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - recoveryStart).count();
+}
+
+void FrameReassembler::complete(Slot& slot) {
+	dropBefore(slot.frameSequence);
+
+	auto nowUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+	double latencyMs = (nowUs - slot.firstSendTimeUs) / 1000.0;
+	{
+		std::lock_guard<std::mutex> lock(statsMutex);
+		stats.framesReceived++;
+		if (delivered) {
+			stats.framesDropped += slot.frameSequence - lastFrameSequence - 1;
+		}
+		stats.totalLatencyMs += latencyMs;
+		stats.maxLatencyMs = (std::max)(stats.maxLatencyMs, latencyMs);
+	}
+
+	lastFrameSequence = slot.frameSequence;
+	delivered = true;
+	slot.active = false;
+	slot.frameData.data = slot.data.data();
+	if (frameCallback) {
+		frameCallback(slot.frameData);
+	}
+}
+
+void FrameReassembler::dropBefore(uint32_t frameSequence) {
+	for (Slot& slot : slots) {
+		if (slot.active && sequenceBefore(slot.frameSequence, frameSequence)) {
+			slot.active = false;
+		}
+	}
+}
+
+ReassemblyCounters FrameReassembler::counters() {
+	std::lock_guard<std::mutex> lock(statsMutex);
+	return stats;
+}
@@ -0,0 +1,133 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include "ByteBuffer.h"
+#include "CaptureDLL.h"
+
+// 네트워크로 보낼 때 프레임 하나를 MTU 크기 패킷으로 나눈 단위
+// 필드는 리틀 엔디언 그대로 (보내는 쪽과 받는 쪽 모두 x86/ARM 기준)
+const uint32_t FRAME_PACKET_MAGIC = 0x4B505343; // "CSPK"
+// flags 하위 8비트. 패리티 패킷은 packetIndex가 그룹 번호이고 데이터는 그룹 안 데이터 패킷들의 XOR (짧은 패킷은 0으로 채워 계산)
+const uint32_t FRAME_PACKET_PARITY = 1;
+// flags 8~15비트: 패리티 그룹 크기 (데이터 패킷 수, 0이면 패리티 없음). 모든 패킷에 같은 값
+const int FRAME_PACKET_GROUP_SHIFT = 8;
+// flags 16~31비트: 보내는 쪽 세션 번호. 보내는 쪽을 다시 열 때마다 바뀌어 받는 쪽이 순번을 처음부터 다시 셈
+const int FRAME_PACKET_SESSION_SHIFT = 16;
+
+struct FramePacketHeader {
+	uint32_t magic;
+	uint32_t frameSequence;  // 보낸 프레임 순번
+	uint32_t packetSequence; // 보낸 패킷 전체 순번 (손실/순서 측정)
+	uint32_t frameSize;      // 프레임 데이터 전체 바이트
+	int64_t timeStamp;       // FrameData.timeStamp
+	int64_t sendTimeUs;      // 패킷을 보낸 시각 (system_clock, us)
+	uint16_t packetIndex;    // 프레임 안의 패킷 번호. 데이터 위치 = packetIndex * payloadSize
+	uint16_t packetCount;    // 데이터 패킷 수 (패리티 제외)
+	uint16_t payloadSize;    // 마지막 패킷을 뺀 패킷당 데이터 바이트
+	uint16_t width;
+	uint16_t height;
+	uint16_t frameRate;
+	uint32_t flags;          // FRAME_PACKET_PARITY | 그룹 크기 << FRAME_PACKET_GROUP_SHIFT | 세션 << FRAME_PACKET_SESSION_SHIFT
+};
+static_assert(sizeof(FramePacketHeader) == 48, "FramePacketHeader layout");
+
+// 프레임 -> 패킷. 패킷은 packetSize 간격으로 보낼 순서대로 한 버퍼에 이어 붙임 (프레임마다 재사용)
+// 패리티를 켜면 데이터 패킷 groupSize개마다 바로 뒤에 패리티 패킷 하나 (그룹 안 한 패킷 손실 복구)
+class FramePacketizer {
+public:
+	// packetSize: 헤더를 포함한 UDP 페이로드 최대 크기. 프레임 순번을 0부터 다시 시작하고 세션 번호를 새로 정함
+	void reset(size_t packetSize);
+	// 0이면 패리티 없음. 최대 255
+	void setParityGroupSize(size_t groupSize);
+	size_t parityGroupSize() const { return groupSize; }
+
+	// frameSequence는 한 프레임마다 증가. 보낼 때 sendTimeUs와 packetSequence를 채움 (stamp)
+	// 반환값은 패리티를 포함한 패킷 수
+	size_t packetize(const FrameData& frameData);
+	size_t parityPacketCount() const { return parityCount; }
+	double parityTimeMs() const { return parityMs; } // 마지막 packetize에서 패리티 계산에 쓴 시간
+	size_t packetCount() const { return sizes.size(); }
+	uint8_t* packet(size_t index) { return packets.data() + index * packetSize; }
+	size_t size(size_t index) const { return sizes[index]; }
+	void stamp(size_t index, uint32_t packetSequence, int64_t sendTimeUs);
+
+private:
+	size_t packetSize = 1200;
+	size_t groupSize = 0;
+	size_t parityCount = 0;
+	double parityMs = 0;
+	uint32_t frameSequence = 0;
+	uint16_t session = 0;
+	ByteBuffer packets;
+	std::vector<uint16_t> sizes;
+};
+
+// 받는 쪽 누적 통계
+struct ReassemblyCounters {
+	long long packetsReceived = 0;
+	long long packetsLost = 0;      // packetSequence가 건너뛴 수 (늦게 오면 다시 뺌)
+	long long packetsReordered = 0; // 앞 순번보다 늦게 온 패킷
+	long long invalidPackets = 0;
+	long long framesReceived = 0;
+	long long framesDropped = 0;    // 전달한 프레임 순번 사이에 빠진 프레임 (패킷 손실로 다 모이지 못함)
+	double totalLatencyMs = 0;      // 첫 패킷을 보낸 시각 -> 프레임 완성 (같은 시계일 때만 의미 있음)
+	double maxLatencyMs = 0;
+	long long bytesReceived = 0;
+	long long parityPacketsReceived = 0;
+	long long packetsRecovered = 0; // 패리티로 복구한 데이터 패킷
+	double totalRecoveryMs = 0;     // 패리티 복구에 쓴 시간
+	long long totalTransitUs = 0;   // 패킷마다 보낸 시각 -> 받은 시각의 합 (시계 차이가 더해지므로 변화량만 의미 있음)
+};
+
+// 패킷 -> 프레임. 프레임은 순번 순서로만 전달하고, 완성된 프레임보다 앞선 미완성 프레임은 버림
+// receive는 한 쓰레드에서만 호출
+class FrameReassembler {
+public:
+	// 완성된 프레임. data는 콜백 안에서만 유효
+	void reset(std::function<void(const FrameData&)> frameCallback);
+	void receive(const uint8_t* packet, size_t size);
+
+	ReassemblyCounters counters();
+
+private:
+	// 동시에 모으는 프레임 수. 넘치면 가장 오래된 것을 버림
+	static const size_t SLOT_COUNT = 8;
+
+	struct Slot {
+		bool active = false;
+		uint32_t frameSequence = 0;
+		uint32_t frameSize = 0;
+		uint16_t packetCount = 0;
+		uint16_t packetsReceived = 0;
+		int64_t firstSendTimeUs = 0;
+		FrameData frameData{};
+		ByteBuffer data;
+		std::vector<uint8_t> received; // 패킷별 도착 여부
+		uint16_t payloadSize = 0;
+		size_t groupSize = 0;
+		std::vector<uint16_t> groupReceived; // 그룹별 받은 데이터 패킷 수
+		std::vector<uint8_t> parityReceived;
+		ByteBuffer parity;                   // 그룹별 패리티 (payloadSize 간격)
+	};
+
+	size_t packetLength(const Slot& slot, size_t index) const;
+	void recover(Slot& slot, size_t group);
+	void complete(Slot& slot);
+	void dropBefore(uint32_t frameSequence);
+
+	std::function<void(const FrameData&)> frameCallback;
+	Slot slots[SLOT_COUNT];
+	bool started = false;
+	uint16_t senderSession = 0;     // 지금 받는 보내는 쪽 세션 (started일 때만 의미 있음)
+	uint16_t previousSession = 0;   // 바로 전 세션. 다시 시작한 뒤 늦게 온 패킷을 버림
+	uint32_t nextPacketSequence = 0;
+	uint32_t lastFrameSequence = 0; // 마지막으로 전달한 프레임 (이보다 앞선 패킷은 버림)
+	bool delivered = false;
+
+	std::mutex statsMutex;
+	ReassemblyCounters stats;
+};
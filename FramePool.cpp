@@ -0,0 +1,93 @@
+#include "FramePool.h"
+#include "ByteBuffer.h"
+
+#include <new>
+
+struct FramePoolState {
+	std::mutex mutex;
+	std::vector<std::unique_ptr<FrameSlot>> slots;
+	std::vector<FrameSlot*> freeSlots;
+
+	~FramePoolState() {
+		for (auto& slot : slots) {
+			::operator delete(slot->data, std::align_val_t(FRAME_BUFFER_ALIGNMENT));
+		}
+	}
+};
+
+FrameLease::FrameLease(const FrameLease& other) : slot(other.slot) {
+	if (slot) {
+		slot->references.fetch_add(1, std::memory_order_relaxed);
+	}
+}
+
+FrameLease::FrameLease(FrameLease&& other) noexcept : slot(other.slot) {
+	other.slot = nullptr;
+}
+
+FrameLease& FrameLease::operator=(FrameLease other) noexcept {
+	std::swap(slot, other.slot);
+	return *this;
+}
+
+FrameLease::~FrameLease() {
+	reset();
+}
+
+void FrameLease::reset() {
+	if (!slot) {
+		return;
+	}
+	FrameSlot* released = slot;
+	slot = nullptr;
+	if (released->references.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+		return;
+	}
+
+	// 마지막 참조: 슬롯을 풀에 돌려놓음. state는 여기서 놓아야 풀이 reset된 뒤에도 안전하게 해제됨
+	std::shared_ptr<FramePoolState> state = std::move(released->state);
+	std::lock_guard<std::mutex> lock(state->mutex);
+	state->freeSlots.push_back(released);
+}
+
+void FramePool::reset(size_t frameSize, size_t slotCount) {
+	auto newState = std::make_shared<FramePoolState>();
+	newState->slots.reserve(slotCount);
+	newState->freeSlots.reserve(slotCount);
+	for (size_t i = 0; i < slotCount; ++i) {
+		auto slot = std::make_unique<FrameSlot>();
+		slot->data = static_cast<uint8_t*>(::operator new(frameSize, std::align_val_t(FRAME_BUFFER_ALIGNMENT)));
+		slot->size = frameSize;
+		countAllocation(frameSize);
+		newState->freeSlots.push_back(slot.get());
+		newState->slots.push_back(std::move(slot));
+	}
+	state = std::move(newState);
+}
+
+FrameLease FramePool::acquire() {
+	if (!state) {
+		return FrameLease();
+	}
+
+	FrameSlot* slot;
+	{
+		std::lock_guard<std::mutex> lock(state->mutex);
+		if (state->freeSlots.empty()) {
+			return FrameLease();
+		}
+		slot = state->freeSlots.back();
+		state->freeSlots.pop_back();
+	}
+	slot->state = state;
+	slot->references.store(1, std::memory_order_release);
+	return FrameLease(slot);
+}
+
+size_t FramePool::available() {
+	if (!state) {
+		return 0;
+	}
+	std::lock_guard<std::mutex> lock(state->mutex);
+	return state->freeSlots.size();
+}
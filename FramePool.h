@@ -0,0 +1,60 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// 프레임 버퍼 정렬 (AVX-512 한 줄 / 캐시 라인)
+const size_t FRAME_BUFFER_ALIGNMENT = 64;
+
+struct FramePoolState;
+
+// 풀 버퍼 하나. 임대 중에는 state를 들고 있어 풀이 reset되어도 반납될 때까지 살아있음
+struct FrameSlot {
+	uint8_t* data = nullptr;
+	size_t size = 0;
+	std::atomic<int> references{ 0 };
+	std::shared_ptr<FramePoolState> state;
+};
+
+// 풀 버퍼에 대한 참조. 복사하면 참조 수만 늘고(프레임 복사 없음) 마지막 참조가 사라지면 풀로 돌아감
+class FrameLease {
+public:
+	FrameLease() = default;
+	FrameLease(const FrameLease& other);
+	FrameLease(FrameLease&& other) noexcept;
+	FrameLease& operator=(FrameLease other) noexcept;
+	~FrameLease();
+
+	uint8_t* data() const { return slot ? slot->data : nullptr; }
+	size_t size() const { return slot ? slot->size : 0; }
+	explicit operator bool() const { return slot != nullptr; }
+
+	// 이 참조만 버퍼를 쓰고 있으면 true (제자리 수정 가능)
+	bool unique() const { return slot && slot->references.load(std::memory_order_acquire) == 1; }
+	void reset();
+
+private:
+	friend class FramePool;
+	explicit FrameLease(FrameSlot* slot) : slot(slot) {}
+
+	FrameSlot* slot = nullptr;
+};
+
+// 정렬된 고정 개수 프레임 버퍼 풀
+// 캡처는 빈 슬롯에 쓰고, 기준 프레임 교체는 FrameLease 대입(포인터 교체)으로 끝남
+class FramePool {
+public:
+	// frameSize 바이트 버퍼 slotCount개를 새로 할당. 기존에 임대된 버퍼는 반납될 때 해제됨
+	void reset(size_t frameSize, size_t slotCount);
+
+	// 빈 슬롯이 없으면 빈 FrameLease 반환 (소비자가 밀려 있음)
+	FrameLease acquire();
+
+	size_t available();
+
+private:
+	std::shared_ptr<FramePoolState> state;
+};
@@ -0,0 +1,462 @@
+#include "FrameScaler.h"
+#include "CpuFeatures.h"
+
+#include <algorithm>
+#include <cstring>
+#include <immintrin.h>
+
+// AREA 가중치는 2^14, BILINEAR 가중치는 2^6 고정소수점 (maddubs의 int8 가중치에 맞춤)
+static const int AREA_SHIFT = 14;
+static const int LINEAR_SHIFT = 6;
+static const int LINEAR_ONE = 1 << LINEAR_SHIFT;
+
+static const bool useAvx2 = getCpuFeatures().avx2;
+
+static inline uint8_t average(uint8_t a, uint8_t b) {
+	return static_cast<uint8_t>((a + b + 1) >> 1);
+}
+
+// 두 행의 2x2 평균 (_mm256_avg_epu8과 같은 반올림: 세로 평균 후 가로 평균)
+static void boxRowScalar(const uint8_t* rowA, const uint8_t* rowB, uint8_t* dst, int x0, int dstWidth) {
+	for (int x = x0; x < dstWidth; ++x) {
+		for (int channel = 0; channel < 4; ++channel) {
+			uint8_t left = average(rowA[x * 8 + channel], rowB[x * 8 + channel]);
+			uint8_t right = average(rowA[x * 8 + 4 + channel], rowB[x * 8 + 4 + channel]);
+			dst[x * 4 + channel] = average(left, right);
+		}
+	}
+}
+
+TARGET_AVX2
+static void boxRowAVX2(const uint8_t* rowA, const uint8_t* rowB, uint8_t* dst, int dstWidth) {
+	int x = 0;
+
+	// 원본 16픽셀 -> 출력 8픽셀
+	for (; x + 8 <= dstWidth; x += 8) {
+		__m256i v0 = _mm256_avg_epu8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(rowA + x * 8)), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rowB + x * 8)));
+		__m256i v1 = _mm256_avg_epu8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(rowA + x * 8 + 32)), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rowB + x * 8 + 32)));
+		// 짝수/홀수 픽셀 분리: (0, 2, 8, 10 | 4, 6, 12, 14), (1, 3, 9, 11 | 5, 7, 13, 15)
+		__m256i even = _mm256_castps_si256(_mm256_shuffle_ps(_mm256_castsi256_ps(v0), _mm256_castsi256_ps(v1), 0x88));
+		__m256i odd = _mm256_castps_si256(_mm256_shuffle_ps(_mm256_castsi256_ps(v0), _mm256_castsi256_ps(v1), 0xDD));
+		__m256i result = _mm256_permute4x64_epi64(_mm256_avg_epu8(even, odd), 0xD8);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + x * 4), result);
+	}
+	_mm256_zeroupper();
+
+	boxRowScalar(rowA, rowB, dst, x, dstWidth);
+}
+
+static void boxRow(const uint8_t* rowA, const uint8_t* rowB, uint8_t* dst, int dstWidth, bool avx2) {
+	if (avx2) {
+		boxRowAVX2(rowA, rowB, dst, dstWidth);
+	}
+	else {
+		boxRowScalar(rowA, rowB, dst, 0, dstWidth);
+	}
+}
+
+// 두 행을 세로로 섞음: (a * (64 - w) + b * w + 32) >> 6
+static void blendRowsScalar(const uint8_t* rowA, const uint8_t* rowB, uint8_t* dst, size_t x0, size_t size, int weight) {
+	for (size_t i = x0; i < size; ++i) {
+		dst[i] = static_cast<uint8_t>((rowA[i] * (LINEAR_ONE - weight) + rowB[i] * weight + LINEAR_ONE / 2) >> LINEAR_SHIFT);
+	}
+}
+
+TARGET_AVX2
+static void blendRowsAVX2(const uint8_t* rowA, const uint8_t* rowB, uint8_t* dst, size_t size, int weight) {
+	const __m256i weights = _mm256_set1_epi16(static_cast<short>((weight << 8) | (LINEAR_ONE - weight)));
+	const __m256i round = _mm256_set1_epi16(LINEAR_ONE / 2);
+	size_t i = 0;
+
+	for (; i + 32 <= size; i += 32) {
+		__m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rowA + i));
+		__m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rowB + i));
+		__m256i lo = _mm256_srli_epi16(_mm256_add_epi16(_mm256_maddubs_epi16(_mm256_unpacklo_epi8(a, b), weights), round), LINEAR_SHIFT);
+		__m256i hi = _mm256_srli_epi16(_mm256_add_epi16(_mm256_maddubs_epi16(_mm256_unpackhi_epi8(a, b), weights), round), LINEAR_SHIFT);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_packus_epi16(lo, hi));
+	}
+	_mm256_zeroupper();
+
+	blendRowsScalar(rowA, rowB, dst, i, size, weight);
+}
+
+// 가로 보간: 출력 픽셀마다 index0/index1 픽셀을 weight로 섞음
+static void linearRowScalar(const uint8_t* row, const int* index0, const int* index1, const uint8_t* weight, uint8_t* dst, int x0, int dstWidth) {
+	for (int x = x0; x < dstWidth; ++x) {
+		const uint8_t* p0 = row + index0[x] * 4;
+		const uint8_t* p1 = row + index1[x] * 4;
+		for (int channel = 0; channel < 4; ++channel) {
+			dst[x * 4 + channel] = static_cast<uint8_t>((p0[channel] * (LINEAR_ONE - weight[x]) + p1[channel] * weight[x] + LINEAR_ONE / 2) >> LINEAR_SHIFT);
+		}
+	}
+}
+
+TARGET_AVX2
+static void linearRowAVX2(const uint8_t* row, const int* index0, const int* index1, const uint8_t* weight, const int8_t* pixelWeights, uint8_t* dst, int dstWidth) {
+	const __m256i round = _mm256_set1_epi16(LINEAR_ONE / 2);
+	const int* pixels = reinterpret_cast<const int*>(row);
+	int x = 0;
+
+	for (; x + 8 <= dstWidth; x += 8) {
+		__m256i p0 = _mm256_i32gather_epi32(pixels, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(index0 + x)), 4);
+		__m256i p1 = _mm256_i32gather_epi32(pixels, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(index1 + x)), 4);
+
+		// 바이트 교차: lo = 출력 (0, 1 | 4, 5), hi = (2, 3 | 6, 7)
+		const int8_t* w = pixelWeights + x * 8;
+		__m256i wLo = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(w))), _mm_loadu_si128(reinterpret_cast<const __m128i*>(w + 32)), 1);
+		__m256i wHi = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(w + 16))), _mm_loadu_si128(reinterpret_cast<const __m128i*>(w + 48)), 1);
+		__m256i lo = _mm256_srli_epi16(_mm256_add_epi16(_mm256_maddubs_epi16(_mm256_unpacklo_epi8(p0, p1), wLo), round), LINEAR_SHIFT);
+		__m256i hi = _mm256_srli_epi16(_mm256_add_epi16(_mm256_maddubs_epi16(_mm256_unpackhi_epi8(p0, p1), wHi), round), LINEAR_SHIFT);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + x * 4), _mm256_packus_epi16(lo, hi));
+	}
+	_mm256_zeroupper();
+
+	linearRowScalar(row, index0, index1, weight, dst, x, dstWidth);
+}
+
+// 세로 면적 평균: 행 count개를 가중 합산
+static void areaColumnScalar(const uint8_t* const* rows, const int16_t* weights, int count, uint8_t* dst, size_t x0, size_t size) {
+	for (size_t i = x0; i < size; ++i) {
+		int sum = 0;
+		for (int t = 0; t < count; ++t) {
+			sum += rows[t][i] * weights[t];
+		}
+		dst[i] = static_cast<uint8_t>((sum + (1 << (AREA_SHIFT - 1))) >> AREA_SHIFT);
+	}
+}
+
+static inline int weightPair(int16_t low, int16_t high) {
+	return static_cast<int>((static_cast<uint32_t>(static_cast<uint16_t>(high)) << 16) | static_cast<uint16_t>(low));
+}
+
+TARGET_AVX2
+static void areaColumnAVX2(const uint8_t* const* rows, const int16_t* weights, int count, uint8_t* dst, size_t size) {
+	const __m256i round = _mm256_set1_epi32(1 << (AREA_SHIFT - 1));
+	const __m256i zero = _mm256_setzero_si256();
+	size_t i = 0;
+
+	for (; i + 16 <= size; i += 16) {
+		__m256i accLo = _mm256_setzero_si256();
+		__m256i accHi = _mm256_setzero_si256();
+
+		// 두 행씩 (a, b) 쌍으로 묶어 madd
+		int t = 0;
+		for (; t + 1 < count; t += 2) {
+			__m256i a = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(rows[t] + i)));
+			__m256i b = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(rows[t + 1] + i)));
+			__m256i w = _mm256_set1_epi32(weightPair(weights[t], weights[t + 1]));
+			accLo = _mm256_add_epi32(accLo, _mm256_madd_epi16(_mm256_unpacklo_epi16(a, b), w));
+			accHi = _mm256_add_epi32(accHi, _mm256_madd_epi16(_mm256_unpackhi_epi16(a, b), w));
+		}
+		if (t < count) {
+			__m256i a = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(rows[t] + i)));
+			__m256i w = _mm256_set1_epi32(weightPair(weights[t], 0));
+			accLo = _mm256_add_epi32(accLo, _mm256_madd_epi16(_mm256_unpacklo_epi16(a, zero), w));
+			accHi = _mm256_add_epi32(accHi, _mm256_madd_epi16(_mm256_unpackhi_epi16(a, zero), w));
+		}
+
+		accLo = _mm256_srli_epi32(_mm256_add_epi32(accLo, round), AREA_SHIFT);
+		accHi = _mm256_srli_epi32(_mm256_add_epi32(accHi, round), AREA_SHIFT);
+		__m256i words = _mm256_packs_epi32(accLo, accHi);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(_mm256_castsi256_si128(words), _mm256_extracti128_si256(words, 1)));
+	}
+	_mm256_zeroupper();
+
+	areaColumnScalar(rows, weights, count, dst, i, size);
+}
+
+// 가로 면적 평균: 출력 픽셀마다 원본 픽셀 count개를 가중 합산
+static void areaRowScalar(const uint8_t* row, const int* first, const int* count, const int* weightOffset, const int16_t* weights, uint8_t* dst, int dstWidth) {
+	for (int x = 0; x < dstWidth; ++x) {
+		const uint8_t* p = row + first[x] * 4;
+		const int16_t* w = weights + weightOffset[x];
+		for (int channel = 0; channel < 4; ++channel) {
+			int sum = 0;
+			for (int t = 0; t < count[x]; ++t) {
+				sum += p[t * 4 + channel] * w[t];
+			}
+			dst[x * 4 + channel] = static_cast<uint8_t>((sum + (1 << (AREA_SHIFT - 1))) >> AREA_SHIFT);
+		}
+	}
+}
+
+// 출력 픽셀마다 같은 수(tapPairs * 2)의 원본 픽셀을 두 개씩 채널별 (p0, p1) 쌍으로 모아 madd
+// first/pairWeights([탭 쌍 * dstWidth + x])는 FrameScaler::reset에서 원본 끝을 넘지 않도록 당기고 0 가중치로 채운 표
+TARGET_AVX2
+static void areaRowAVX2(const uint8_t* row, const int* first, const int* pairWeights, int tapPairs, uint8_t* dst, int dstWidth) {
+	const __m256i round = _mm256_set1_epi32(1 << (AREA_SHIFT - 1));
+	const __m256i zero = _mm256_setzero_si256();
+	const int* pixels = reinterpret_cast<const int*>(row);
+	int x = 0;
+
+	// 출력 8픽셀씩: 탭 쌍마다 두 원본 픽셀을 gather
+	for (; x + 8 <= dstWidth; x += 8) {
+		__m256i index = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first + x));
+		__m256i acc04 = _mm256_setzero_si256();
+		__m256i acc15 = _mm256_setzero_si256();
+		__m256i acc26 = _mm256_setzero_si256();
+		__m256i acc37 = _mm256_setzero_si256();
+
+		for (int t = 0; t < tapPairs; ++t) {
+			__m256i p0 = _mm256_i32gather_epi32(pixels, index, 4);
+			__m256i p1 = _mm256_i32gather_epi32(pixels + 1, index, 4);
+			index = _mm256_add_epi32(index, _mm256_set1_epi32(2));
+
+			// 바이트 교차 후 16비트로: (p0, p1) 채널 쌍. lo = 출력 (0, 1 | 4, 5), hi = (2, 3 | 6, 7)
+			__m256i lo = _mm256_unpacklo_epi8(p0, p1);
+			__m256i hi = _mm256_unpackhi_epi8(p0, p1);
+			__m256i w = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pairWeights + t * dstWidth + x));
+			acc04 = _mm256_add_epi32(acc04, _mm256_madd_epi16(_mm256_unpacklo_epi8(lo, zero), _mm256_permutevar8x32_epi32(w, _mm256_setr_epi32(0, 0, 0, 0, 4, 4, 4, 4))));
+			acc15 = _mm256_add_epi32(acc15, _mm256_madd_epi16(_mm256_unpackhi_epi8(lo, zero), _mm256_permutevar8x32_epi32(w, _mm256_setr_epi32(1, 1, 1, 1, 5, 5, 5, 5))));
+			acc26 = _mm256_add_epi32(acc26, _mm256_madd_epi16(_mm256_unpacklo_epi8(hi, zero), _mm256_permutevar8x32_epi32(w, _mm256_setr_epi32(2, 2, 2, 2, 6, 6, 6, 6))));
+			acc37 = _mm256_add_epi32(acc37, _mm256_madd_epi16(_mm256_unpackhi_epi8(hi, zero), _mm256_permutevar8x32_epi32(w, _mm256_setr_epi32(3, 3, 3, 3, 7, 7, 7, 7))));
+		}
+
+		acc04 = _mm256_srli_epi32(_mm256_add_epi32(acc04, round), AREA_SHIFT);
+		acc15 = _mm256_srli_epi32(_mm256_add_epi32(acc15, round), AREA_SHIFT);
+		acc26 = _mm256_srli_epi32(_mm256_add_epi32(acc26, round), AREA_SHIFT);
+		acc37 = _mm256_srli_epi32(_mm256_add_epi32(acc37, round), AREA_SHIFT);
+		// (0, 1 | 4, 5), (2, 3 | 6, 7) -> (0-3 | 4-7)
+		__m256i result = _mm256_packus_epi16(_mm256_packs_epi32(acc04, acc15), _mm256_packs_epi32(acc26, acc37));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + x * 4), result);
+	}
+	_mm256_zeroupper();
+
+	// 나머지 픽셀은 4채널을 한 벡터로
+	const __m128i roundPixel = _mm_set1_epi32(1 << (AREA_SHIFT - 1));
+	const __m128i pairChannels = _mm_setr_epi8(0, 4, 1, 5, 2, 6, 3, 7, -1, -1, -1, -1, -1, -1, -1, -1);
+	for (; x < dstWidth; ++x) {
+		const uint8_t* p = row + first[x] * 4;
+		__m128i acc = _mm_setzero_si128();
+		for (int t = 0; t < tapPairs; ++t) {
+			__m128i pairs = _mm_cvtepu8_epi16(_mm_shuffle_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p + t * 8)), pairChannels));
+			acc = _mm_add_epi32(acc, _mm_madd_epi16(pairs, _mm_set1_epi32(pairWeights[t * dstWidth + x])));
+		}
+		acc = _mm_srli_epi32(_mm_add_epi32(acc, roundPixel), AREA_SHIFT);
+		int result = _mm_cvtsi128_si32(_mm_packus_epi16(_mm_packus_epi32(acc, acc), _mm_setzero_si128()));
+		memcpy(dst + x * 4, &result, sizeof(int));
+	}
+}
+
+void FrameScaler::makeAreaTaps(int srcSize, int dstSize, AreaTaps& taps) {
+	taps.first.resize(dstSize);
+	taps.count.resize(dstSize);
+	taps.weightOffset.resize(dstSize);
+	taps.weights.clear();
+
+	// 출력 픽셀 i는 원본 [i * src, (i + 1) * src) / dst 구간을 덮음 (1/dst 단위 정수로 계산)
+	for (int i = 0; i < dstSize; ++i) {
+		long long start = static_cast<long long>(i) * srcSize;
+		long long end = start + srcSize;
+		int first = static_cast<int>(start / dstSize);
+		int last = static_cast<int>((end - 1) / dstSize);
+
+		taps.first[i] = first;
+		taps.count[i] = last - first + 1;
+		taps.weightOffset[i] = static_cast<int>(taps.weights.size());
+
+		int sum = 0;
+		size_t largest = taps.weights.size();
+		for (int j = first; j <= last; ++j) {
+			long long overlap = (std::min)(end, static_cast<long long>(j + 1) * dstSize) - (std::max)(start, static_cast<long long>(j) * dstSize);
+			int16_t weight = static_cast<int16_t>((overlap * (1 << AREA_SHIFT) + srcSize / 2) / srcSize);
+			taps.weights.push_back(weight);
+			if (weight > taps.weights[largest]) {
+				largest = taps.weights.size() - 1;
+			}
+			sum += weight;
+		}
+		// 반올림 오차는 가장 큰 가중치에 몰아 합을 정확히 2^14로
+		taps.weights[largest] = static_cast<int16_t>(taps.weights[largest] + (1 << AREA_SHIFT) - sum);
+	}
+}
+
+void FrameScaler::makeLinearTaps(int srcSize, int dstSize, LinearTaps& taps) {
+	taps.index0.resize(dstSize);
+	taps.index1.resize(dstSize);
+	taps.weight.resize(dstSize);
+
+	// 픽셀 중심 정렬: s = (i + 0.5) * src / dst - 0.5 = ((2i + 1) * src - dst) / (2 * dst)
+	long long denominator = 2LL * dstSize;
+	for (int i = 0; i < dstSize; ++i) {
+		long long numerator = (std::max)(0LL, (2LL * i + 1) * srcSize - dstSize);
+		int index = static_cast<int>(numerator / denominator);
+		int weight = static_cast<int>(((numerator % denominator) * LINEAR_ONE + denominator / 2) / denominator);
+		if (weight == LINEAR_ONE) {
+			++index;
+			weight = 0;
+		}
+		if (index >= srcSize - 1) {
+			index = srcSize - 1;
+			weight = 0;
+		}
+
+		taps.index0[i] = index;
+		taps.index1[i] = (std::min)(index + 1, srcSize - 1);
+		taps.weight[i] = static_cast<uint8_t>(weight);
+	}
+}
+
+void FrameScaler::reset(int srcWidthValue, int srcHeightValue, int dstWidthValue, int dstHeightValue, int filter) {
+	srcWidth = srcWidthValue;
+	srcHeight = srcHeightValue;
+	dstWidth = dstWidthValue;
+	dstHeight = dstHeightValue;
+	requestedFilter = filter;
+
+	boxFactor = 0;
+	for (int factor : { 2, 4 }) {
+		if (srcWidth == dstWidth * factor && srcHeight == dstHeight * factor) {
+			boxFactor = factor;
+		}
+	}
+
+	bool downscale = dstWidth <= srcWidth && dstHeight <= srcHeight;
+	switch (filter) {
+	case SCALE_FILTER_BILINEAR:
+		resolvedFilter = SCALE_FILTER_BILINEAR;
+		break;
+	case SCALE_FILTER_AREA:
+		resolvedFilter = SCALE_FILTER_AREA;
+		break;
+	case SCALE_FILTER_BOX:
+		resolvedFilter = boxFactor ? SCALE_FILTER_BOX : SCALE_FILTER_AREA;
+		break;
+	default:
+		resolvedFilter = boxFactor ? SCALE_FILTER_BOX : (downscale ? SCALE_FILTER_AREA : SCALE_FILTER_BILINEAR);
+		break;
+	}
+
+	if (resolvedFilter == SCALE_FILTER_AREA) {
+		makeAreaTaps(srcWidth, dstWidth, areaX);
+		makeAreaTaps(srcHeight, dstHeight, areaY);
+
+		// AVX2 가로 패스용: 탭 수를 짝수로 맞추고 원본 끝을 넘지 않게 시작 위치를 당김
+		int maxCount = *std::max_element(areaX.count.begin(), areaX.count.end());
+		areaTapPairs = (maxCount + 1) / 2;
+		int tapCount = areaTapPairs * 2;
+		std::vector<int16_t> padded(static_cast<size_t>(dstWidth) * tapCount, 0);
+		areaPaddedFirst.resize(dstWidth);
+		for (int x = 0; x < dstWidth; ++x) {
+			int first = (std::max)(0, (std::min)(areaX.first[x], srcWidth - tapCount));
+			areaPaddedFirst[x] = first;
+			for (int t = 0; t < areaX.count[x]; ++t) {
+				padded[x * tapCount + areaX.first[x] + t - first] = areaX.weights[areaX.weightOffset[x] + t];
+			}
+		}
+		areaPairWeights.resize(static_cast<size_t>(dstWidth) * areaTapPairs);
+		for (int t = 0; t < areaTapPairs; ++t) {
+			for (int x = 0; x < dstWidth; ++x) {
+				areaPairWeights[t * dstWidth + x] = weightPair(padded[x * tapCount + t * 2], padded[x * tapCount + t * 2 + 1]);
+			}
+		}
+	}
+	else if (resolvedFilter == SCALE_FILTER_BILINEAR) {
+		makeLinearTaps(srcWidth, dstWidth, linearX);
+		makeLinearTaps(srcHeight, dstHeight, linearY);
+
+		linearXWeights.resize(static_cast<size_t>(dstWidth) * 8);
+		for (int x = 0; x < dstWidth; ++x) {
+			for (int channel = 0; channel < 4; ++channel) {
+				linearXWeights[x * 8 + channel * 2] = static_cast<int8_t>(LINEAR_ONE - linearX.weight[x]);
+				linearXWeights[x * 8 + channel * 2 + 1] = static_cast<int8_t>(linearX.weight[x]);
+			}
+		}
+	}
+}
+
+void FrameScaler::setAvx2Enabled(bool enabled) {
+	avx2 = enabled && useAvx2;
+}
+
+bool FrameScaler::matches(int srcWidthValue, int srcHeightValue, int dstWidthValue, int dstHeightValue, int filter) const {
+	return srcWidth == srcWidthValue && srcHeight == srcHeightValue && dstWidth == dstWidthValue && dstHeight == dstHeightValue && requestedFilter == filter;
+}
+
+void FrameScaler::scaleRows(const uint8_t* src, size_t srcPitch, uint8_t* dst, int firstRow, int lastRow) const {
+	const size_t dstStride = static_cast<size_t>(dstWidth) * 4;
+	const size_t srcRowSize = static_cast<size_t>(srcWidth) * 4;
+
+	// 밴드마다 원본 한 행 크기의 작업 행 (BOX 4:1은 중간 행 두 개, AREA 가로 패스는 끝을 조금 넘어 읽음)
+	thread_local std::vector<uint8_t> work;
+	thread_local std::vector<const uint8_t*> rows;
+	if (work.size() < srcRowSize * 2) {
+		work.resize(srcRowSize * 2);
+	}
+
+	for (int y = firstRow; y < lastRow; ++y) {
+		uint8_t* out = dst + y * dstStride;
+
+		if (resolvedFilter == SCALE_FILTER_BOX) {
+			const uint8_t* row = src + static_cast<size_t>(y) * boxFactor * srcPitch;
+			if (boxFactor == 2) {
+				boxRow(row, row + srcPitch, out, dstWidth, avx2);
+			}
+			else {
+				// 4:1 = 2:1을 두 번
+				uint8_t* halfA = work.data();
+				uint8_t* halfB = work.data() + dstWidth * 8;
+				boxRow(row, row + srcPitch, halfA, dstWidth * 2, avx2);
+				boxRow(row + srcPitch * 2, row + srcPitch * 3, halfB, dstWidth * 2, avx2);
+				boxRow(halfA, halfB, out, dstWidth, avx2);
+			}
+		}
+		else if (resolvedFilter == SCALE_FILTER_BILINEAR) {
+			const uint8_t* rowA = src + static_cast<size_t>(linearY.index0[y]) * srcPitch;
+			const uint8_t* rowB = src + static_cast<size_t>(linearY.index1[y]) * srcPitch;
+			const uint8_t* row = rowA;
+			if (linearY.weight[y] != 0) {
+				if (avx2) {
+					blendRowsAVX2(rowA, rowB, work.data(), srcRowSize, linearY.weight[y]);
+				}
+				else {
+					blendRowsScalar(rowA, rowB, work.data(), 0, srcRowSize, linearY.weight[y]);
+				}
+				row = work.data();
+			}
+
+			if (avx2) {
+				linearRowAVX2(row, linearX.index0.data(), linearX.index1.data(), linearX.weight.data(), linearXWeights.data(), out, dstWidth);
+			}
+			else {
+				linearRowScalar(row, linearX.index0.data(), linearX.index1.data(), linearX.weight.data(), out, 0, dstWidth);
+			}
+		}
+		else {
+			// 세로로 먼저 모은 한 행을 가로로 모음
+			int count = areaY.count[y];
+			rows.resize(count);
+			for (int t = 0; t < count; ++t) {
+				rows[t] = src + static_cast<size_t>(areaY.first[y] + t) * srcPitch;
+			}
+			const int16_t* weights = areaY.weights.data() + areaY.weightOffset[y];
+			if (avx2) {
+				areaColumnAVX2(rows.data(), weights, count, work.data(), srcRowSize);
+				areaRowAVX2(work.data(), areaPaddedFirst.data(), areaPairWeights.data(), areaTapPairs, out, dstWidth);
+			}
+			else {
+				areaColumnScalar(rows.data(), weights, count, work.data(), 0, srcRowSize);
+				areaRowScalar(work.data(), areaX.first.data(), areaX.count.data(), areaX.weightOffset.data(), areaX.weights.data(), out, dstWidth);
+			}
+		}
+	}
+}
+
+void FrameScaler::scale(const uint8_t* src, size_t srcPitch, uint8_t* dst, ThreadPool* pool) const {
+	// 같은 크기는 행 복사
+	if (srcWidth == dstWidth && srcHeight == dstHeight) {
+		for (int y = 0; y < dstHeight; ++y) {
+			memcpy(dst + static_cast<size_t>(y) * dstWidth * 4, src + y * srcPitch, static_cast<size_t>(dstWidth) * 4);
+		}
+		return;
+	}
+
+	size_t bandCount = pool ? (std::min)(static_cast<size_t>(dstHeight), (pool->size() + 1) * 2) : 1;
+	if (bandCount <= 1) {
+		scaleRows(src, srcPitch, dst, 0, dstHeight);
+		return;
+	}
+	pool->parallelFor(bandCount, [&](size_t band) {
+		scaleRows(src, srcPitch, dst, static_cast<int>(band * dstHeight / bandCount), static_cast<int>((band + 1) * dstHeight / bandCount));
+	});
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "CaptureDLL.h"
+#include "CpuFeatures.h"
+#include "ThreadPool.h"
+
+// BGRA 프레임 리샘플링 (ScaleFilter). 배율별 가중치 표는 reset()에서 한 번만 만듦
+class FrameScaler {
+public:
+	void reset(int srcWidth, int srcHeight, int dstWidth, int dstHeight, int filter);
+	bool matches(int srcWidth, int srcHeight, int dstWidth, int dstHeight, int filter) const;
+
+	// AVX2 커널 사용 여부 (기본은 CPU가 지원하면 켬). 끄면 스칼라 기준 구현으로 처리 (정확성 비교용)
+	void setAvx2Enabled(bool enabled);
+	bool avx2Enabled() const { return avx2; }
+
+	// AUTO를 풀어낸 실제 필터
+	int activeFilter() const { return resolvedFilter; }
+
+	// src(srcPitch 바이트 간격 행) -> dst(dstWidth * 4 바이트 간격 행)
+	// pool이 있으면 출력 행을 밴드로 나눠 병렬 처리
+	void scale(const uint8_t* src, size_t srcPitch, uint8_t* dst, ThreadPool* pool = nullptr) const;
+
+private:
+	// 출력 픽셀 하나에 기여하는 원본 픽셀 범위와 2^14 고정소수점 가중치 (합 = 2^14)
+	struct AreaTaps {
+		std::vector<int> first;
+		std::vector<int> count;
+		std::vector<int> weightOffset;
+		std::vector<int16_t> weights;
+	};
+
+	// 출력 픽셀 하나의 두 원본 픽셀과 두 번째 픽셀 가중치 (0~64)
+	struct LinearTaps {
+		std::vector<int> index0;
+		std::vector<int> index1;
+		std::vector<uint8_t> weight;
+	};
+
+	static void makeAreaTaps(int srcSize, int dstSize, AreaTaps& taps);
+	static void makeLinearTaps(int srcSize, int dstSize, LinearTaps& taps);
+
+	void scaleRows(const uint8_t* src, size_t srcPitch, uint8_t* dst, int firstRow, int lastRow) const;
+
+	int srcWidth = 0;
+	int srcHeight = 0;
+	int dstWidth = 0;
+	int dstHeight = 0;
+	int requestedFilter = SCALE_FILTER_AUTO;
+	int resolvedFilter = SCALE_FILTER_AREA;
+	int boxFactor = 0;
+	bool avx2 = getCpuFeatures().avx2;
+
+	AreaTaps areaX;
+	AreaTaps areaY;
+	// AVX2 가로 패스용 짝수 탭 표 (시작 위치, 탭 쌍 가중치)
+	int areaTapPairs = 0;
+	std::vector<int> areaPaddedFirst;
+	std::vector<int> areaPairWeights; // [탭 쌍 * dstWidth + x]
+	LinearTaps linearX;
+	LinearTaps linearY;
+	std::vector<int8_t> linearXWeights; // 출력 픽셀마다 (64 - w, w) x 4채널
+};
@@ -0,0 +1,161 @@
+#include "LinkEmulator.h"
+
+#include <algorithm>
+#include <cmath>
+
+void LinkEmulator::configure(const LinkEmulationSettings& newSettings, uint32_t seed) {
+	settings = newSettings;
+	random.seed(seed);
+	active = true;
+	badState = false;
+	tokens = (std::max)(0, settings.burstBytes);
+	bucketTimeUs = 0;
+	lastInOrderUs = 0;
+	nextOrder = 0;
+	for (const HeldPacket& packet : held) {
+		freeBuffers.push_back(packet.buffer);
+	}
+	held.clear();
+	stats = LinkEmulatorCounters();
+}
+
+void LinkEmulator::disable() {
+	active = false;
+	for (const HeldPacket& packet : held) {
+		freeBuffers.push_back(packet.buffer);
+	}
+	held.clear();
+}
+
+bool LinkEmulator::later(const HeldPacket& a, const HeldPacket& b) {
+	return a.deliveryUs != b.deliveryUs ? a.deliveryUs > b.deliveryUs : a.order > b.order;
+}
+
+bool LinkEmulator::submit(const uint8_t* packet, size_t size, int64_t nowUs) {
+	stats.packetsIn++;
+	// 결과와 상관없이 패킷마다 같은 개수를 뽑아 seed가 같으면 같은 패킷이 같은 결과를 받게 함
+	double transitionDraw = uniform(random);
+	double lossDraw = uniform(random);
+	double jitterDraw = uniform(random);
+	double reorderDraw = uniform(random);
+
+	// 병목: 토큰 버킷이 허락하는 시각에 앞 패킷 뒤로 하나씩 떠남
+	int64_t departUs = nowUs;
+	if (settings.bandwidthMbps > 0) {
+		double bytesPerUs = settings.bandwidthMbps / 8;
+		int64_t startUs = (std::max)(nowUs, bucketTimeUs);
+		double available = (std::min)(static_cast<double>((std::max)(0, settings.burstBytes)), tokens + (startUs - bucketTimeUs) * bytesPerUs);
+		// 큐에 쌓인 양 = 지금부터 마지막 패킷이 떠날 때까지 보낼 수 있는 바이트
+		long long queued = static_cast<long long>((std::max<int64_t>)(0, bucketTimeUs - nowUs) * bytesPerUs);
+		if (settings.queueBytes > 0 && queued + static_cast<long long>(size) > settings.queueBytes) {
+			stats.queueDrops++;
+			return false;
+		}
+		stats.maxQueueBytes = (std::max)(stats.maxQueueBytes, queued + static_cast<long long>(size));
+		if (available >= size) {
+			departUs = startUs;
+			tokens = available - size;
+		}
+		else {
+			departUs = startUs + static_cast<int64_t>(std::ceil((size - available) / bytesPerUs));
+			tokens = 0;
+		}
+		bucketTimeUs = departUs;
+	}
+
+	// Gilbert-Elliott: 상태를 옮긴 뒤 그 상태의 손실 확률
+	badState = badState ? transitionDraw >= settings.badToGoodRate : transitionDraw < settings.goodToBadRate;
+	if (lossDraw < (badState ? settings.badLossRate : settings.goodLossRate)) {
+		stats.lossDrops++;
+		if (badState) {
+			stats.burstLosses++;
+		}
+		return false;
+	}
+
+	// 지터는 순서를 유지 (앞 패킷보다 먼저 도착하지 않음). 순서를 바꿀 패킷만 추가 지연
+	double delayMs = settings.delayMs;
+	if (settings.jitterMs > 0) {
+		delayMs += -settings.jitterMs * std::log(1 - jitterDraw);
+	}
+	int64_t deliveryUs = departUs + static_cast<int64_t>(delayMs * 1000);
+	if (reorderDraw < settings.reorderRate) {
+		deliveryUs = (std::max)(deliveryUs, lastInOrderUs) + static_cast<int64_t>(settings.reorderDelayMs * 1000);
+		stats.reorderedPackets++;
+	}
+	else {
+		deliveryUs = (std::max)(deliveryUs, lastInOrderUs);
+		lastInOrderUs = deliveryUs;
+	}
+
+	size_t buffer;
+	if (!freeBuffers.empty()) {
+		buffer = freeBuffers.back();
+		freeBuffers.pop_back();
+	}
+	else {
+		buffer = buffers.size();
+		buffers.emplace_back();
+	}
+	buffers[buffer].assign(packet, packet + size);
+	held.push_back({ deliveryUs, nowUs, nextOrder++, buffer });
+	std::push_heap(held.begin(), held.end(), later);
+	return true;
+}
+
+bool LinkEmulator::pop(int64_t nowUs, std::vector<uint8_t>& packet) {
+	if (held.empty() || held.front().deliveryUs > nowUs) {
+		return false;
+	}
+	std::pop_heap(held.begin(), held.end(), later);
+	HeldPacket next = held.back();
+	held.pop_back();
+	packet.swap(buffers[next.buffer]);
+	freeBuffers.push_back(next.buffer);
+
+	double delayMs = (nowUs - next.submitUs) / 1000.0;
+	stats.packetsDelivered++;
+	stats.totalDelayMs += delayMs;
+	stats.maxDelayMs = (std::max)(stats.maxDelayMs, delayMs);
+	return true;
+}
+
+int64_t LinkEmulator::nextDeliveryUs() const {
+	return held.empty() ? -1 : held.front().deliveryUs;
+}
+
+bool LinkEmulator::preset(int preset, LinkEmulationSettings& settings) {
+	settings = {};
+	switch (preset) {
+	case LINK_PRESET_HOME_WIFI:
+		// 5GHz 공유기와 같은 방: 여유 있는 대역폭, 짧은 큐, 다른 기기/재전송으로 생기는 지터와 짧은 손실 뭉치
+		settings.bandwidthMbps = 120;
+		settings.burstBytes = 64 * 1024;
+		settings.queueBytes = 384 * 1024;   // 120Mbps에서 약 25ms
+		settings.delayMs = 2;
+		settings.jitterMs = 3;
+		settings.reorderRate = 0.002;
+		settings.reorderDelayMs = 4;
+		settings.goodToBadRate = 0.002;     // 평균 500패킷마다 나쁨 상태
+		settings.badToGoodRate = 0.25;      // 나쁨 상태는 평균 4패킷
+		settings.goodLossRate = 0.0005;
+		settings.badLossRate = 0.3;         // 평균 손실 약 0.3%
+		return true;
+	case LINK_PRESET_USB_TETHER:
+		// 휴대폰 LTE 테더링: 좁은 대역폭, 모뎀의 깊은 큐(버퍼블로트), 긴 기본 지연, 드물지만 긴 손실 뭉치
+		settings.bandwidthMbps = 30;
+		settings.burstBytes = 32 * 1024;
+		settings.queueBytes = 768 * 1024;   // 30Mbps에서 약 200ms
+		settings.delayMs = 25;
+		settings.jitterMs = 6;
+		settings.reorderRate = 0.0005;
+		settings.reorderDelayMs = 10;
+		settings.goodToBadRate = 0.0005;
+		settings.badToGoodRate = 0.05;      // 나쁨 상태는 평균 20패킷
+		settings.goodLossRate = 0.0002;
+		settings.badLossRate = 0.5;         // 평균 손실 약 0.5%
+		return true;
+	default:
+		return false;
+	}
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "CaptureDLL.h"
+
+// 링크 에뮬레이터 누적 통계
+struct LinkEmulatorCounters {
+	long long packetsIn = 0;
+	long long packetsDelivered = 0;
+	long long queueDrops = 0;      // 병목 큐가 넘쳐 버린 패킷
+	long long lossDrops = 0;       // Gilbert-Elliott 손실로 버린 패킷
+	long long burstLosses = 0;     // lossDrops 중 나쁨 상태에서 잃은 패킷
+	long long reorderedPackets = 0;
+	double totalDelayMs = 0;       // 넣은 시각 -> 도착 시각 (큐 + 지연)
+	double maxDelayMs = 0;
+	long long maxQueueBytes = 0;
+};
+
+// 프로세스 안에서 네트워크 링크를 흉내냄 (root/netem 없이 시험용)
+// 토큰 버킷 대역폭 + 병목 큐 -> Gilbert-Elliott 손실 -> 지연(기본 + 지수 분포 지터) -> 일부 패킷만 추가 지연으로 순서 바꿈
+// 시각은 호출하는 쪽이 넘기고 패킷마다 난수를 같은 개수만큼 뽑으므로, seed와 넣는 시각이 같으면 결과도 같음
+// 한 쓰레드에서만 사용
+class LinkEmulator {
+public:
+	// 설정을 바꾸면 들고 있던 패킷은 버림
+	void configure(const LinkEmulationSettings& settings, uint32_t seed);
+	void disable();
+	bool enabled() const { return active; }
+
+	// 링크에 패킷을 넣음. 버려지면 false
+	bool submit(const uint8_t* packet, size_t size, int64_t nowUs);
+	// nowUs까지 도착한 패킷 하나를 도착 순서대로 꺼냄. 없으면 false
+	bool pop(int64_t nowUs, std::vector<uint8_t>& packet);
+	// 다음 패킷 도착 시각 (없으면 -1)
+	int64_t nextDeliveryUs() const;
+
+	LinkEmulatorCounters counters() const { return stats; }
+
+	// 미리 정한 시나리오 (LinkEmulationPreset). 모르는 값이면 false
+	static bool preset(int preset, LinkEmulationSettings& settings);
+
+private:
+	struct HeldPacket {
+		int64_t deliveryUs;
+		int64_t submitUs;
+		uint64_t order;   // 같은 시각이면 넣은 순서대로
+		size_t buffer;    // buffers 번호
+	};
+
+	static bool later(const HeldPacket& a, const HeldPacket& b);
+
+	bool active = false;
+	LinkEmulationSettings settings{};
+	std::mt19937 random;
+	std::uniform_real_distribution<double> uniform{ 0.0, 1.0 };
+
+	bool badState = false;
+	double tokens = 0;           // bucketTimeUs 시점의 토큰 (바이트)
+	int64_t bucketTimeUs = 0;    // 마지막 패킷이 병목을 떠난 시각
+	int64_t lastInOrderUs = 0;   // 순서를 지키는 패킷의 마지막 도착 시각
+	uint64_t nextOrder = 0;
+
+	std::vector<HeldPacket> held;           // 도착 시각 최소 힙
+	std::vector<std::vector<uint8_t>> buffers;
+	std::vector<size_t> freeBuffers;
+
+	LinkEmulatorCounters stats;
+};
@@ -0,0 +1,296 @@
+#include "MotionDetect.h"
+#include "TileHash.h"
+
+#include <algorithm>
+#include <cstring>
+
+// 이동으로 인정하기 위한 최소 일치 행(열) 수
+static const int MIN_VOTES = 8;
+static const int MIN_RUN = 16;
+
+void MotionDetector::reset(int width, int height) {
+	frameWidth = width;
+	frameHeight = height;
+	stripCount = (width + MOTION_STRIP_SIZE - 1) / MOTION_STRIP_SIZE;
+	bandCount = (height + MOTION_STRIP_SIZE - 1) / MOTION_STRIP_SIZE;
+	hasPrevious = false;
+
+	prevRowHashes.assign((size_t)stripCount * frameHeight, 0);
+	currRowHashes.assign((size_t)stripCount * frameHeight, 0);
+	prevColumnHashes.assign((size_t)bandCount * frameWidth, 0);
+	currColumnHashes.assign((size_t)bandCount * frameWidth, 0);
+}
+
+// 한 번의 행 우선 순회로 스트립별 행 해시와 밴드별 열 해시를 같이 계산
+// 밴드끼리는 쓰는 칸이 겹치지 않으므로 pool이 있으면 밴드 단위로 병렬 처리
+void MotionDetector::hashFrame(const uint8_t* frame, std::vector<uint64_t>& rowHashes, std::vector<uint32_t>& columnHashes, ThreadPool* pool) const {
+	const size_t stride = (size_t)frameWidth * 4;
+
+	auto hashBand = [&](size_t band) {
+		// 열 해시는 FNV-1a 형태의 32비트 곱셈이라 컴파일러가 벡터화할 수 있음
+		uint32_t* columns = &columnHashes[band * frameWidth];
+		std::fill(columns, columns + frameWidth, 0x811C9DC5u);
+
+		int rowBegin = (int)band * MOTION_STRIP_SIZE;
+		int rowEnd = (std::min)(rowBegin + MOTION_STRIP_SIZE, frameHeight);
+		for (int y = rowBegin; y < rowEnd; ++y) {
+			const uint8_t* row = frame + y * stride;
+
+			for (int strip = 0; strip < stripCount; ++strip) {
+				int x = strip * MOTION_STRIP_SIZE;
+				int width = (std::min)(MOTION_STRIP_SIZE, frameWidth - x);
+				rowHashes[(size_t)strip * frameHeight + y] = hashBytes(row + x * 4, (size_t)width * 4);
+			}
+
+			const uint32_t* pixels = reinterpret_cast<const uint32_t*>(row);
+			for (int x = 0; x < frameWidth; ++x) {
+				columns[x] = (columns[x] ^ pixels[x]) * 0x01000193u;
+			}
+		}
+	};
+
+	if (pool) {
+		pool->parallelFor(bandCount, hashBand);
+	}
+	else {
+		for (int band = 0; band < bandCount; ++band) {
+			hashBand(band);
+		}
+	}
+}
+
+// 이전/현재 해시 배열에서 가장 많이 나타나는 이동량 하나를 골라 그 이동량으로 일치하는 연속 구간을 찾음
+template <typename Hash>
+bool MotionDetector::findShiftRun(const Hash* prevHashes, const Hash* currHashes, int count, std::vector<ShiftRun>& result) {
+	result.clear();
+
+	int changed = 0;
+	for (int i = 0; i < count; ++i) {
+		changed += currHashes[i] != prevHashes[i];
+	}
+	if (changed < MIN_RUN) {
+		return false; // 정적인 영역은 정렬 비용 없이 바로 건너뜀
+	}
+
+	// 이전 해시 → 위치 테이블 (개방 주소법). 두 번 이상 나오는 해시는 -2로 표시
+	size_t tableSize = 1;
+	while (tableSize < (size_t)count * 2) {
+		tableSize <<= 1;
+	}
+	const size_t mask = tableSize - 1;
+	hashSlots.assign(tableSize, { 0, -1 });
+	for (int i = 0; i < count; ++i) {
+		uint64_t key = prevHashes[i];
+		size_t slot = (size_t)((key * 0x9E3779B97F4A7C15ULL) >> 32) & mask;
+		while (hashSlots[slot].second != -1 && hashSlots[slot].first != key) {
+			slot = (slot + 1) & mask;
+		}
+		if (hashSlots[slot].second == -1) {
+			hashSlots[slot] = { key, i };
+		}
+		else {
+			hashSlots[slot].second = -2;
+		}
+	}
+
+	// 이전 프레임에서 한 번만 나오는 해시만 기준점으로 사용 (단색 행은 어디와도 일치하므로 제외)
+	votes.assign((size_t)count * 2 + 1, 0);
+	for (int i = 0; i < count; ++i) {
+		if (currHashes[i] == prevHashes[i]) {
+			continue;
+		}
+		uint64_t key = currHashes[i];
+		size_t slot = (size_t)((key * 0x9E3779B97F4A7C15ULL) >> 32) & mask;
+		while (hashSlots[slot].second != -1 && hashSlots[slot].first != key) {
+			slot = (slot + 1) & mask;
+		}
+		if (hashSlots[slot].second >= 0) {
+			++votes[i - hashSlots[slot].second + count];
+		}
+	}
+
+	int best = (int)(std::max_element(votes.begin(), votes.end()) - votes.begin());
+	if (votes[best] < MIN_VOTES) {
+		return false;
+	}
+	int shift = best - count;
+
+	int runStart = -1;
+	int runChanged = 0;
+	for (int i = 0; i <= count; ++i) {
+		int source = i - shift;
+		bool match = i < count && source >= 0 && source < count && currHashes[i] == prevHashes[source];
+		if (match) {
+			if (runStart < 0) {
+				runStart = i;
+				runChanged = 0;
+			}
+			runChanged += currHashes[i] != prevHashes[i];
+		}
+		else if (runStart >= 0) {
+			int length = i - runStart;
+			if (length >= MIN_RUN && runChanged >= MIN_VOTES) {
+				result.push_back({ runStart, length, shift });
+			}
+			runStart = -1;
+		}
+	}
+
+	return !result.empty();
+}
+
+static bool rectsOverlap(const CopyRect& a, const CopyRect& b) {
+	return a.dstX < b.dstX + b.width && b.dstX < a.dstX + a.width
+		&& a.dstY < b.dstY + b.height && b.dstY < a.dstY + a.height;
+}
+
+// 같은 이동량으로 맞닿은 사각형을 하나로 합침 (스트립 경계에서 잘린 스크롤 영역 복원)
+static void mergeCopyRects(CopyRectList& copyRects, size_t begin) {
+	bool merged = true;
+	while (merged) {
+		merged = false;
+		for (size_t i = begin; i < copyRects.size() && !merged; ++i) {
+			for (size_t j = begin; j < copyRects.size() && !merged; ++j) {
+				CopyRect& a = copyRects[i];
+				const CopyRect& b = copyRects[j];
+				if (i == j || a.srcX - a.dstX != b.srcX - b.dstX || a.srcY - a.dstY != b.srcY - b.dstY) {
+					continue;
+				}
+				if (a.dstY == b.dstY && a.height == b.height && a.dstX + a.width == b.dstX) {
+					a.width += b.width;
+					merged = true;
+				}
+				else if (a.dstX == b.dstX && a.width == b.width && a.dstY + a.height == b.dstY) {
+					a.height += b.height;
+					merged = true;
+				}
+				if (merged) {
+					copyRects.erase(copyRects.begin() + j);
+				}
+			}
+		}
+	}
+}
+
+int MotionDetector::detect(const uint8_t* currentFrame, CopyRectList& copyRects, ThreadPool* pool) {
+	copyRects.clear();
+	hashFrame(currentFrame, currRowHashes, currColumnHashes, pool);
+
+	if (hasPrevious) {
+		// 세로 이동 (스크롤)
+		for (int strip = 0; strip < stripCount; ++strip) {
+			size_t offset = (size_t)strip * frameHeight;
+			if (!findShiftRun(&prevRowHashes[offset], &currRowHashes[offset], frameHeight, runs)) {
+				continue;
+			}
+			int x = strip * MOTION_STRIP_SIZE;
+			int width = (std::min)(MOTION_STRIP_SIZE, frameWidth - x);
+			for (const ShiftRun& run : runs) {
+				copyRects.push_back({ x, run.start - run.shift, x, run.start, width, run.length });
+			}
+		}
+		mergeCopyRects(copyRects, 0);
+		size_t verticalCount = copyRects.size();
+
+		// 가로 이동. 세로 이동 영역과 겹치는 것은 버림
+		for (int band = 0; band < bandCount; ++band) {
+			size_t offset = (size_t)band * frameWidth;
+			if (!findShiftRun(&prevColumnHashes[offset], &currColumnHashes[offset], frameWidth, runs)) {
+				continue;
+			}
+			int y = band * MOTION_STRIP_SIZE;
+			int height = (std::min)(MOTION_STRIP_SIZE, frameHeight - y);
+			for (const ShiftRun& run : runs) {
+				CopyRect rect = { run.start - run.shift, y, run.start, y, run.length, height };
+				bool overlaps = false;
+				for (size_t i = 0; i < verticalCount && !overlaps; ++i) {
+					overlaps = rectsOverlap(rect, copyRects[i]);
+				}
+				if (!overlaps) {
+					copyRects.push_back(rect);
+				}
+			}
+		}
+		mergeCopyRects(copyRects, verticalCount);
+	}
+
+	std::swap(prevRowHashes, currRowHashes);
+	std::swap(prevColumnHashes, currColumnHashes);
+	hasPrevious = true;
+
+	return static_cast<int>(copyRects.size());
+}
+
+static bool isValidCopyRect(const CopyRect& rect, int frameWidth, int frameHeight) {
+	return rect.width > 0 && rect.height > 0
+		&& rect.srcX >= 0 && rect.srcY >= 0 && rect.dstX >= 0 && rect.dstY >= 0
+		&& rect.srcX + rect.width <= frameWidth && rect.dstX + rect.width <= frameWidth
+		&& rect.srcY + rect.height <= frameHeight && rect.dstY + rect.height <= frameHeight;
+}
+
+void applyCopyRects(uint8_t* frame, int frameWidth, int frameHeight, const CopyRectList& copyRects) {
+	const size_t stride = (size_t)frameWidth * 4;
+
+	// 사각형끼리 src/dst가 겹칠 수 있으므로 원본 영역을 먼저 모두 떠둔 뒤 씀
+	size_t total = 0;
+	for (const CopyRect& rect : copyRects) {
+		if (isValidCopyRect(rect, frameWidth, frameHeight)) {
+			total += (size_t)rect.width * rect.height * 4;
+		}
+	}
+	static thread_local ByteBuffer sourcePixels;
+	sourcePixels.resize(total); // 재사용 버퍼면 용량 안에서 끝남
+
+	uint8_t* out = sourcePixels.data();
+	for (const CopyRect& rect : copyRects) {
+		if (!isValidCopyRect(rect, frameWidth, frameHeight)) {
+			continue;
+		}
+		size_t rowSize = (size_t)rect.width * 4;
+		for (int y = 0; y < rect.height; ++y) {
+			memcpy(out, frame + (rect.srcY + y) * stride + rect.srcX * 4, rowSize);
+			out += rowSize;
+		}
+	}
+
+	const uint8_t* in = sourcePixels.data();
+	for (const CopyRect& rect : copyRects) {
+		if (!isValidCopyRect(rect, frameWidth, frameHeight)) {
+			continue;
+		}
+		size_t rowSize = (size_t)rect.width * 4;
+		for (int y = 0; y < rect.height; ++y) {
+			memcpy(frame + (rect.dstY + y) * stride + rect.dstX * 4, in, rowSize);
+			in += rowSize;
+		}
+	}
+}
+
+void prependCopyRects(const CopyRectList& copyRects, ByteBuffer& payload) {
+	uint32_t copyRectCount = static_cast<uint32_t>(copyRects.size());
+	size_t prefixSize = sizeof(uint32_t) + copyRects.size() * sizeof(CopyRect);
+
+	payload.insert(payload.begin(), prefixSize, 0);
+	memcpy(payload.data(), &copyRectCount, sizeof(uint32_t));
+	if (!copyRects.empty()) {
+		memcpy(payload.data() + sizeof(uint32_t), copyRects.data(), copyRects.size() * sizeof(CopyRect));
+	}
+}
+
+size_t readCopyRects(const uint8_t* payload, size_t payloadSize, CopyRectList& copyRects) {
+	uint32_t copyRectCount;
+	if (payloadSize < sizeof(uint32_t)) {
+		return 0;
+	}
+	memcpy(&copyRectCount, payload, sizeof(uint32_t));
+
+	size_t prefixSize = sizeof(uint32_t) + (size_t)copyRectCount * sizeof(CopyRect);
+	if (payloadSize < prefixSize) {
+		return 0;
+	}
+	copyRects.resize(copyRectCount);
+	if (copyRectCount > 0) {
+		memcpy(copyRects.data(), payload + sizeof(uint32_t), copyRectCount * sizeof(CopyRect));
+	}
+	return prefixSize;
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "ByteBuffer.h"
+#include "ThreadPool.h"
+
+#pragma pack(push, 1)
+// 이전 프레임의 (srcX, srcY) 영역을 현재 프레임의 (dstX, dstY)로 복사하는 연산
+struct CopyRect {
+	int32_t srcX;
+	int32_t srcY;
+	int32_t dstX;
+	int32_t dstY;
+	int32_t width;
+	int32_t height;
+};
+#pragma pack(pop)
+
+// 프레임마다 파이프라인을 따라가는 CopyRect 목록 (할당 통계에 포함, CaptureDLL은 풀에서 돌려씀)
+typedef std::vector<CopyRect, CountingAllocator<CopyRect>> CopyRectList;
+
+// 세로 이동을 찾는 열 스트립 너비 / 가로 이동을 찾는 행 밴드 높이 (픽셀)
+const int MOTION_STRIP_SIZE = 64;
+
+// 스크롤/창 이동 검출. 열 스트립별 행 해시로 세로 이동을, 행 밴드별 열 해시로 가로 이동을 찾음
+// 이전 프레임의 해시는 보관하므로 매 프레임 현재 프레임만 한 번 훑음
+class MotionDetector {
+public:
+	void reset(int frameWidth, int frameHeight);
+
+	// 현재 프레임과 직전 detect() 프레임 사이의 이동 영역을 찾음. 호출 후 현재 프레임이 다음 기준이 됨
+	// pool이 있으면 해시 계산을 밴드 단위로 병렬 처리. 반환값: 검출된 CopyRect 수
+	int detect(const uint8_t* currentFrame, CopyRectList& copyRects, ThreadPool* pool = nullptr);
+
+private:
+	struct ShiftRun {
+		int start;  // 현재 프레임 기준 시작 위치
+		int length;
+		int shift;  // 현재 위치 - 이전 위치
+	};
+
+	void hashFrame(const uint8_t* frame, std::vector<uint64_t>& rowHashes, std::vector<uint32_t>& columnHashes, ThreadPool* pool) const;
+	template <typename Hash>
+	bool findShiftRun(const Hash* prevHashes, const Hash* currHashes, int count, std::vector<ShiftRun>& runs);
+
+	int frameWidth = 0;
+	int frameHeight = 0;
+	int stripCount = 0;
+	int bandCount = 0;
+	bool hasPrevious = false;
+
+	std::vector<uint64_t> prevRowHashes; // [strip * frameHeight + y]
+	std::vector<uint64_t> currRowHashes;
+	std::vector<uint32_t> prevColumnHashes; // [band * frameWidth + x]
+	std::vector<uint32_t> currColumnHashes;
+
+	// findShiftRun 작업 버퍼
+	std::vector<std::pair<uint64_t, int>> hashSlots;
+	std::vector<int> votes;
+	std::vector<ShiftRun> runs;
+};
+
+// 기준 프레임에 CopyRect를 제자리 적용. 모든 src는 적용 전 프레임 기준 좌표
+void applyCopyRects(uint8_t* frame, int frameWidth, int frameHeight, const CopyRectList& copyRects);
+
+// SetMotionDetection이 켜진 경우 페이로드 앞부분: uint32 copyRectCount | CopyRect[copyRectCount]
+void prependCopyRects(const CopyRectList& copyRects, ByteBuffer& payload);
+
+// 수신 측: 페이로드 앞부분의 CopyRect를 읽음. 반환값: 읽은 바이트 수 (실패 시 0)
+size_t readCopyRects(const uint8_t* payload, size_t payloadSize, CopyRectList& copyRects);
@@ -0,0 +1,48 @@
+#include "PacketFec.h"
+
+#include <algorithm>
+#include <cmath>
+
+// 이보다 손실이 적으면 패리티를 보내지 않음
+static const double FEC_MIN_LOSS = 0.001;
+// 그룹 하나(데이터 + 패리티)에서 두 개 이상 잃어 복구하지 못할 확률의 목표
+static const double FEC_TARGET_FAILURE = 0.001;
+// 큰 그룹부터 (중복 비율 1/32 ~ 1/2)
+static const int FEC_GROUP_SIZES[] = { 32, 24, 16, 12, 8, 6, 4, 3, 2 };
+// 손실률 평활 계수 (보고 한 번의 비중)
+static const double FEC_LOSS_SMOOTHING = 0.3;
+
+void FecController::configure(int groupSize) {
+	configuredGroupSize = groupSize < 0 ? FEC_GROUP_ADAPTIVE : (std::min)(groupSize, 255);
+	currentGroupSize = groupSize > 0 ? static_cast<size_t>((std::max)(2, configuredGroupSize)) : 0;
+	smoothedLoss = 0;
+	hasReport = false;
+}
+
+void FecController::reportLoss(long long received, long long lost) {
+	if (received + lost <= 0) {
+		return;
+	}
+	double loss = static_cast<double>(lost) / static_cast<double>(received + lost);
+	smoothedLoss = hasReport ? smoothedLoss + (loss - smoothedLoss) * FEC_LOSS_SMOOTHING : loss;
+	hasReport = true;
+	if (configuredGroupSize != FEC_GROUP_ADAPTIVE) {
+		return;
+	}
+
+	if (smoothedLoss < FEC_MIN_LOSS) {
+		currentGroupSize = 0;
+		return;
+	}
+	// 독립 손실 가정: 실패 확률 = 1 - P(손실 0) - P(손실 1), n = 그룹 + 패리티
+	double p = (std::min)(smoothedLoss, 0.5);
+	currentGroupSize = 2;
+	for (int group : FEC_GROUP_SIZES) {
+		int n = group + 1;
+		double failure = 1 - std::pow(1 - p, n) - n * p * std::pow(1 - p, n - 1);
+		if (failure <= FEC_TARGET_FAILURE) {
+			currentGroupSize = group;
+			break;
+		}
+	}
+}
@@ -0,0 +1,24 @@
+#pragma once
+#include <cstddef>
+
+// 패리티 그룹 크기 자동 선택. 받는 쪽이 알려준 손실률에 맞춰 그룹 하나에서 두 개 이상 잃을 확률이 목표 이하가 되게 함
+// XOR 패리티는 그룹당 한 패킷만 복구하므로, 손실률이 높을수록 그룹을 작게 (중복 비율을 크게)
+class FecController {
+public:
+	// FEC_GROUP_ADAPTIVE(-1)이면 자동, 0이면 끔, 그 외에는 고정 그룹 크기 (2~255)
+	void configure(int groupSize);
+
+	// 받는 쪽 보고 구간의 받은/잃은 패킷 수 (누적이 아닌 차이)
+	void reportLoss(long long received, long long lost);
+
+	size_t groupSize() const { return currentGroupSize; }
+	double lossRate() const { return smoothedLoss; }
+
+	static const int FEC_GROUP_ADAPTIVE = -1;
+
+private:
+	int configuredGroupSize = FEC_GROUP_ADAPTIVE;
+	size_t currentGroupSize = 0;
+	double smoothedLoss = 0;
+	bool hasReport = false;
+};
@@ -0,0 +1,265 @@
+#include "RateController.h"
+
+#include <algorithm>
+#include <chrono>
+
+// 큐 지연이 이보다 크거나, 큐가 차 있으면서 구간 손실률이 CONGESTION_LOSS보다 크면 링크가 밀린 것으로 보고 전달된 속도 아래로 낮춤
+// (큐가 비어 있을 때의 손실은 무선 구간 손실로 보고 FEC에 맡김)
+static const double CONGESTION_QUEUE_MS = 30;
+static const double CONGESTION_LOSS = 0.03;
+static const double CONGESTION_BACKOFF = 0.85;
+// 낮춘 뒤 큐가 비워지는 동안은 다시 낮추지 않음 (그 사이 전달 속도는 이미 줄인 송신 속도라 계속 내려가게 됨)
+static const int64_t BACKOFF_HOLD_US = 500000;
+// 큐 지연이 이보다 적으면 보고마다 올려봄
+// 추정치의 PROBE_USAGE 이상 보내고 있지 않으면 (전송률 제어가 아래 단계에 있음) 마지막으로 밀렸을 때 전달 속도의 PROBE_LIMIT배까지만
+static const double PROBE_QUEUE_MS = 10;
+static const double PROBE_USAGE = 0.8;
+static const double PROBE_GAIN = 1.08;
+static const double PROBE_LIMIT = 1.5;
+// 이보다 짧은 보고 구간은 다음 보고와 합침
+static const int64_t MIN_REPORT_INTERVAL_US = 50000;
+
+// 단계: 좋은 것부터. fps를 먼저 반으로 줄이고, 그래도 넘치면 해상도를 줄임
+struct RateLevel {
+	int frameDivisor;
+	int scaleDivisor;
+};
+static const RateLevel RATE_LEVELS[] = { { 1, 1 }, { 2, 1 }, { 2, 2 }, { 3, 2 }, { 4, 2 }, { 4, 4 } };
+static const size_t RATE_LEVEL_COUNT = sizeof(RATE_LEVELS) / sizeof(RATE_LEVELS[0]);
+
+// 예측 비트레이트가 예산의 이 비율 안에 들어야 그 단계를 씀 (패킷 헤더/FEC 여유 포함)
+static const double BUDGET_HEADROOM = 0.85;
+// 올리려면 위 단계가 이만큼 연속으로 예산 안에 들어야 함
+static const int UPGRADE_FRAMES = 30;
+// 해상도를 바꾸면 기준 프레임을 다시 보내므로 이만큼 지나기 전에는 해상도를 올리지 않음
+static const int SCALE_HOLD_FRAMES = 120;
+// 가상 버퍼가 이만큼 쌓이면 예측과 상관없이 한 단계 낮춤 (바꾼 뒤 BUFFER_SETTLE_FRAMES 동안은 비워지기를 기다림)
+static const double BUFFER_LIMIT_MS = 50;
+static const int BUFFER_SETTLE_FRAMES = 15;
+// 예측이 예산의 이 비율 아래면 압축 예산을 줄여 (acceleration을 올려) 압축 지연을 줄임
+static const double EFFORT_THRESHOLD = 0.7;
+static const double RELAXED_COMPRESS_BUDGET = 0.5;
+// 프레임 크기 평활: 커질 때는 빨리, 작아질 때는 천천히 따라감
+static const double SIZE_RISE = 0.5;
+static const double SIZE_FALL = 0.1;
+static const double RATE_SMOOTHING = 0.1;
+
+static int64_t steadyTimeUs() {
+	return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void BandwidthEstimator::reset() {
+	hasReport = false;
+	hasBaseTransit = false;
+	queueDelay = 0;
+	lastBackoffUs = 0;
+	capacity = 0;
+	estimate = 0;
+}
+
+void BandwidthEstimator::report(long long bytesReceived, long long packetsReceived, long long packetsLost, long long totalTransitUs, int64_t timeUs) {
+	// 받는 쪽이 다시 시작해 누적값이 줄었으면 기준만 다시 잡음
+	// 손실 누적은 늦게 도착한 패킷만큼 줄어들 수 있으므로 재시작 판단에 쓰지 않음
+	if (!hasReport || bytesReceived < lastBytes || packetsReceived < lastReceived || timeUs < lastTimeUs) {
+		hasReport = true;
+		hasBaseTransit = false;
+		lastBytes = bytesReceived;
+		lastReceived = packetsReceived;
+		lastLost = packetsLost;
+		lastTransitUs = totalTransitUs;
+		lastTimeUs = timeUs;
+		return;
+	}
+	int64_t elapsedUs = timeUs - lastTimeUs;
+	if (elapsedUs < MIN_REPORT_INTERVAL_US) {
+		return;
+	}
+
+	long long received = packetsReceived - lastReceived;
+	// 늦게 온 패킷은 이미 received에 들어 있으므로 줄어든 손실은 0으로 봄
+	long long lost = (std::max)(packetsLost - lastLost, 0LL);
+	double deliveredMbps = static_cast<double>(bytesReceived - lastBytes) * 8 / elapsedUs;
+	if (received > 0) {
+		// 시계 차이는 기준값에도 똑같이 들어 있으므로 빼면 큐 지연만 남음
+		double transitUs = static_cast<double>(totalTransitUs - lastTransitUs) / received;
+		baseTransitUs = hasBaseTransit ? (std::min)(baseTransitUs, transitUs) : transitUs;
+		hasBaseTransit = true;
+		queueDelay = (transitUs - baseTransitUs) / 1000;
+	}
+	if (received + lost > 0) {
+		double loss = static_cast<double>(lost) / static_cast<double>(received + lost);
+		if (queueDelay > CONGESTION_QUEUE_MS || (queueDelay > PROBE_QUEUE_MS && loss > CONGESTION_LOSS)) {
+			if (timeUs - lastBackoffUs >= BACKOFF_HOLD_US) {
+				// 큐가 차 있는 동안 전달 속도 = 링크 속도
+				capacity = deliveredMbps;
+				estimate = deliveredMbps * CONGESTION_BACKOFF;
+				lastBackoffUs = timeUs;
+			}
+		}
+		else if (estimate > 0 && queueDelay < PROBE_QUEUE_MS) {
+			if (deliveredMbps > estimate * PROBE_USAGE) {
+				capacity = (std::max)(capacity, deliveredMbps);
+				estimate *= PROBE_GAIN;
+			}
+			else {
+				estimate = (std::min)(estimate * PROBE_GAIN, (std::max)(estimate, capacity * PROBE_LIMIT));
+			}
+		}
+	}
+
+	lastBytes = bytesReceived;
+	lastReceived = packetsReceived;
+	lastLost = packetsLost;
+	lastTransitUs = totalTransitUs;
+	lastTimeUs = timeUs;
+}
+
+void RateController::configure(double target) {
+	std::lock_guard<std::mutex> lock(controllerMutex);
+	targetMbps = target;
+}
+
+void RateController::reset(int rate) {
+	std::lock_guard<std::mutex> lock(controllerMutex);
+	frameRate = (std::max)(1, rate);
+	estimatedMbps = 0;
+	level = 0;
+	upgradeFrames = 0;
+	upgradePending = false;
+	framesSinceLevelChange = 0;
+	framesSinceScaleChange = 0;
+	fullFrameBytes = 0;
+	hasSample = false;
+	lastScaleDivisor = 1;
+	bufferBits = 0;
+	lastDrainUs = 0;
+	stats = RateControlCounters();
+}
+
+void RateController::setEstimatedBitrate(double mbps) {
+	std::lock_guard<std::mutex> lock(controllerMutex);
+	estimatedMbps = mbps;
+}
+
+double RateController::budget() const {
+	if (targetMbps > 0) {
+		return estimatedMbps > 0 ? (std::min)(targetMbps, estimatedMbps) : targetMbps;
+	}
+	return targetMbps < 0 ? estimatedMbps : 0;
+}
+
+double RateController::predictMbps(size_t index) const {
+	const RateLevel& rateLevel = RATE_LEVELS[index];
+	double frameBits = fullFrameBytes * 8 / (rateLevel.scaleDivisor * rateLevel.scaleDivisor);
+	return frameBits * frameRate / rateLevel.frameDivisor / 1e6;
+}
+
+// 마지막으로 비운 뒤 흐른 시간만큼 예산 속도로 가상 버퍼를 비움
+void RateController::drain(double budgetMbps) {
+	int64_t nowUs = steadyTimeUs();
+	if (budgetMbps > 0 && lastDrainUs > 0) {
+		bufferBits = (std::max)(0.0, bufferBits - budgetMbps * (nowUs - lastDrainUs));
+	}
+	lastDrainUs = nowUs;
+}
+
+RateDecision RateController::decide() {
+	std::lock_guard<std::mutex> lock(controllerMutex);
+	double budgetMbps = budget();
+	stats.targetMbps = targetMbps;
+	stats.estimatedMbps = estimatedMbps;
+	stats.budgetMbps = budgetMbps;
+	if (budgetMbps <= 0) {
+		level = 0;
+		upgradePending = false;
+		stats.decision = RateDecision();
+		return stats.decision;
+	}
+
+	drain(budgetMbps);
+	double bufferDelayMs = bufferBits / (budgetMbps * 1000);
+
+	size_t chosen = RATE_LEVEL_COUNT - 1;
+	for (size_t i = 0; i < RATE_LEVEL_COUNT; ++i) {
+		if (predictMbps(i) <= budgetMbps * BUDGET_HEADROOM) {
+			chosen = i;
+			break;
+		}
+	}
+	if (!hasSample) {
+		chosen = level;
+	}
+	if (bufferDelayMs > BUFFER_LIMIT_MS && framesSinceLevelChange >= BUFFER_SETTLE_FRAMES) {
+		chosen = (std::max)(chosen, (std::min)(level + 1, RATE_LEVEL_COUNT - 1));
+	}
+
+	// 올릴 수 있는 프레임 수는 실제로 내보낸 프레임만 셈 (record). 여기서는 이번 결정이 올릴 후보인지만 표시
+	size_t next = level;
+	upgradePending = false;
+	if (chosen > level) {
+		next = chosen;
+		upgradeFrames = 0;
+	}
+	else if (chosen < level && bufferDelayMs <= BUFFER_LIMIT_MS) {
+		upgradePending = true;
+		bool scaleUp = RATE_LEVELS[level - 1].scaleDivisor != RATE_LEVELS[level].scaleDivisor;
+		if (upgradeFrames >= UPGRADE_FRAMES && (!scaleUp || framesSinceScaleChange >= SCALE_HOLD_FRAMES)) {
+			next = level - 1;
+			upgradeFrames = 0;
+			upgradePending = false;
+		}
+	}
+	else {
+		upgradeFrames = 0;
+	}
+
+	if (next != level) {
+		stats.levelChanges++;
+		framesSinceLevelChange = 0;
+		if (RATE_LEVELS[next].scaleDivisor != RATE_LEVELS[level].scaleDivisor) {
+			stats.scaleChanges++;
+			framesSinceScaleChange = 0;
+		}
+		level = next;
+	}
+
+	RateDecision decision;
+	decision.frameDivisor = RATE_LEVELS[level].frameDivisor;
+	decision.scaleDivisor = RATE_LEVELS[level].scaleDivisor;
+	decision.compressBudgetRatio = predictMbps(level) > budgetMbps * EFFORT_THRESHOLD ? 1.0 : RELAXED_COMPRESS_BUDGET;
+
+	stats.bufferDelayMs = bufferDelayMs;
+	stats.decision = decision;
+	return decision;
+}
+
+void RateController::record(size_t frameBytes, const RateDecision& decision) {
+	std::lock_guard<std::mutex> lock(controllerMutex);
+	// decide()는 캡처 루프가 돌 때마다 (화면 변화가 없거나 프레임을 건너뛸 때도) 불리므로 프레임 수는 여기서 셈
+	stats.frames++;
+	framesSinceLevelChange++;
+	framesSinceScaleChange++;
+	if (upgradePending) {
+		upgradeFrames++;
+	}
+	drain(budget());
+	bufferBits += frameBytes * 8.0;
+
+	double frameMbps = frameBytes * 8.0 * frameRate / decision.frameDivisor / 1e6;
+	stats.measuredMbps += (frameMbps - stats.measuredMbps) * RATE_SMOOTHING;
+
+	// 해상도가 바뀐 첫 프레임은 0 프레임 기준이라 평소보다 훨씬 크므로 예측에 넣지 않음
+	bool keyFrame = !hasSample || decision.scaleDivisor != lastScaleDivisor;
+	lastScaleDivisor = decision.scaleDivisor;
+	if (keyFrame) {
+		hasSample = true;
+		return;
+	}
+	double fullBytes = static_cast<double>(frameBytes) * decision.scaleDivisor * decision.scaleDivisor;
+	fullFrameBytes += (fullBytes - fullFrameBytes) * (fullBytes > fullFrameBytes ? SIZE_RISE : SIZE_FALL);
+}
+
+RateControlCounters RateController::counters() {
+	std::lock_guard<std::mutex> lock(controllerMutex);
+	return stats;
+}
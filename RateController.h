@@ -0,0 +1,92 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+// 받는 쪽 수신 보고로 링크가 실제로 전달하는 속도를 추정
+// 큐 지연(패킷 전송 시간이 지금까지의 최소보다 늘어난 만큼)이나 손실이 크면 전달된 속도 아래로 낮추고
+// 큐가 비어 있고 추정치 가까이 보내고 있으면 조금씩 올려봄
+class BandwidthEstimator {
+public:
+	void reset();
+	// 받는 쪽의 누적값과 받는 쪽 시각 (us)
+	void report(long long bytesReceived, long long packetsReceived, long long packetsLost, long long totalTransitUs, int64_t timeUs);
+	// 0이면 아직 혼잡을 본 적이 없어 제한 없음
+	double estimateMbps() const { return estimate; }
+	double queueDelayMs() const { return queueDelay; }
+
+private:
+	bool hasReport = false;
+	long long lastBytes = 0;
+	long long lastReceived = 0;
+	long long lastLost = 0;
+	long long lastTransitUs = 0;
+	int64_t lastTimeUs = 0;
+	bool hasBaseTransit = false;
+	double baseTransitUs = 0;  // 보고 구간 평균 전송 시간의 최소 (큐가 빈 상태 + 시계 차이)
+	double queueDelay = 0;
+	int64_t lastBackoffUs = 0;
+	double capacity = 0;       // 마지막으로 밀렸을 때 (또는 그 뒤 추정치 가까이 보낼 때) 전달된 속도
+	double estimate = 0;
+};
+
+// 프레임마다 정하는 출력 설정
+struct RateDecision {
+	int frameDivisor = 1;             // 목표 fps를 이 값으로 나눔
+	int scaleDivisor = 1;             // 출력 해상도를 이 값으로 나눔
+	double compressBudgetRatio = 1;   // 압축에 쓸 프레임 시간 비율 (AccelerationController 예산)
+};
+
+// 누적 통계와 지금 상태
+struct RateControlCounters {
+	double targetMbps = 0;
+	double estimatedMbps = 0;
+	double budgetMbps = 0;       // 둘 중 작은 값 (0이면 제어 안 함)
+	double measuredMbps = 0;     // 최근 출력 비트레이트 (평활)
+	double bufferDelayMs = 0;    // 예산 속도로 비우는 가상 버퍼에 쌓인 양 (링크 큐 지연 추정)
+	RateDecision decision;
+	long long levelChanges = 0;
+	long long scaleChanges = 0;  // 해상도가 바뀐 횟수 (바뀔 때마다 기준 프레임을 다시 보냄)
+	long long frames = 0;        // 인코딩해 내보낸 프레임
+};
+
+// 비트레이트 예산 안에서 fps, 해상도, 압축 강도를 고름
+// 최근 프레임 크기(전체 해상도 기준으로 환산)로 단계별 비트레이트를 예측해 예산 안에 드는 가장 좋은 단계를 씀
+// 낮추는 것은 바로, 올리는 것은 여유가 한동안 이어질 때 한 단계씩 (해상도는 더 오래 기다림)
+class RateController {
+public:
+	// targetMbps: 0이면 끔, 음수면 고정 목표 없이 추정치만 따름
+	void configure(double targetMbps);
+	void reset(int frameRate);
+	void setEstimatedBitrate(double mbps);
+
+	// acquire 단계에서 캡처 루프가 돌 때마다 호출 (내보내지 않는 프레임 포함)
+	RateDecision decide();
+	// compress 단계에서 인코딩한 프레임마다 호출 (decision은 그 프레임에 쓴 설정)
+	void record(size_t frameBytes, const RateDecision& decision);
+
+	RateControlCounters counters();
+
+private:
+	double budget() const;
+	void drain(double budgetMbps);
+	double predictMbps(size_t level) const;
+
+	std::mutex controllerMutex;
+	double targetMbps = 0;
+	double estimatedMbps = 0;
+	int frameRate = 60;
+
+	size_t level = 0;
+	// 아래 프레임 수는 모두 record()한 (내보낸) 프레임 기준
+	int upgradeFrames = 0;         // 한 단계 위가 예산 안에 든 연속 프레임
+	bool upgradePending = false;   // 마지막 decide()에서 한 단계 위가 예산 안에 듦
+	int framesSinceLevelChange = 0;
+	int framesSinceScaleChange = 0;
+	double fullFrameBytes = 0;     // 최근 프레임 크기를 전체 해상도로 환산 (평활)
+	bool hasSample = false;
+	int lastScaleDivisor = 1;
+	double bufferBits = 0;
+	int64_t lastDrainUs = 0;       // 가상 버퍼를 마지막으로 비운 시각
+	RateControlCounters stats;
+};
@@ -0,0 +1,392 @@
+#include "SharedFrameRing.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <new>
+#include <thread>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <ctime>
+#endif
+#endif
+
+static size_t alignTo64(size_t size) {
+	return (size + 63) & ~static_cast<size_t>(63);
+}
+
+SharedFrameRing::~SharedFrameRing() {
+	close();
+}
+
+bool SharedFrameRing::create(const std::string& name, uint32_t slotCount, uint32_t maxFrameBytes) {
+	close();
+
+	uint32_t slots = 2;
+	while (slots < slotCount) {
+		slots <<= 1;
+	}
+	size_t headerSize = alignTo64(sizeof(SharedFrameRingHeader));
+	size_t slotSize = alignTo64(SHARED_FRAME_DATA_OFFSET + maxFrameBytes);
+	if (!map(name, headerSize + slots * slotSize, true)) {
+		return false;
+	}
+
+	// 남아 있던 링이면 generation을 이어서 올려 열어 둔 읽는 쪽이 다시 맞추게 함
+	// 읽는 쪽이 아직 붙어 있으므로 먼저 generation을 0(다시 만드는 중)으로 바꾼 뒤에 순번을 되돌림
+	SharedFrameRingHeader* existing = reinterpret_cast<SharedFrameRingHeader*>(base);
+	uint32_t generation = 1;
+	if (existing->magic == SHARED_FRAME_RING_MAGIC && existing->version == SHARED_FRAME_RING_VERSION) {
+		generation = (std::max)(existing->generation.load() + 1, 1u);
+		existing->generation.store(0);
+		header = existing;
+	}
+	else {
+		header = new (base) SharedFrameRingHeader();
+	}
+
+	// 이전 내용은 버리고 새로 초기화. magic은 마지막에 써서 읽는 쪽이 반쯤 만든 링을 열지 않게 함
+	header->magic = 0;
+	header->version = SHARED_FRAME_RING_VERSION;
+	header->slotCount = slots;
+	header->slotSize = static_cast<uint32_t>(slotSize);
+	header->headerSize = headerSize;
+	header->writeSequence.store(0);
+	header->writeSignal.store(0);
+	header->readerWaiting.store(0);
+	header->writerClosed.store(0);
+	header->readSequence.store(0);
+	header->readSignal.store(0);
+	header->writerWaiting.store(0);
+	header->generation.store(generation);
+	std::atomic_thread_fence(std::memory_order_release);
+	header->magic = SHARED_FRAME_RING_MAGIC;
+
+	writer = true;
+	closing = false;
+	dropped = 0;
+	// 이전 링에서 기다리던 읽는 쪽을 깨워 generation을 보게 함
+	header->writeSignal.fetch_add(1);
+	wakeSignal(header->writeSignal, writtenEvent);
+	return true;
+}
+
+bool SharedFrameRing::open(const std::string& name) {
+	close();
+
+	if (!map(name, 0, false)) {
+		return false;
+	}
+	std::atomic_thread_fence(std::memory_order_acquire);
+	header = reinterpret_cast<SharedFrameRingHeader*>(base);
+	if (mappingSize < sizeof(SharedFrameRingHeader) || header->magic != SHARED_FRAME_RING_MAGIC || header->version != SHARED_FRAME_RING_VERSION
+		|| mappingSize < header->headerSize + static_cast<size_t>(header->slotCount) * header->slotSize) {
+		close();
+		return false;
+	}
+
+	writer = false;
+	readGeneration = header->generation.load();
+	readPosition = header->readSequence.load();
+	holding = false;
+	layoutFits = true;
+	return true;
+}
+
+bool SharedFrameRing::syncGeneration() {
+	uint32_t generation = header->generation.load();
+	if (generation == 0) {
+		// 쓰는 쪽이 다시 만드는 중. 들고 있던 칸도 곧 덮어씀
+		holding = false;
+		return false;
+	}
+	if (generation != readGeneration) {
+		// 들고 있던 칸은 새 링이 덮어쓰므로 반납하지 않고 버림
+		readGeneration = generation;
+		readPosition = header->readSequence.load();
+		holding = false;
+		layoutFits = mappingSize >= header->headerSize + static_cast<size_t>(header->slotCount) * header->slotSize;
+	}
+	return layoutFits;
+}
+
+void SharedFrameRing::stop() {
+	if (!header || !writer) {
+		return;
+	}
+	closing = true;
+	header->writerClosed.store(1);
+	// 기다리던 읽는 쪽과 (이 프로세스의) write를 모두 깨움
+	header->writeSignal.fetch_add(1);
+	wakeSignal(header->writeSignal, writtenEvent);
+	header->readSignal.fetch_add(1);
+	wakeSignal(header->readSignal, readEvent);
+}
+
+void SharedFrameRing::close() {
+	stop();
+#if defined(_WIN32)
+	if (base) {
+		UnmapViewOfFile(base);
+	}
+	for (void** handle : { &mapping, &writtenEvent, &readEvent }) {
+		if (*handle) {
+			CloseHandle(*handle);
+			*handle = nullptr;
+		}
+	}
+#else
+	if (base) {
+		munmap(base, mappingSize);
+	}
+	// 이미 매핑한 읽는 쪽은 그대로 쓸 수 있음
+	if (writer && !mappingName.empty()) {
+		shm_unlink(mappingName.c_str());
+	}
+#endif
+	header = nullptr;
+	base = nullptr;
+	mappingSize = 0;
+	writer = false;
+	holding = false;
+	mappingName.clear();
+}
+
+bool SharedFrameRing::write(const FrameData& frameData) {
+	if (!header || !writer || closing) {
+		return false;
+	}
+	if (frameData.dataSize < 0 || SHARED_FRAME_DATA_OFFSET + static_cast<size_t>(frameData.dataSize) > header->slotSize) {
+		dropped++;
+		return false;
+	}
+
+	uint64_t sequence = header->writeSequence.load(std::memory_order_relaxed);
+	while (sequence - header->readSequence.load() >= header->slotCount) {
+		uint32_t signal = header->readSignal.load();
+		header->writerWaiting.store(1);
+		if (sequence - header->readSequence.load() < header->slotCount) {
+			header->writerWaiting.store(0);
+			break;
+		}
+		if (closing) {
+			header->writerWaiting.store(0);
+			dropped++;
+			return false;
+		}
+		waitSignal(header->readSignal, signal, -1, readEvent);
+		header->writerWaiting.store(0);
+	}
+
+	uint8_t* target = slot(sequence);
+	SharedFrameHeader* frame = reinterpret_cast<SharedFrameHeader*>(target);
+	frame->sequence = sequence;
+	frame->timeStamp = frameData.timeStamp;
+	frame->width = frameData.width;
+	frame->height = frameData.height;
+	frame->frameRate = frameData.frameRate;
+	frame->dataSize = frameData.dataSize;
+	memcpy(target + SHARED_FRAME_DATA_OFFSET, frameData.data, frameData.dataSize);
+
+	header->writeSequence.store(sequence + 1);
+	header->writeSignal.fetch_add(1);
+	if (header->readerWaiting.load()) {
+		wakeSignal(header->writeSignal, writtenEvent);
+	}
+	return true;
+}
+
+const SharedFrameHeader* SharedFrameRing::acquire(int timeoutMs) {
+	if (!header || writer || !syncGeneration()) {
+		return nullptr;
+	}
+	if (holding) {
+		return reinterpret_cast<const SharedFrameHeader*>(slot(readPosition));
+	}
+
+	auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+	while (true) {
+		// 프레임이 보여도 그 사이 링을 다시 만들었으면 (writeSequence가 되돌려졌을 수 있음) 새 링 기준으로 다시 봄
+		if (readPosition != header->writeSequence.load()) {
+			if (header->generation.load() == readGeneration) {
+				break;
+			}
+			if (!syncGeneration()) {
+				return nullptr;
+			}
+			continue;
+		}
+
+		if (header->writerClosed.load() || timeoutMs == 0) {
+			return nullptr;
+		}
+		int remainingMs = -1;
+		if (timeoutMs > 0) {
+			auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+			if (remaining <= 0) {
+				return nullptr;
+			}
+			remainingMs = static_cast<int>(remaining);
+		}
+
+		uint32_t signal = header->writeSignal.load();
+		header->readerWaiting.store(1);
+		if (readPosition == header->writeSequence.load() && !header->writerClosed.load()) {
+			waitSignal(header->writeSignal, signal, remainingMs, writtenEvent);
+		}
+		header->readerWaiting.store(0);
+		if (!syncGeneration()) {
+			return nullptr;
+		}
+	}
+
+	holding = true;
+	return reinterpret_cast<const SharedFrameHeader*>(slot(readPosition));
+}
+
+void SharedFrameRing::release() {
+	if (!header || !holding) {
+		return;
+	}
+	// 링을 다시 만들었으면 syncGeneration이 들고 있던 칸을 이미 버림
+	if (!syncGeneration() || !holding) {
+		return;
+	}
+	holding = false;
+	// 그 사이 쓰는 쪽이 링을 다시 만들어 readSequence를 되돌렸으면 덮어쓰지 않음 (쓰는 쪽이 영영 기다리게 됨)
+	uint64_t expected = readPosition++;
+	if (!header->readSequence.compare_exchange_strong(expected, readPosition)) {
+		return;
+	}
+	header->readSignal.fetch_add(1);
+	if (header->writerWaiting.load()) {
+		wakeSignal(header->readSignal, readEvent);
+	}
+}
+
+bool SharedFrameRing::map(const std::string& name, size_t size, bool create) {
+#if defined(_WIN32)
+	bool existed = false;
+	if (create) {
+		mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, static_cast<DWORD>(static_cast<uint64_t>(size) >> 32), static_cast<DWORD>(size), name.c_str());
+		// 같은 이름의 매핑이 남아 있으면 (이전 링을 연 읽는 쪽 등) 크기를 무시하고 기존 매핑을 돌려줌
+		existed = mapping && GetLastError() == ERROR_ALREADY_EXISTS;
+		writtenEvent = CreateEventA(nullptr, FALSE, FALSE, (name + "_written").c_str());
+		readEvent = CreateEventA(nullptr, FALSE, FALSE, (name + "_read").c_str());
+	}
+	else {
+		mapping = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, name.c_str());
+		writtenEvent = OpenEventA(EVENT_MODIFY_STATE | SYNCHRONIZE, FALSE, (name + "_written").c_str());
+		readEvent = OpenEventA(EVENT_MODIFY_STATE | SYNCHRONIZE, FALSE, (name + "_read").c_str());
+	}
+	if (!mapping || !writtenEvent || !readEvent) {
+		close();
+		return false;
+	}
+	base = static_cast<uint8_t*>(MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size));
+	if (!base) {
+		close();
+		return false;
+	}
+	if (!create) {
+		MEMORY_BASIC_INFORMATION info;
+		VirtualQuery(base, &info, sizeof(info));
+		size = info.RegionSize;
+	}
+	else if (existed) {
+		// 기존 매핑은 필요한 크기 이상이고, 다른 쓰는 쪽이 쓰는 중이 아니어야 다시 초기화해 씀
+		MEMORY_BASIC_INFORMATION info;
+		const SharedFrameRingHeader* existing = reinterpret_cast<const SharedFrameRingHeader*>(base);
+		bool usable = VirtualQuery(base, &info, sizeof(info)) == sizeof(info) && info.RegionSize >= size
+			&& !(existing->magic == SHARED_FRAME_RING_MAGIC && existing->writerClosed.load() == 0);
+		if (!usable) {
+			close();
+			return false;
+		}
+	}
+#else
+	// POSIX 공유 메모리 이름은 '/'로 시작
+	std::string shmName = name.empty() || name[0] != '/' ? "/" + name : name;
+	int fd = create ? shm_open(shmName.c_str(), O_CREAT | O_RDWR, 0600) : shm_open(shmName.c_str(), O_RDWR, 0);
+	if (fd < 0) {
+		return false;
+	}
+	if (create) {
+		// 같은 이름의 이전 링은 크기만 맞춤 (헤더의 generation은 create에서 이어서 씀)
+		if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+			::close(fd);
+			shm_unlink(shmName.c_str());
+			return false;
+		}
+	}
+	else {
+		struct stat info;
+		if (fstat(fd, &info) != 0) {
+			::close(fd);
+			return false;
+		}
+		size = static_cast<size_t>(info.st_size);
+	}
+	void* address = size > 0 ? mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED;
+	::close(fd);
+	if (address == MAP_FAILED) {
+		if (create) {
+			shm_unlink(shmName.c_str());
+		}
+		return false;
+	}
+	base = static_cast<uint8_t*>(address);
+	if (create) {
+		mappingName = shmName;
+	}
+#endif
+	mappingSize = size;
+	return true;
+}
+
+bool SharedFrameRing::waitSignal(std::atomic<uint32_t>& signal, uint32_t expected, int timeoutMs, void* event) {
+#if defined(_WIN32)
+	(void)signal;
+	(void)expected;
+	return WaitForSingleObject(event, timeoutMs < 0 ? INFINITE : static_cast<DWORD>(timeoutMs)) == WAIT_OBJECT_0;
+#elif defined(__linux__)
+	// 프로세스 사이에서 쓰므로 FUTEX_PRIVATE_FLAG 없이. 값이 이미 바뀌었으면 바로 반환
+	(void)event;
+	timespec timeout;
+	timeout.tv_sec = timeoutMs / 1000;
+	timeout.tv_nsec = static_cast<long>(timeoutMs % 1000) * 1000000;
+	return syscall(SYS_futex, reinterpret_cast<uint32_t*>(&signal), FUTEX_WAIT, expected, timeoutMs < 0 ? nullptr : &timeout, nullptr, 0) == 0;
+#else
+	(void)event;
+	auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+	while (signal.load() == expected) {
+		if (timeoutMs >= 0 && std::chrono::steady_clock::now() >= deadline) {
+			return false;
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	return true;
+#endif
+}
+
+void SharedFrameRing::wakeSignal(std::atomic<uint32_t>& signal, void* event) {
+#if defined(_WIN32)
+	(void)signal;
+	SetEvent(event);
+#elif defined(__linux__)
+	(void)event;
+	syscall(SYS_futex, reinterpret_cast<uint32_t*>(&signal), FUTEX_WAKE, 1, nullptr, nullptr, 0);
+#else
+	(void)signal;
+	(void)event;
+#endif
+}
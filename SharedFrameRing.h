@@ -0,0 +1,105 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "CaptureDLL.h"
+
+// 다른 프로세스로 인코딩된 프레임을 넘기는 이름 있는 공유 메모리 링
+// Windows: 파일 매핑 + 이름 있는 이벤트 (<name>_written, <name>_read)
+// 그 외: POSIX shm_open + futex (Linux, 그 밖에는 1ms 폴링)
+// 쓰는 쪽(캡처 프로세스) 하나, 읽는 쪽 하나. 읽는 쪽은 매핑 안의 프레임을 복사 없이 읽고 반납함
+//
+// 메모리 배치 (다른 언어에서 직접 매핑할 때 그대로 따름)
+//   [0, headerSize)             SharedFrameRingHeader
+//   [headerSize + i * slotSize)  칸 i = 순번 % slotCount: SharedFrameHeader, 64바이트부터 데이터
+const uint32_t SHARED_FRAME_RING_MAGIC = 0x52465343; // "CSFR"
+const uint32_t SHARED_FRAME_RING_VERSION = 2;
+const size_t SHARED_FRAME_DATA_OFFSET = 64; // 칸 시작에서 데이터까지
+
+struct SharedFrameRingHeader {
+	uint32_t magic;      // 초기화가 끝나면 마지막에 씀
+	uint32_t version;
+	uint32_t slotCount;  // 2의 거듭제곱
+	uint32_t slotSize;   // 칸 하나 크기 (64의 배수)
+	uint64_t headerSize; // 첫 칸까지의 바이트
+
+	alignas(64) std::atomic<uint64_t> writeSequence; // 다음에 쓸 순번 (쓰는 쪽)
+	std::atomic<uint32_t> writeSignal;               // 쓸 때마다 증가 (futex 대기 값)
+	std::atomic<uint32_t> readerWaiting;             // 읽는 쪽이 잠들려는 중
+	std::atomic<uint32_t> writerClosed;              // 쓰는 쪽이 멈춤. 남은 프레임을 읽으면 끝
+	std::atomic<uint32_t> generation;                // 같은 이름으로 다시 만들 때마다 증가. 바뀌면 읽는 쪽은 readSequence부터 다시 읽음
+
+	alignas(64) std::atomic<uint64_t> readSequence; // 다음에 반납할 순번 (읽는 쪽)
+	std::atomic<uint32_t> readSignal;               // 반납할 때마다 증가
+	std::atomic<uint32_t> writerWaiting;            // 쓰는 쪽이 자리를 기다리는 중
+};
+
+// 칸 하나의 프레임 정보
+struct SharedFrameHeader {
+	uint64_t sequence; // 쓴 순번 (링을 만든 뒤 0부터)
+	int64_t timeStamp;
+	int32_t width;
+	int32_t height;
+	int32_t frameRate;
+	int32_t dataSize;
+};
+
+class SharedFrameRing {
+public:
+	SharedFrameRing() = default;
+	SharedFrameRing(const SharedFrameRing&) = delete;
+	SharedFrameRing& operator=(const SharedFrameRing&) = delete;
+	~SharedFrameRing();
+
+	// 쓰는 쪽: 칸 slotCount개(2의 거듭제곱으로 올림), 프레임당 최대 maxFrameBytes인 링을 새로 만듦
+	// 같은 이름의 링이 남아 있으면 (열어 둔 읽는 쪽 등) generation을 올리고 순번을 0부터 다시 씀
+	// Windows에서 그 링이 작거나 다른 쓰는 쪽이 쓰는 중이면 false
+	bool create(const std::string& name, uint32_t slotCount, uint32_t maxFrameBytes);
+	// 읽는 쪽: 만들어진 링을 엶
+	bool open(const std::string& name);
+	// 쓰는 쪽: writerClosed를 알리고 기다리던 write를 깨움 (매핑은 그대로)
+	void stop();
+	// 매핑을 닫음. 쓰는 쪽은 stop도 함께
+	void close();
+	bool isOpen() const { return header != nullptr; }
+
+	// 쓰는 쪽: 빈 칸이 날 때까지 대기한 뒤 복사해 넣음
+	// 칸보다 크거나 기다리는 중에 stop되면 false (버림)
+	bool write(const FrameData& frameData);
+	long long droppedFrames() const { return dropped.load(); }
+
+	// 읽는 쪽: 다음 프레임. 데이터는 SHARED_FRAME_DATA_OFFSET 뒤에 이어짐 (data() 참고)
+	// timeoutMs < 0이면 무한 대기, 0이면 기다리지 않음. 시간이 지났거나 쓰는 쪽이 멈추고 비었으면 nullptr
+	// 반납 전에 다시 부르면 같은 프레임. 쓰는 쪽이 링을 다시 만들었으면 들고 있던 프레임은 버리고 새 링의 처음부터 읽음
+	// 다시 만든 링이 연 매핑보다 크면 쓰는 쪽이 멈춘 것처럼 nullptr (다시 열어야 함)
+	const SharedFrameHeader* acquire(int timeoutMs);
+	static const uint8_t* data(const SharedFrameHeader* frame) { return reinterpret_cast<const uint8_t*>(frame) + SHARED_FRAME_DATA_OFFSET; }
+	// 읽는 쪽: acquire한 프레임을 반납 (칸을 쓰는 쪽에 돌려줌)
+	void release();
+
+private:
+	bool map(const std::string& name, size_t size, bool create);
+	uint8_t* slot(uint64_t sequence) const { return base + header->headerSize + (sequence & (header->slotCount - 1)) * header->slotSize; }
+	// 읽는 쪽: 쓰는 쪽이 링을 다시 만들었으면 읽을 위치를 새 링에 맞춤. 새 링을 읽을 수 있으면 true
+	bool syncGeneration();
+	bool waitSignal(std::atomic<uint32_t>& signal, uint32_t expected, int timeoutMs, void* event);
+	void wakeSignal(std::atomic<uint32_t>& signal, void* event);
+
+	SharedFrameRingHeader* header = nullptr;
+	uint8_t* base = nullptr;
+	size_t mappingSize = 0;
+	bool writer = false;
+	std::atomic<bool> closing{ false };
+	std::atomic<long long> dropped{ 0 };
+	uint64_t readPosition = 0; // 읽는 쪽 전용
+	uint32_t readGeneration = 0;
+	bool holding = false;      // 읽는 쪽이 반납하지 않은 프레임이 있음
+	bool layoutFits = true;    // 지금 링의 칸이 연 매핑 안에 들어감
+
+	std::string mappingName;
+	void* mapping = nullptr;      // Windows 파일 매핑
+	void* writtenEvent = nullptr; // Windows: 쓰는 쪽이 알림
+	void* readEvent = nullptr;    // Windows: 읽는 쪽이 알림
+};
@@ -0,0 +1,58 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+// 단계 사이를 잇는 고정 크기 lock-free 링 버퍼 (생산자 하나, 소비자 하나)
+// 비었거나 가득 차면 std::atomic::wait로 잠들어 기다림
+template <typename T>
+class SpscRing {
+public:
+	// capacity는 2의 거듭제곱으로 올림
+	explicit SpscRing(size_t capacity) {
+		size_t size = 2;
+		while (size < capacity) {
+			size <<= 1;
+		}
+		items.reset(new T[size]);
+		mask = size - 1;
+	}
+
+	// 생산자 전용. 가득 차면 자리가 날 때까지 대기
+	void push(T&& item) {
+		size_t position = tail.load(std::memory_order_relaxed);
+		while (position - cachedHead > mask) {
+			cachedHead = head.load(std::memory_order_acquire);
+			if (position - cachedHead > mask) {
+				head.wait(cachedHead, std::memory_order_acquire);
+			}
+		}
+		items[position & mask] = std::move(item);
+		tail.store(position + 1, std::memory_order_release);
+		tail.notify_one();
+	}
+
+	// 소비자 전용. 비어 있으면 들어올 때까지 대기
+	void pop(T& item) {
+		size_t position = head.load(std::memory_order_relaxed);
+		while (position == cachedTail) {
+			cachedTail = tail.load(std::memory_order_acquire);
+			if (position == cachedTail) {
+				tail.wait(cachedTail, std::memory_order_acquire);
+			}
+		}
+		item = std::move(items[position & mask]);
+		head.store(position + 1, std::memory_order_release);
+		head.notify_one();
+	}
+
+private:
+	std::unique_ptr<T[]> items;
+	size_t mask;
+	// 위치는 서로 다른 캐시 라인에. 상대 쪽 위치는 각자 캐시해 두고 부족할 때만 다시 읽음
+	alignas(64) std::atomic<size_t> head{ 0 }; // 소비자가 다음에 꺼낼 위치
+	alignas(64) size_t cachedTail = 0;        // 소비자 전용
+	alignas(64) std::atomic<size_t> tail{ 0 }; // 생산자가 다음에 넣을 위치
+	alignas(64) size_t cachedHead = 0;        // 생산자 전용
+};
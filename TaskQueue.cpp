@@ -0,0 +1,69 @@
+#include "TaskQueue.h"
+
+TaskQueue::TaskQueue(size_t capacity) {
+	size_t size = 2;
+	while (size < capacity) {
+		size <<= 1;
+	}
+	cells.reset(new Cell[size]);
+	for (size_t i = 0; i < size; ++i) {
+		cells[i].sequence.store(i, std::memory_order_relaxed);
+	}
+	mask = size - 1;
+}
+
+bool TaskQueue::push(Task& task) {
+	size_t position = enqueuePosition.load(std::memory_order_relaxed);
+	Cell* cell;
+	while (true) {
+		cell = &cells[position & mask];
+		size_t sequence = cell->sequence.load(std::memory_order_acquire);
+		intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+		if (difference == 0) {
+			// 이 칸을 차지하면 채우는 동안 다른 쓰레드는 건드리지 않음
+			if (enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+				break;
+			}
+		}
+		else if (difference < 0) {
+			// 한 바퀴 전 항목이 아직 안 빠짐 = 가득 참
+			return false;
+		}
+		else {
+			position = enqueuePosition.load(std::memory_order_relaxed);
+		}
+	}
+	cell->task = std::move(task);
+	cell->sequence.store(position + 1, std::memory_order_release);
+	return true;
+}
+
+bool TaskQueue::pop(Task& task) {
+	size_t position = dequeuePosition.load(std::memory_order_relaxed);
+	Cell* cell;
+	while (true) {
+		cell = &cells[position & mask];
+		size_t sequence = cell->sequence.load(std::memory_order_acquire);
+		intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position + 1);
+		if (difference == 0) {
+			if (dequeuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+				break;
+			}
+		}
+		else if (difference < 0) {
+			// 아직 채워지지 않음 = 비어 있음
+			return false;
+		}
+		else {
+			position = dequeuePosition.load(std::memory_order_relaxed);
+		}
+	}
+	task = std::move(cell->task);
+	// 다음 바퀴의 push가 쓸 수 있도록 칸을 넘김
+	cell->sequence.store(position + mask + 1, std::memory_order_release);
+	return true;
+}
+
+bool TaskQueue::empty() const {
+	return enqueuePosition.load(std::memory_order_relaxed) == dequeuePosition.load(std::memory_order_relaxed);
+}
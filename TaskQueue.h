@@ -0,0 +1,125 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "ByteBuffer.h"
+
+// 이동만 가능한 void() 작업. 작은 람다는 내부 버퍼에 그대로 담아 힙 할당이 없음
+class Task {
+public:
+	// parallelFor 도우미와 프레임 전달 작업(FrameData + 버퍼 + lease)의 캡처가 여기에 들어감
+	static const size_t INLINE_SIZE = 96;
+
+	Task() = default;
+
+	template <typename F>
+		requires (!std::is_same_v<std::decay_t<F>, Task>)
+	Task(F&& function) {
+		using Function = std::decay_t<F>;
+		if constexpr (sizeof(Function) <= INLINE_SIZE && alignof(Function) <= alignof(std::max_align_t) && std::is_nothrow_move_constructible_v<Function>) {
+			new (storage) Function(std::forward<F>(function));
+			ops = &inlineOps<Function>;
+		}
+		else {
+			// 큰 캡처는 힙에 두고 포인터만 담음 (할당 통계에 포함)
+			countAllocation(sizeof(Function));
+			*reinterpret_cast<Function**>(storage) = new Function(std::forward<F>(function));
+			ops = &heapOps<Function>;
+		}
+	}
+
+	Task(Task&& other) noexcept : ops(other.ops) {
+		if (ops) {
+			ops->relocate(storage, other.storage);
+			other.ops = nullptr;
+		}
+	}
+
+	Task& operator=(Task&& other) noexcept {
+		if (this != &other) {
+			reset();
+			ops = other.ops;
+			if (ops) {
+				ops->relocate(storage, other.storage);
+				other.ops = nullptr;
+			}
+		}
+		return *this;
+	}
+
+	Task(const Task&) = delete;
+	Task& operator=(const Task&) = delete;
+
+	~Task() { reset(); }
+
+	explicit operator bool() const { return ops != nullptr; }
+
+	void operator()() { ops->invoke(storage); }
+
+	void reset() {
+		if (ops) {
+			ops->destroy(storage);
+			ops = nullptr;
+		}
+	}
+
+private:
+	struct Ops {
+		void (*invoke)(void* storage);
+		// dst로 옮기고 src는 파괴된 상태로 남김
+		void (*relocate)(void* dst, void* src);
+		void (*destroy)(void* storage);
+	};
+
+	template <typename Function>
+	static constexpr Ops inlineOps = {
+		[](void* storage) { (*std::launder(reinterpret_cast<Function*>(storage)))(); },
+		[](void* dst, void* src) {
+			Function* source = std::launder(reinterpret_cast<Function*>(src));
+			new (dst) Function(std::move(*source));
+			source->~Function();
+		},
+		[](void* storage) { std::launder(reinterpret_cast<Function*>(storage))->~Function(); },
+	};
+
+	template <typename Function>
+	static constexpr Ops heapOps = {
+		[](void* storage) { (**reinterpret_cast<Function**>(storage))(); },
+		[](void* dst, void* src) { *reinterpret_cast<Function**>(dst) = *reinterpret_cast<Function**>(src); },
+		[](void* storage) { delete *reinterpret_cast<Function**>(storage); },
+	};
+
+	alignas(std::max_align_t) unsigned char storage[INLINE_SIZE];
+	const Ops* ops = nullptr;
+};
+
+// 고정 크기 lock-free MPMC 큐 (칸마다 시퀀스 번호를 두는 링 버퍼)
+// 여러 쓰레드가 동시에 넣고 꺼낼 수 있고, 가득 차면 push가 false를 반환
+class TaskQueue {
+public:
+	// capacity는 2의 거듭제곱으로 올림
+	explicit TaskQueue(size_t capacity);
+
+	bool push(Task& task);
+	bool pop(Task& task);
+
+	// 비었는지 대략 확인 (다른 쓰레드가 동시에 바꿀 수 있음)
+	bool empty() const;
+
+private:
+	struct Cell {
+		std::atomic<size_t> sequence;
+		Task task;
+	};
+
+	std::unique_ptr<Cell[]> cells;
+	size_t mask;
+	// 넣는 쪽과 꺼내는 쪽 위치는 서로 다른 캐시 라인에
+	alignas(64) std::atomic<size_t> enqueuePosition{ 0 };
+	alignas(64) std::atomic<size_t> dequeuePosition{ 0 };
+};
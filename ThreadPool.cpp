@@ -0,0 +1,167 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+
+// 지금 쓰레드가 어느 풀의 몇 번 워커인지 (워커가 넣는 작업은 자기 큐로)
+static thread_local ThreadPool* currentPool = nullptr;
+static thread_local size_t currentWorker = 0;
+
+ThreadPool::ThreadPool(size_t threadCount) {
+	for (size_t i = 0; i < threadCount; ++i) {
+		workers.push_back(std::make_unique<Worker>());
+	}
+	// 모든 큐가 만들어진 뒤에 시작해야 훔치기가 안전함
+	for (size_t i = 0; i < threadCount; ++i) {
+		workers[i]->thread = std::thread([this, i] { workerLoop(i); });
+	}
+}
+
+ThreadPool::~ThreadPool() {
+	{
+		std::unique_lock<std::mutex> lock(sleepMutex);
+		stop = true;
+	}
+	condition.notify_all();
+	for (auto& worker : workers) {
+		worker->thread.join();
+	}
+}
+
+void ThreadPool::workerLoop(size_t index) {
+	currentPool = this;
+	currentWorker = index;
+
+	Task task;
+	while (true) {
+		if (takeTask(index, task)) {
+			pendingTasks.fetch_sub(1);
+			task();
+			task.reset();
+			continue;
+		}
+
+		// 잠들기 전에 잠깐 양보하며 다시 확인 (밴드 작업이 연달아 들어올 때 깨우는 비용을 줄임)
+		bool found = false;
+		for (int spin = 0; spin < 64 && !found; ++spin) {
+			std::this_thread::yield();
+			found = pendingTasks.load() > 0;
+		}
+		if (found) {
+			continue;
+		}
+
+		// 남은 작업을 다 비운 뒤에만 종료
+		if (stop && pendingTasks.load() == 0) {
+			return;
+		}
+
+		// sleepingWorkers를 먼저 올려야 submit이 깨우기를 빠뜨리지 않음
+		sleepingWorkers.fetch_add(1);
+		{
+			std::unique_lock<std::mutex> lock(sleepMutex);
+			condition.wait(lock, [this] { return stop || pendingTasks.load() > 0; });
+		}
+		sleepingWorkers.fetch_sub(1);
+	}
+}
+
+void ThreadPool::submit(Task task) {
+	if (workers.empty()) {
+		task();
+		return;
+	}
+
+	size_t index = currentPool == this ? currentWorker : nextWorker.fetch_add(1, std::memory_order_relaxed) % workers.size();
+
+	// 꺼내는 쪽이 먼저 줄이지 않도록 넣기 전에 올림
+	pendingTasks.fetch_add(1);
+	if (!workers[index]->queue.push(task)) {
+		std::lock_guard<std::mutex> lock(overflowMutex);
+		overflowTasks.push_back(std::move(task));
+		overflowCount.fetch_add(1);
+	}
+
+	if (sleepingWorkers.load() > 0) {
+		// 잠들려던 워커가 조건을 확인하는 중이면 그 확인이 끝난 뒤에 알림
+		{
+			std::lock_guard<std::mutex> lock(sleepMutex);
+		}
+		condition.notify_one();
+	}
+}
+
+bool ThreadPool::takeTask(size_t index, Task& task) {
+	// 자기 큐 -> 다른 워커 큐 -> 넘친 작업 순서
+	if (workers[index]->queue.pop(task)) {
+		return true;
+	}
+	for (size_t i = 1; i < workers.size(); ++i) {
+		if (workers[(index + i) % workers.size()]->queue.pop(task)) {
+			return true;
+		}
+	}
+	if (overflowCount.load() > 0) {
+		std::lock_guard<std::mutex> lock(overflowMutex);
+		if (!overflowTasks.empty()) {
+			task = std::move(overflowTasks.front());
+			overflowTasks.pop_front();
+			overflowCount.fetch_sub(1);
+			return true;
+		}
+	}
+	return false;
+}
+
+void ThreadPool::runParallelForItems(ParallelForState& state) {
+	size_t index;
+	while ((index = state.next.fetch_add(1)) < state.count) {
+		state.invoke(state.body, index);
+	}
+}
+
+void ThreadPool::runParallelFor(ParallelForState& state) {
+	if (state.count == 0) {
+		return;
+	}
+
+	// 늦게 시작한 도우미는 남은 항목이 없으면 body에 손대지 않고 바로 끝남
+	// 캡처가 포인터 하나라 Task 안에 들어가므로 힙 할당이 없음
+	size_t helpers = (std::min)(workers.size(), state.count - 1);
+	state.unfinishedHelpers = helpers;
+	for (size_t i = 0; i < helpers; ++i) {
+		enqueueTask([state = &state] {
+			runParallelForItems(*state);
+			// 잠금을 쥔 채로 줄이고 알려야 기다리는 쪽이 그 뒤에 state를 없앰
+			std::lock_guard<std::mutex> lock(state->helperMutex);
+			if (--state->unfinishedHelpers == 0) {
+				state->helperCondition.notify_one();
+			}
+		});
+	}
+	runParallelForItems(state);
+
+	// 모든 도우미가 끝나야 state(스택)를 없앨 수 있음. 아직 큐에 있는 도우미는 기다리지 않고 여기서 꺼내 실행
+	// (다른 parallelFor의 도우미를 실행할 수도 있지만 모두 짧은 항목들)
+	size_t index = currentPool == this ? currentWorker : 0;
+	Task task;
+	while (true) {
+		{
+			std::unique_lock<std::mutex> lock(state.helperMutex);
+			if (state.unfinishedHelpers == 0) {
+				return;
+			}
+		}
+		if (takeTask(index, task)) {
+			pendingTasks.fetch_sub(1);
+			task();
+			task.reset();
+			continue;
+		}
+		// 남은 도우미는 다른 워커가 실행 중. 혹시 못 본 작업이 있으면 잠깐 뒤 다시 찾음
+		std::unique_lock<std::mutex> lock(state.helperMutex);
+		state.helperCondition.wait_for(lock, std::chrono::milliseconds(1), [&state] { return state.unfinishedHelpers == 0; });
+	}
+}
@@ -0,0 +1,78 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "TaskQueue.h"
+
+// 쓰레드 풀 클래스 정의
+// 워커마다 lock-free 큐를 두고, 자기 큐가 비면 다른 워커의 큐에서 훔쳐옴
+class ThreadPool {
+private:
+	// 워커 하나당 큐 칸 수. 넘치면 잠금 큐로 넘김
+	static const size_t WORKER_QUEUE_CAPACITY = 1024;
+
+	struct Worker {
+		TaskQueue queue{ WORKER_QUEUE_CAPACITY };
+		std::thread thread;
+	};
+
+	std::vector<std::unique_ptr<Worker>> workers;
+	std::deque<Task> overflowTasks;
+	std::mutex overflowMutex;
+	std::atomic<size_t> overflowCount{ 0 };
+
+	// 들어와서 아직 꺼내지 않은 작업 수. 잠든 워커는 이것만 보고 깨어남
+	std::atomic<size_t> pendingTasks{ 0 };
+	std::atomic<size_t> sleepingWorkers{ 0 };
+	std::atomic<size_t> nextWorker{ 0 };
+	std::mutex sleepMutex;
+	std::condition_variable condition;
+	std::atomic<bool> stop{ false };
+
+	// parallelFor 한 번의 상태. 호출한 쓰레드의 스택에 두고 도우미는 포인터만 들고 감
+	struct ParallelForState {
+		size_t count = 0;
+		void* body = nullptr;
+		void (*invoke)(void* body, size_t index) = nullptr;
+		std::atomic<size_t> next{ 0 };
+		// 아직 끝나지 않은 (시작하지 않은 것 포함) 도우미 수. 0이 되기 전에는 state를 없애면 안 됨
+		size_t unfinishedHelpers = 0;
+		std::mutex helperMutex;
+		std::condition_variable helperCondition;
+	};
+
+	void workerLoop(size_t index);
+	void submit(Task task);
+	bool takeTask(size_t index, Task& task);
+	void runParallelFor(ParallelForState& state);
+	static void runParallelForItems(ParallelForState& state);
+
+public:
+	explicit ThreadPool(size_t threadCount);
+	~ThreadPool();
+
+	template <typename F>
+	void enqueueTask(F&& task) {
+		submit(Task(std::forward<F>(task)));
+	}
+
+	// body(0..count-1)을 워커들에 나눠 실행하고 모두 끝날 때까지 대기
+	// 호출한 쓰레드도 같이 일하므로 워커 안에서 호출해도 교착되지 않음
+	// body는 복사하지 않고 참조만 하며, 호출마다 힙 할당이 없음
+	template <typename Body>
+	void parallelFor(size_t count, Body&& body) {
+		ParallelForState state;
+		state.count = count;
+		state.body = const_cast<void*>(static_cast<const void*>(&body));
+		state.invoke = [](void* body, size_t index) { (*static_cast<std::remove_reference_t<Body>*>(body))(index); };
+		runParallelFor(state);
+	}
+
+	size_t size() const { return workers.size(); }
+};
@@ -0,0 +1,159 @@
+#include "TileDiff.h"
+
+#include <algorithm>
+#include <cstring>
+#include <emmintrin.h>
+
+int TileGrid::tileWidth(int tileX) const {
+	return std::min(tileSize, frameWidth - tileX * tileSize);
+}
+
+int TileGrid::tileHeight(int tileY) const {
+	return std::min(tileSize, frameHeight - tileY * tileSize);
+}
+
+TileGrid makeTileGrid(int frameWidth, int frameHeight, int tileSize) {
+	TileGrid grid;
+	grid.frameWidth = frameWidth;
+	grid.frameHeight = frameHeight;
+	grid.tileSize = tileSize;
+	grid.tilesX = (frameWidth + tileSize - 1) / tileSize;
+	grid.tilesY = (frameHeight + tileSize - 1) / tileSize;
+	return grid;
+}
+
+// 타일 한 행(수백 바이트)을 비교. 짧은 구간이라 memcmp 호출보다 인라인 SSE2가 빠름
+static inline bool rowEqual(const uint8_t* a, const uint8_t* b, size_t size) {
+	size_t i = 0;
+	__m128i acc = _mm_setzero_si128();
+
+	for (; i + 64 <= size; i += 64) {
+		__m128i x0 = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)), _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i)));
+		__m128i x1 = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i + 16)), _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i + 16)));
+		__m128i x2 = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i + 32)), _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i + 32)));
+		__m128i x3 = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i + 48)), _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i + 48)));
+		acc = _mm_or_si128(acc, _mm_or_si128(_mm_or_si128(x0, x1), _mm_or_si128(x2, x3)));
+	}
+	for (; i + 16 <= size; i += 16) {
+		acc = _mm_or_si128(acc, _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)), _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i))));
+	}
+
+	if (_mm_movemask_epi8(_mm_cmpeq_epi8(acc, _mm_setzero_si128())) != 0xFFFF) {
+		return false;
+	}
+	return i == size || memcmp(a + i, b + i, size - i) == 0;
+}
+
+// 타일 한 줄(tileY)을 비교해 tileDirty[tilesX]에 표시. 반환값: 변경된 타일 수
+static int detectDirtyTileRow(const uint8_t* currentFrame, const uint8_t* previousFrame, const TileGrid& grid, int tileY, uint8_t* tileDirty) {
+	const size_t stride = (size_t)grid.frameWidth * 4;
+	int dirtyCount = 0;
+
+	// 행 단위로 순차 접근해 하드웨어 프리페처가 따라오도록 함
+	int rowBegin = tileY * grid.tileSize;
+	int rowEnd = rowBegin + grid.tileHeight(tileY);
+	for (int y = rowBegin; y < rowEnd && dirtyCount < grid.tilesX; ++y) {
+		const uint8_t* currRow = currentFrame + y * stride;
+		const uint8_t* prevRow = previousFrame + y * stride;
+
+		for (int tileX = 0; tileX < grid.tilesX; ++tileX) {
+			if (tileDirty[tileX]) {
+				continue; // early-out: 이미 변경된 타일
+			}
+			size_t offset = (size_t)tileX * grid.tileSize * 4;
+			if (!rowEqual(currRow + offset, prevRow + offset, (size_t)grid.tileWidth(tileX) * 4)) {
+				tileDirty[tileX] = 1;
+				++dirtyCount;
+			}
+		}
+	}
+
+	return dirtyCount;
+}
+
+int detectDirtyTiles(const uint8_t* currentFrame, const uint8_t* previousFrame, const TileGrid& grid, ByteBuffer& dirtyBitmap, ThreadPool* pool) {
+	// 타일 줄마다 독립적으로 비교하고, 비트맵은 바이트를 공유하므로 마지막에 한 번에 만듦
+	// 작업 버퍼는 호출 쓰레드(diff 단계)마다 하나를 계속 씀. 워커에서는 thread_local 이름이 워커 것을 가리키므로 포인터로 넘김
+	static thread_local ByteBuffer tileDirtyBuffer;
+	tileDirtyBuffer.assign(grid.tileCount(), 0);
+	uint8_t* tileDirty = tileDirtyBuffer.data();
+	auto detectRow = [&](size_t tileY) {
+		detectDirtyTileRow(currentFrame, previousFrame, grid, (int)tileY, &tileDirty[tileY * grid.tilesX]);
+	};
+
+	if (pool) {
+		pool->parallelFor(grid.tilesY, detectRow);
+	}
+	else {
+		for (int tileY = 0; tileY < grid.tilesY; ++tileY) {
+			detectRow(tileY);
+		}
+	}
+
+	dirtyBitmap.assign(grid.bitmapSize(), 0);
+	int dirtyCount = 0;
+	for (int tileIndex = 0; tileIndex < grid.tileCount(); ++tileIndex) {
+		if (tileDirty[tileIndex]) {
+			markTileDirty(dirtyBitmap.data(), tileIndex);
+			++dirtyCount;
+		}
+	}
+
+	return dirtyCount;
+}
+
+void packDirtyTiles(const uint8_t* currentFrame, const TileGrid& grid, const uint8_t* dirtyBitmap, ByteBuffer& tilePixels) {
+	const size_t stride = (size_t)grid.frameWidth * 4;
+	tilePixels.resize(dirtyTilePixelSize(grid, dirtyBitmap)); // 재사용 버퍼면 용량 안에서 끝남
+	size_t offset = 0;
+
+	for (int tileY = 0; tileY < grid.tilesY; ++tileY) {
+		for (int tileX = 0; tileX < grid.tilesX; ++tileX) {
+			if (!isTileDirty(dirtyBitmap, tileY * grid.tilesX + tileX)) {
+				continue;
+			}
+
+			size_t rowSize = (size_t)grid.tileWidth(tileX) * 4;
+			int height = grid.tileHeight(tileY);
+			const uint8_t* src = currentFrame + (size_t)tileY * grid.tileSize * stride + (size_t)tileX * grid.tileSize * 4;
+
+			for (int y = 0; y < height; ++y) {
+				memcpy(&tilePixels[offset + y * rowSize], src + y * stride, rowSize);
+			}
+			offset += rowSize * height;
+		}
+	}
+}
+
+size_t dirtyTilePixelSize(const TileGrid& grid, const uint8_t* dirtyBitmap) {
+	size_t size = 0;
+	for (int tileY = 0; tileY < grid.tilesY; ++tileY) {
+		for (int tileX = 0; tileX < grid.tilesX; ++tileX) {
+			if (isTileDirty(dirtyBitmap, tileY * grid.tilesX + tileX)) {
+				size += (size_t)grid.tileWidth(tileX) * grid.tileHeight(tileY) * 4;
+			}
+		}
+	}
+	return size;
+}
+
+void unpackDirtyTiles(uint8_t* frame, const TileGrid& grid, const uint8_t* dirtyBitmap, const uint8_t* tilePixels) {
+	const size_t stride = (size_t)grid.frameWidth * 4;
+
+	for (int tileY = 0; tileY < grid.tilesY; ++tileY) {
+		for (int tileX = 0; tileX < grid.tilesX; ++tileX) {
+			if (!isTileDirty(dirtyBitmap, tileY * grid.tilesX + tileX)) {
+				continue;
+			}
+
+			size_t rowSize = (size_t)grid.tileWidth(tileX) * 4;
+			int height = grid.tileHeight(tileY);
+			uint8_t* dst = frame + (size_t)tileY * grid.tileSize * stride + (size_t)tileX * grid.tileSize * 4;
+
+			for (int y = 0; y < height; ++y) {
+				memcpy(dst + y * stride, tilePixels, rowSize);
+				tilePixels += rowSize;
+			}
+		}
+	}
+}
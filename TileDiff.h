@@ -0,0 +1,58 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "ByteBuffer.h"
+#include "ThreadPool.h"
+
+// 프레임을 tileSize x tileSize 픽셀(BGRA) 격자로 나눈 정보. 오른쪽/아래 가장자리 타일은 잘릴 수 있음
+struct TileGrid {
+	int frameWidth = 0;
+	int frameHeight = 0;
+	int tileSize = 0;
+	int tilesX = 0;
+	int tilesY = 0;
+
+	int tileCount() const { return tilesX * tilesY; }
+	int tileWidth(int tileX) const;
+	int tileHeight(int tileY) const;
+	size_t bitmapSize() const { return (size_t)(tileCount() + 7) / 8; }
+};
+
+TileGrid makeTileGrid(int frameWidth, int frameHeight, int tileSize);
+
+inline bool isTileDirty(const uint8_t* dirtyBitmap, int tileIndex) {
+	return (dirtyBitmap[tileIndex >> 3] >> (tileIndex & 7)) & 1;
+}
+
+inline void markTileDirty(uint8_t* dirtyBitmap, int tileIndex) {
+	dirtyBitmap[tileIndex >> 3] |= (uint8_t)(1 << (tileIndex & 7));
+}
+
+// 타일 단위로 비교해 변경된 타일을 비트맵에 표시. 이미 변경된 타일의 나머지 행은 비교하지 않음
+// pool이 있으면 타일 줄 단위로 나눠 병렬 처리. 반환값: 변경된 타일 수
+int detectDirtyTiles(const uint8_t* currentFrame, const uint8_t* previousFrame, const TileGrid& grid, ByteBuffer& dirtyBitmap, ThreadPool* pool = nullptr);
+
+// 변경된 타일의 픽셀만 타일 순서(행 우선)대로 이어붙임
+void packDirtyTiles(const uint8_t* currentFrame, const TileGrid& grid, const uint8_t* dirtyBitmap, ByteBuffer& tilePixels);
+
+// 비트맵에 표시된 타일들의 픽셀 바이트 수
+size_t dirtyTilePixelSize(const TileGrid& grid, const uint8_t* dirtyBitmap);
+
+// 수신 측: 패킹된 타일 픽셀을 프레임에 다시 씀
+void unpackDirtyTiles(uint8_t* frame, const TileGrid& grid, const uint8_t* dirtyBitmap, const uint8_t* tilePixels);
+
+#pragma pack(push, 1)
+// ENCODE_TILE 페이로드: TileFrameHeader | 비트맵(bitmapSize 바이트) | 타일 픽셀 LZ4 블록들
+// 타일 픽셀은 FUSED_BLOCK_SIZE 단위로 잘라 XOR 모드와 같은 (int32 압축 크기 | LZ4 블록) 형식으로 이어붙임
+struct TileFrameHeader {
+	uint16_t tileSize;
+	uint16_t tilesX;
+	uint16_t tilesY;
+	uint8_t channelLayout; // 타일 픽셀 블록의 채널 배치 (ChannelLayout)
+	uint8_t flags; // FRAME_FLAG_* (FrameCodec.h)
+	uint32_t dirtyTileCount;
+	uint32_t rawPixelSize; // 압축 전 타일 픽셀 크기
+};
+#pragma pack(pop)
@@ -0,0 +1,184 @@
+#include "TileHash.h"
+#include "CpuFeatures.h"
+
+#include <cstring>
+#include <nmmintrin.h>
+
+static const uint32_t CRC32C_POLY = 0x82F63B78; // Castagnoli (reflected)
+
+struct Crc32cTable {
+	uint32_t table[8][256];
+
+	Crc32cTable() {
+		for (uint32_t i = 0; i < 256; ++i) {
+			uint32_t crc = i;
+			for (int k = 0; k < 8; ++k) {
+				crc = (crc >> 1) ^ (CRC32C_POLY & (0 - (crc & 1)));
+			}
+			table[0][i] = crc;
+		}
+		for (uint32_t i = 0; i < 256; ++i) {
+			for (int t = 1; t < 8; ++t) {
+				table[t][i] = (table[t - 1][i] >> 8) ^ table[0][table[t - 1][i] & 0xFF];
+			}
+		}
+	}
+};
+
+static const Crc32cTable crcTable;
+
+// _mm_crc32_u64와 같은 결과 (slicing-by-8)
+static inline uint32_t crc32cSoftware64(uint32_t crc, uint64_t value) {
+	uint64_t x = crc ^ value;
+	return crcTable.table[7][x & 0xFF] ^ crcTable.table[6][(x >> 8) & 0xFF]
+		^ crcTable.table[5][(x >> 16) & 0xFF] ^ crcTable.table[4][(x >> 24) & 0xFF]
+		^ crcTable.table[3][(x >> 32) & 0xFF] ^ crcTable.table[2][(x >> 40) & 0xFF]
+		^ crcTable.table[1][(x >> 48) & 0xFF] ^ crcTable.table[0][x >> 56];
+}
+
+static inline uint32_t crc32cSoftware32(uint32_t crc, uint32_t value) {
+	uint32_t x = crc ^ value;
+	return crcTable.table[3][x & 0xFF] ^ crcTable.table[2][(x >> 8) & 0xFF]
+		^ crcTable.table[1][(x >> 16) & 0xFF] ^ crcTable.table[0][x >> 24];
+}
+
+TARGET_SSE42
+static inline uint32_t crc32cHardware64(uint32_t crc, uint64_t value) {
+#if defined(_M_X64) || defined(__x86_64__)
+	return static_cast<uint32_t>(_mm_crc32_u64(crc, value));
+#else
+	crc = _mm_crc32_u32(crc, static_cast<uint32_t>(value));
+	return _mm_crc32_u32(crc, static_cast<uint32_t>(value >> 32));
+#endif
+}
+
+TARGET_SSE42
+static inline uint32_t crc32cHardware32(uint32_t crc, uint32_t value) {
+	return _mm_crc32_u32(crc, value);
+}
+
+static inline uint64_t load64(const uint8_t* p) {
+	uint64_t value;
+	memcpy(&value, p, sizeof(value));
+	return value;
+}
+
+static inline uint32_t load32(const uint8_t* p) {
+	uint32_t value;
+	memcpy(&value, p, sizeof(value));
+	return value;
+}
+
+// crc32 명령은 지연 3/처리량 1이므로 세 개의 독립 체인을 번갈아 돌림
+template <uint32_t (*Crc64)(uint32_t, uint64_t), uint32_t (*Crc32)(uint32_t, uint32_t)>
+static inline void hashLanes(const uint8_t* data, size_t size, uint32_t& a, uint32_t& b, uint32_t& c) {
+	size_t i = 0;
+	for (; i + 24 <= size; i += 24) {
+		a = Crc64(a, load64(data + i));
+		b = Crc64(b, load64(data + i + 8));
+		c = Crc64(c, load64(data + i + 16));
+	}
+	for (; i + 8 <= size; i += 8) {
+		a = Crc64(a, load64(data + i));
+	}
+	for (; i < size; i += 4) { // 픽셀(4바이트) 단위라 항상 나누어 떨어짐
+		b = Crc32(b, load32(data + i));
+	}
+}
+
+static inline uint64_t finishLanes(uint32_t a, uint32_t b, uint32_t c) {
+	uint32_t hi = a ^ ((c << 13) | (c >> 19));
+	uint32_t lo = b ^ c;
+	return ((uint64_t)hi << 32) | lo;
+}
+
+template <uint32_t (*Crc64)(uint32_t, uint64_t), uint32_t (*Crc32)(uint32_t, uint32_t)>
+static uint64_t hashTileImpl(const uint8_t* frame, const TileGrid& grid, int tileX, int tileY) {
+	const size_t stride = (size_t)grid.frameWidth * 4;
+	const size_t rowSize = (size_t)grid.tileWidth(tileX) * 4;
+	const int height = grid.tileHeight(tileY);
+	const uint8_t* src = frame + (size_t)tileY * grid.tileSize * stride + (size_t)tileX * grid.tileSize * 4;
+
+	uint32_t a = 0xFFFFFFFF, b = 0x9E3779B9, c = 0x7F4A7C15;
+	for (int y = 0; y < height; ++y) {
+		hashLanes<Crc64, Crc32>(src + y * stride, rowSize, a, b, c);
+	}
+	return finishLanes(a, b, c);
+}
+
+template <uint32_t (*Crc64)(uint32_t, uint64_t), uint32_t (*Crc32)(uint32_t, uint32_t)>
+static uint64_t hashBytesImpl(const uint8_t* data, size_t size) {
+	uint32_t a = 0xFFFFFFFF, b = 0x9E3779B9, c = 0x7F4A7C15;
+	hashLanes<Crc64, Crc32>(data, size, a, b, c);
+	return finishLanes(a, b, c);
+}
+
+static const bool hasSse42 = getCpuFeatures().sse42;
+
+uint64_t hashTile(const uint8_t* frame, const TileGrid& grid, int tileX, int tileY) {
+	if (hasSse42) {
+		return hashTileImpl<crc32cHardware64, crc32cHardware32>(frame, grid, tileX, tileY);
+	}
+	return hashTileImpl<crc32cSoftware64, crc32cSoftware32>(frame, grid, tileX, tileY);
+}
+
+uint64_t hashBytes(const uint8_t* data, size_t size) {
+	if (hasSse42) {
+		return hashBytesImpl<crc32cHardware64, crc32cHardware32>(data, size);
+	}
+	return hashBytesImpl<crc32cSoftware64, crc32cSoftware32>(data, size);
+}
+
+void TileHashTable::reset(const TileGrid& newGrid) {
+	grid = newGrid;
+	hashes.assign(grid.tileCount(), 0);
+	initialized = false;
+}
+
+bool TileHashTable::matches(const TileGrid& other) const {
+	return grid.frameWidth == other.frameWidth && grid.frameHeight == other.frameHeight && grid.tileSize == other.tileSize;
+}
+
+int TileHashTable::detectDirtyTiles(const uint8_t* currentFrame, const TileGrid& currentGrid, ByteBuffer& dirtyBitmap, ThreadPool* pool) {
+	if (!matches(currentGrid) || hashes.size() != (size_t)currentGrid.tileCount()) {
+		reset(currentGrid);
+	}
+
+	// 타일 줄마다 자기 칸의 해시만 갱신하므로 병렬로 돌려도 겹치지 않음
+	static thread_local ByteBuffer tileDirtyBuffer;
+	tileDirtyBuffer.assign(grid.tileCount(), 0);
+	uint8_t* tileDirty = tileDirtyBuffer.data();
+	auto hashRow = [&](size_t tileY) {
+		for (int tileX = 0; tileX < grid.tilesX; ++tileX) {
+			int tileIndex = (int)tileY * grid.tilesX + tileX;
+			uint64_t hash = hashTile(currentFrame, grid, tileX, (int)tileY);
+
+			// 첫 프레임은 전부 변경된 것으로 취급 (수신 측에 기준 프레임이 없음)
+			if (!initialized || hash != hashes[tileIndex]) {
+				hashes[tileIndex] = hash;
+				tileDirty[tileIndex] = 1;
+			}
+		}
+	};
+
+	if (pool) {
+		pool->parallelFor(grid.tilesY, hashRow);
+	}
+	else {
+		for (int tileY = 0; tileY < grid.tilesY; ++tileY) {
+			hashRow(tileY);
+		}
+	}
+	initialized = true;
+
+	dirtyBitmap.assign(grid.bitmapSize(), 0);
+	int dirtyCount = 0;
+	for (int tileIndex = 0; tileIndex < grid.tileCount(); ++tileIndex) {
+		if (tileDirty[tileIndex]) {
+			markTileDirty(dirtyBitmap.data(), tileIndex);
+			++dirtyCount;
+		}
+	}
+
+	return dirtyCount;
+}
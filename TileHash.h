@@ -0,0 +1,28 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "TileDiff.h"
+
+// 타일 내용 해시 (CRC32C 3-lane, SSE4.2 미지원 CPU는 테이블 구현으로 같은 값 계산)
+uint64_t hashTile(const uint8_t* frame, const TileGrid& grid, int tileX, int tileY);
+
+// 연속된 바이트 구간 해시 (size는 4의 배수). 같은 알고리즘이라 한 행짜리 타일과 값이 같음
+uint64_t hashBytes(const uint8_t* data, size_t size);
+
+// 타일별 마지막 해시를 보관. 이전 프레임 전체 대신 타일당 8바이트만 유지
+class TileHashTable {
+public:
+	void reset(const TileGrid& grid);
+	bool matches(const TileGrid& grid) const;
+
+	// 현재 프레임의 타일 해시를 계산해 바뀐 타일을 비트맵에 표시하고 테이블을 갱신
+	// pool이 있으면 타일 줄 단위로 병렬 처리. 반환값: 변경된 타일 수
+	int detectDirtyTiles(const uint8_t* currentFrame, const TileGrid& grid, ByteBuffer& dirtyBitmap, ThreadPool* pool = nullptr);
+
+private:
+	TileGrid grid;
+	std::vector<uint64_t> hashes;
+	bool initialized = false;
+};
@@ -0,0 +1,464 @@
+#include "UdpStream.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <vector>
+
+#include "Log.h"
+
+#if defined(_WIN32)
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "ws2_32.lib")
+#else
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+
+#if defined(_WIN32)
+typedef SOCKET NativeSocket;
+#else
+typedef int NativeSocket;
+#endif
+
+static NativeSocket nativeSocket(intptr_t socketHandle) {
+	return static_cast<NativeSocket>(socketHandle);
+}
+
+// 한 프레임의 패킷을 나눠 보내는 구간 (나머지는 다음 프레임 전 여유)
+static const double UDP_PACING_FRACTION = 0.8;
+// 이보다 짧은 간격은 자지 않고 몰아서 보냄 (OS 타이머 해상도)
+static const auto UDP_PACING_MIN_SLEEP = std::chrono::microseconds(500);
+// 보낼 버퍼가 가득 찼을 때 프레임 간격이 지났어도 패킷마다 이만큼은 자리가 나길 기다림
+static const auto UDP_SEND_BLOCK_MIN_WAIT = std::chrono::milliseconds(1);
+// 소켓 버퍼. 한 번에 보내는 묶음과 받는 쪽이 처리하지 못한 프레임 몇 개를 담음
+static const int UDP_SEND_BUFFER_BYTES = 4 * 1024 * 1024;
+static const int UDP_RECEIVE_BUFFER_BYTES = 16 * 1024 * 1024;
+// 받는 쓰레드가 stop을 확인하는 간격
+static const int UDP_RECEIVE_TIMEOUT_MS = 100;
+// 받는 쪽이 수신 보고를 보내는 간격
+static const auto UDP_FEEDBACK_INTERVAL = std::chrono::milliseconds(100);
+// 링크 에뮬레이터가 패킷을 들고 있을 때 받기 대기의 최소 단위 (0은 무한 대기라 쓰지 않음)
+static const int64_t UDP_EMULATOR_MIN_WAIT_US = 100;
+
+static bool initializeSockets() {
+#if defined(_WIN32)
+	static bool initialized = [] {
+		WSADATA data;
+		return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+	}();
+	return initialized;
+#else
+	return true;
+#endif
+}
+
+static void closeSocket(intptr_t socketHandle) {
+#if defined(_WIN32)
+	closesocket(nativeSocket(socketHandle));
+#else
+	::close(nativeSocket(socketHandle));
+#endif
+}
+
+static int64_t steadyTimeUs() {
+	return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static void setReceiveTimeout(intptr_t socketHandle, int64_t timeoutUs) {
+#if defined(_WIN32)
+	DWORD timeout = static_cast<DWORD>((std::max<int64_t>)(1, timeoutUs / 1000));
+#else
+	timeval timeout = { static_cast<time_t>(timeoutUs / 1000000), static_cast<suseconds_t>(timeoutUs % 1000000) };
+#endif
+	setsockopt(nativeSocket(socketHandle), SOL_SOCKET, SO_RCVTIMEO, reinterpret_cast<const char*>(&timeout), sizeof(timeout));
+}
+
+static intptr_t openSocket(int bufferOption, int bufferBytes) {
+	if (!initializeSockets()) {
+		return UdpSender::INVALID_SOCKET_HANDLE;
+	}
+	NativeSocket handle = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+#if defined(_WIN32)
+	if (handle == INVALID_SOCKET) {
+#else
+	if (handle < 0) {
+#endif
+		return UdpSender::INVALID_SOCKET_HANDLE;
+	}
+	setsockopt(handle, SOL_SOCKET, bufferOption, reinterpret_cast<const char*>(&bufferBytes), sizeof(bufferBytes));
+	return static_cast<intptr_t>(handle);
+}
+
+// 보내는 쪽 소켓에서 수신 보고를 읽을 때 기다리지 않게 함
+static void setNonBlocking(intptr_t socketHandle) {
+#if defined(_WIN32)
+	u_long enabled = 1;
+	ioctlsocket(nativeSocket(socketHandle), FIONBIO, &enabled);
+#else
+	fcntl(nativeSocket(socketHandle), F_SETFL, fcntl(nativeSocket(socketHandle), F_GETFL) | O_NONBLOCK);
+#endif
+}
+
+// 비차단 소켓에서 보낼 버퍼가 가득 차 sendto가 실패했는지
+static bool sendWouldBlock() {
+#if defined(_WIN32)
+	return WSAGetLastError() == WSAEWOULDBLOCK;
+#else
+	return errno == EAGAIN || errno == EWOULDBLOCK;
+#endif
+}
+
+// 보낼 버퍼에 자리가 날 때까지 최대 timeoutUs 기다림. 자리가 났으면 true
+static bool waitWritable(intptr_t socketHandle, int64_t timeoutUs) {
+#if defined(_WIN32)
+	fd_set writeSet;
+	FD_ZERO(&writeSet);
+	FD_SET(nativeSocket(socketHandle), &writeSet);
+	timeval timeout = { static_cast<long>(timeoutUs / 1000000), static_cast<long>(timeoutUs % 1000000) };
+	return select(0, nullptr, &writeSet, nullptr, &timeout) > 0;
+#else
+	pollfd descriptor = { nativeSocket(socketHandle), POLLOUT, 0 };
+	int timeoutMs = static_cast<int>((timeoutUs + 999) / 1000);
+	return poll(&descriptor, 1, timeoutMs) > 0 && (descriptor.revents & POLLOUT);
+#endif
+}
+
+static int64_t nowMicroseconds() {
+	return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+UdpSender::~UdpSender() {
+	close();
+}
+
+bool UdpSender::open(const std::string& host, int port, size_t packetSize) {
+	close();
+
+	sockaddr_in target = {};
+	target.sin_family = AF_INET;
+	target.sin_port = htons(static_cast<uint16_t>(port));
+	if (inet_pton(AF_INET, host.c_str(), &target.sin_addr) != 1) {
+		loge("Invalid UDP address " + host);
+		return false;
+	}
+	static_assert(sizeof(target) <= sizeof(address), "sockaddr_in size");
+	memcpy(address, &target, sizeof(target));
+
+	socketHandle = openSocket(SO_SNDBUF, UDP_SEND_BUFFER_BYTES);
+	if (socketHandle == INVALID_SOCKET_HANDLE) {
+		loge("Failed to create UDP socket");
+		return false;
+	}
+	setNonBlocking(socketHandle);
+	packetizer.reset(packetSize);
+	packetSequence = 0;
+	feedbackReceived = -1;
+	feedbackLost = 0;
+	feedbackBytes = 0;
+	feedbackTimeUs = 0;
+	feedbackDropped = 0;
+	keyframeRequested = false;
+	bandwidthEstimator.reset();
+
+	std::lock_guard<std::mutex> lock(statsMutex);
+	stats = UdpSenderCounters();
+	return true;
+}
+
+void UdpSender::close() {
+	if (socketHandle != INVALID_SOCKET_HANDLE) {
+		closeSocket(socketHandle);
+		socketHandle = INVALID_SOCKET_HANDLE;
+	}
+}
+
+void UdpSender::send(const FrameData& frameData, double frameIntervalMs) {
+	if (socketHandle == INVALID_SOCKET_HANDLE) {
+		return;
+	}
+	readFeedback();
+	packetizer.setParityGroupSize(fec.groupSize());
+	size_t count = packetizer.packetize(frameData);
+	if (count == 0) {
+		std::lock_guard<std::mutex> lock(statsMutex);
+		stats.oversizedFrames++;
+		return;
+	}
+
+	// 패킷 i는 start + i * gap 이후에 보냄. 밀린 패킷은 한 번에 보내고 다음 패킷 시각까지 잠
+	// 보낼 버퍼가 가득 차면 다음 프레임 시각(blockDeadline)까지 자리가 나길 기다려 같은 패킷을 다시 보냄
+	using Clock = std::chrono::steady_clock;
+	Clock::time_point start = Clock::now();
+	auto window = std::chrono::duration<double, std::milli>(frameIntervalMs * UDP_PACING_FRACTION);
+	auto gap = std::chrono::duration_cast<Clock::duration>(window / static_cast<double>(count));
+	Clock::time_point blockDeadline = start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::milli>(frameIntervalMs));
+	long long sentBytes = 0;
+	long long errors = 0;
+	long long blocked = 0;
+	const sockaddr* target = reinterpret_cast<const sockaddr*>(address);
+
+	for (size_t i = 0; i < count; ++i) {
+		Clock::time_point due = start + gap * static_cast<long long>(i);
+		Clock::time_point now = Clock::now();
+		if (due - now >= UDP_PACING_MIN_SLEEP) {
+			std::this_thread::sleep_until(due);
+		}
+
+		uint32_t sequence = packetSequence++;
+		while (true) {
+			// 기다린 뒤 다시 보낼 때는 보낸 시각을 새로 찍음 (받는 쪽 지연 추정)
+			packetizer.stamp(i, sequence, nowMicroseconds());
+#if defined(_WIN32)
+			int result = sendto(nativeSocket(socketHandle), reinterpret_cast<const char*>(packetizer.packet(i)), static_cast<int>(packetizer.size(i)), 0, target, sizeof(sockaddr_in));
+#else
+			ssize_t result = sendto(nativeSocket(socketHandle), packetizer.packet(i), packetizer.size(i), 0, target, sizeof(sockaddr_in));
+#endif
+			if (result >= 0) {
+				sentBytes += result;
+				break;
+			}
+			if (!sendWouldBlock()) {
+				errors++;
+				break;
+			}
+			blocked++;
+			now = Clock::now();
+			auto wait = (std::max)(std::chrono::duration_cast<Clock::duration>(blockDeadline - now), std::chrono::duration_cast<Clock::duration>(UDP_SEND_BLOCK_MIN_WAIT));
+			if (!waitWritable(socketHandle, std::chrono::duration_cast<std::chrono::microseconds>(wait).count())) {
+				errors++;
+				break;
+			}
+		}
+	}
+
+	double sendMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	std::lock_guard<std::mutex> lock(statsMutex);
+	stats.framesSent++;
+	stats.packetsSent += static_cast<long long>(count) - errors;
+	stats.bytesSent += sentBytes;
+	stats.sendErrors += errors;
+	stats.sendBlocked += blocked;
+	stats.totalSendMs += sendMs;
+	stats.maxSendMs = (std::max)(stats.maxSendMs, sendMs);
+	stats.parityPacketsSent += static_cast<long long>(packetizer.parityPacketCount());
+	stats.totalFecMs += packetizer.parityTimeMs();
+	stats.fecGroupSize = static_cast<int>(packetizer.parityGroupSize());
+}
+
+void UdpSender::readFeedback() {
+	UdpFeedbackPacket feedback;
+	while (true) {
+#if defined(_WIN32)
+		int size = recv(nativeSocket(socketHandle), reinterpret_cast<char*>(&feedback), sizeof(feedback), 0);
+#else
+		ssize_t size = recv(nativeSocket(socketHandle), &feedback, sizeof(feedback), 0);
+#endif
+		if (size <= 0) {
+			return; // 더 없음
+		}
+		if (size != sizeof(feedback) || feedback.magic != UDP_FEEDBACK_MAGIC) {
+			continue;
+		}
+
+		// 받는 쪽이 다시 시작해 누적값이 줄었거나 시각이 거꾸로 가면 기준만 다시 잡음
+		// 손실 누적은 늦게 도착한 패킷만큼 줄 수 있으므로 재시작 판단에 쓰지 않고 구간 손실만 0으로 자름
+		bool restarted = feedbackReceived < 0 || feedback.packetsReceived < feedbackReceived || feedback.bytesReceived < feedbackBytes || feedback.timeUs < feedbackTimeUs;
+		if (!restarted) {
+			fec.reportLoss(feedback.packetsReceived - feedbackReceived, (std::max)(static_cast<long long>(feedback.packetsLost) - feedbackLost, 0LL));
+		}
+		feedbackReceived = feedback.packetsReceived;
+		feedbackLost = feedback.packetsLost;
+		feedbackBytes = feedback.bytesReceived;
+		feedbackTimeUs = feedback.timeUs;
+		// 받는 쪽이 프레임을 놓쳤거나 새로 붙었으면 기준 프레임이 어긋나므로 다음 프레임을 전체 갱신
+		bool keyframeRequest = restarted || feedback.framesDropped != feedbackDropped;
+		feedbackDropped = feedback.framesDropped;
+		if (keyframeRequest) {
+			keyframeRequested = true;
+		}
+		bandwidthEstimator.report(feedback.bytesReceived, feedback.packetsReceived, feedback.packetsLost, feedback.totalTransitUs, feedback.timeUs);
+
+		std::lock_guard<std::mutex> lock(statsMutex);
+		stats.feedbackReports++;
+		stats.keyframeRequests += keyframeRequest ? 1 : 0;
+		stats.reportedLossRate = fec.lossRate();
+		stats.estimatedMbps = bandwidthEstimator.estimateMbps();
+		stats.queueDelayMs = bandwidthEstimator.queueDelayMs();
+	}
+}
+
+UdpSenderCounters UdpSender::counters() {
+	std::lock_guard<std::mutex> lock(statsMutex);
+	return stats;
+}
+
+UdpReceiver::~UdpReceiver() {
+	stop();
+}
+
+bool UdpReceiver::start(int port, std::function<void(const FrameData&)> frameCallback) {
+	if (isReceiveThread()) {
+		loge("UdpReceiver cannot be restarted from the frame callback");
+		return false;
+	}
+	stop();
+
+	socketHandle = openSocket(SO_RCVBUF, UDP_RECEIVE_BUFFER_BYTES);
+	if (socketHandle == UdpSender::INVALID_SOCKET_HANDLE) {
+		loge("Failed to create UDP socket");
+		return false;
+	}
+
+	// 주기적으로 깨어 stop을 확인
+	setReceiveTimeout(socketHandle, UDP_RECEIVE_TIMEOUT_MS * 1000);
+
+	sockaddr_in local = {};
+	local.sin_family = AF_INET;
+	local.sin_port = htons(static_cast<uint16_t>(port));
+	local.sin_addr.s_addr = htonl(INADDR_ANY);
+	if (bind(nativeSocket(socketHandle), reinterpret_cast<const sockaddr*>(&local), sizeof(local)) != 0) {
+		loge("Failed to bind UDP port " + std::to_string(port));
+		closeSocket(socketHandle);
+		socketHandle = UdpSender::INVALID_SOCKET_HANDLE;
+		return false;
+	}
+
+	reassembler.reset(std::move(frameCallback));
+	running = true;
+	receiveThread = std::thread(&UdpReceiver::receiveLoop, this);
+	return true;
+}
+
+void UdpReceiver::stop() {
+	running = false;
+	// 콜백에서 부르면 콜백이 돌아온 뒤 받는 루프가 끝남
+	if (isReceiveThread()) {
+		return;
+	}
+	if (receiveThread.joinable()) {
+		receiveThread.join();
+	}
+	if (socketHandle != UdpSender::INVALID_SOCKET_HANDLE) {
+		closeSocket(socketHandle);
+		socketHandle = UdpSender::INVALID_SOCKET_HANDLE;
+	}
+}
+
+void UdpReceiver::setLinkEmulation(const LinkEmulationSettings* settings, uint32_t seed) {
+	std::lock_guard<std::mutex> lock(emulatorMutex);
+	if (settings) {
+		linkEmulator.configure(*settings, seed);
+	}
+	else {
+		linkEmulator.disable();
+	}
+}
+
+LinkEmulatorCounters UdpReceiver::linkCounters() {
+	std::lock_guard<std::mutex> lock(emulatorMutex);
+	return linkEmulator.counters();
+}
+
+void UdpReceiver::receiveLoop() {
+	std::vector<uint8_t> packet(65536);
+	sockaddr_in source = {};
+	bool hasSource = false;
+	auto lastFeedback = std::chrono::steady_clock::now();
+	long long reportedDrops = 0;
+	int64_t receiveTimeoutUs = UDP_RECEIVE_TIMEOUT_MS * 1000;
+	while (running) {
+		// 에뮬레이터가 들고 있는 다음 패킷의 도착 시각에 깨어나도록 대기 시간을 줄임
+		int64_t nextDeliveryUs = deliverEmulated(steadyTimeUs());
+		if (!running) {
+			break;
+		}
+		int64_t timeoutUs = UDP_RECEIVE_TIMEOUT_MS * 1000;
+		if (nextDeliveryUs >= 0) {
+			timeoutUs = (std::min)(timeoutUs, (std::max)(UDP_EMULATOR_MIN_WAIT_US, nextDeliveryUs - steadyTimeUs()));
+		}
+		if (timeoutUs != receiveTimeoutUs) {
+			setReceiveTimeout(socketHandle, timeoutUs);
+			receiveTimeoutUs = timeoutUs;
+		}
+
+		sockaddr_in from = {};
+#if defined(_WIN32)
+		int fromSize = sizeof(from);
+		int size = recvfrom(nativeSocket(socketHandle), reinterpret_cast<char*>(packet.data()), static_cast<int>(packet.size()), 0, reinterpret_cast<sockaddr*>(&from), &fromSize);
+#else
+		socklen_t fromSize = sizeof(from);
+		ssize_t size = recvfrom(nativeSocket(socketHandle), packet.data(), packet.size(), 0, reinterpret_cast<sockaddr*>(&from), &fromSize);
+#endif
+		if (size > 0) {
+			source = from;
+			hasSource = true;
+		}
+
+		// 보내는 쪽이 FEC 중복 비율을 정하도록 수신 보고
+		// 프레임을 놓치면 뒤의 delta를 풀 수 없으므로 주기를 기다리지 않고 바로 알려 전체 갱신을 받음
+		auto now = std::chrono::steady_clock::now();
+		long long framesDropped = reassembler.counters().framesDropped;
+		if (hasSource && (now - lastFeedback >= UDP_FEEDBACK_INTERVAL || framesDropped != reportedDrops)) {
+			sendFeedback(reinterpret_cast<const unsigned char*>(&source));
+			lastFeedback = now;
+			reportedDrops = framesDropped;
+		}
+
+		if (size <= 0) {
+			continue; // 시간 초과
+		}
+		{
+			std::lock_guard<std::mutex> lock(emulatorMutex);
+			if (linkEmulator.enabled()) {
+				linkEmulator.submit(packet.data(), static_cast<size_t>(size), steadyTimeUs());
+				continue; // 도착 시각이 되면 deliverEmulated에서 넘김
+			}
+		}
+		receivePacket(packet.data(), static_cast<size_t>(size));
+	}
+}
+
+void UdpReceiver::receivePacket(const uint8_t* packet, size_t size) {
+	try {
+		reassembler.receive(packet, size);
+	}
+	catch (std::exception& e) {
+		loge("Failed to call frame callback");
+	}
+}
+
+int64_t UdpReceiver::deliverEmulated(int64_t nowUs) {
+	// 콜백이 stop을 부르면 남은 패킷은 넘기지 않음
+	while (running) {
+		{
+			std::lock_guard<std::mutex> lock(emulatorMutex);
+			if (!linkEmulator.pop(nowUs, emulatedPacket)) {
+				return linkEmulator.nextDeliveryUs();
+			}
+		}
+		// 콜백이 에뮬레이터 설정을 바꿀 수 있으므로 잠그지 않고 넘김
+		receivePacket(emulatedPacket.data(), emulatedPacket.size());
+	}
+	return -1;
+}
+
+void UdpReceiver::sendFeedback(const unsigned char* source) {
+	ReassemblyCounters counters = reassembler.counters();
+	UdpFeedbackPacket feedback = {};
+	feedback.magic = UDP_FEEDBACK_MAGIC;
+	feedback.packetsReceived = counters.packetsReceived;
+	feedback.packetsLost = counters.packetsLost;
+	feedback.bytesReceived = counters.bytesReceived;
+	feedback.totalTransitUs = counters.totalTransitUs;
+	feedback.timeUs = steadyTimeUs();
+	feedback.framesDropped = static_cast<uint32_t>(counters.framesDropped);
+	sendto(nativeSocket(socketHandle), reinterpret_cast<const char*>(&feedback), sizeof(feedback), 0, reinterpret_cast<const sockaddr*>(source), sizeof(sockaddr_in));
+}
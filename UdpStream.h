@@ -0,0 +1,126 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "CaptureDLL.h"
+#include "FramePacket.h"
+#include "LinkEmulator.h"
+#include "PacketFec.h"
+#include "RateController.h"
+
+// 보내는 쪽 누적 통계
+struct UdpSenderCounters {
+	long long framesSent = 0;
+	long long packetsSent = 0;
+	long long bytesSent = 0;
+	long long sendErrors = 0;     // 보내지 못한 패킷 (sendto 오류, 다음 프레임 시각까지 버퍼가 비지 않음)
+	long long oversizedFrames = 0; // 패킷 65535개를 넘어 보내지 못한 프레임
+	double totalSendMs = 0;       // 첫 패킷부터 마지막 패킷까지
+	double maxSendMs = 0;
+	long long parityPacketsSent = 0;
+	double totalFecMs = 0;        // 패리티 계산에 쓴 시간
+	int fecGroupSize = 0;         // 지금 쓰는 패리티 그룹 크기 (0이면 없음)
+	double reportedLossRate = 0;  // 받는 쪽이 알려준 손실률 (평활)
+	long long feedbackReports = 0;
+	double estimatedMbps = 0;     // 수신 보고로 추정한 링크 속도 (0이면 혼잡을 본 적 없음)
+	double queueDelayMs = 0;      // 수신 보고로 추정한 링크 큐 지연
+	long long sendBlocked = 0;    // 보낼 버퍼가 가득 차 기다렸다 다시 보낸 횟수
+	long long keyframeRequests = 0; // 받는 쪽이 프레임을 놓쳤거나 새로 붙어 전체 갱신을 요청한 횟수
+};
+
+// 받는 쪽이 주기적으로 돌려보내는 수신 보고 (보내는 쪽 주소로)
+const uint32_t UDP_FEEDBACK_MAGIC = 0x42465343; // "CSFB"
+
+struct UdpFeedbackPacket {
+	uint32_t magic;
+	uint32_t framesDropped;   // 누적 (ReassemblyCounters.framesDropped). 늘면 보내는 쪽이 다음 프레임을 전체 갱신
+	int64_t packetsReceived; // 누적
+	int64_t packetsLost;     // 누적
+	int64_t bytesReceived;   // 누적
+	int64_t totalTransitUs;  // 누적 (ReassemblyCounters.totalTransitUs, 큐 지연 변화 추정용)
+	int64_t timeUs;          // 받는 쪽 steady 시각 (전달 속도 계산용)
+};
+
+// 인코딩된 프레임을 MTU 크기 패킷으로 나눠 UDP로 보냄
+// 한 프레임의 패킷은 프레임 간격의 UDP_PACING_FRACTION 동안 고르게 나눠 보내 순간 버스트를 줄임
+// 받는 쪽의 수신 보고로 손실률을 재서 패리티(FEC) 그룹 크기를 고르고 링크 속도를 추정
+class UdpSender {
+public:
+	~UdpSender();
+
+	// host: IPv4 주소 (예: "127.0.0.1"), packetSize: 헤더를 포함한 UDP 페이로드 크기
+	bool open(const std::string& host, int port, size_t packetSize);
+	void close();
+	bool isOpen() const { return socketHandle != INVALID_SOCKET_HANDLE; }
+	// FecController::configure 참고. open 전에 호출
+	void configureFec(int groupSize) { fec.configure(groupSize); }
+
+	// 호출한 쓰레드에서 페이싱하며 보냄 (최대 frameIntervalMs * UDP_PACING_FRACTION 동안 대기)
+	void send(const FrameData& frameData, double frameIntervalMs);
+
+	UdpSenderCounters counters();
+	// 수신 보고로 받은 전체 갱신 요청을 꺼냄 (한 번 꺼내면 다음 요청까지 false). 다른 쓰레드에서 불러도 됨
+	bool takeKeyframeRequest() { return keyframeRequested.exchange(false); }
+
+	static const intptr_t INVALID_SOCKET_HANDLE = -1;
+
+private:
+	void readFeedback();
+
+	intptr_t socketHandle = INVALID_SOCKET_HANDLE;
+	FramePacketizer packetizer;
+	FecController fec;
+	BandwidthEstimator bandwidthEstimator;
+	long long feedbackReceived = -1; // 마지막 보고의 누적값 (-1이면 아직 없음)
+	long long feedbackLost = 0;
+	long long feedbackBytes = 0;
+	int64_t feedbackTimeUs = 0;
+	uint32_t feedbackDropped = 0;
+	std::atomic<bool> keyframeRequested{ false };
+	uint32_t packetSequence = 0;
+	unsigned char address[16] = {}; // sockaddr_in
+
+	std::mutex statsMutex;
+	UdpSenderCounters stats;
+};
+
+// UDP로 받은 패킷을 프레임으로 모아 받는 쓰레드에서 콜백
+class UdpReceiver {
+public:
+	~UdpReceiver();
+
+	// port에 묶고 받는 쓰레드 시작. frameCallback의 data는 콜백 안에서만 유효
+	// frameCallback 안에서는 다시 시작할 수 없음 (false)
+	bool start(int port, std::function<void(const FrameData&)> frameCallback);
+	// frameCallback 안에서 부르면 받는 쓰레드가 자기를 기다릴 수 없으므로 받기만 멈춤
+	// 쓰레드 정리와 소켓 닫기는 다른 쓰레드의 다음 stop/start/소멸자에서 함 (콜백 안에서 소멸시키면 안 됨)
+	void stop();
+	bool isReceiveThread() const { return receiveThread.get_id() == std::this_thread::get_id(); }
+
+	// 받은 패킷을 모으기 전에 링크 에뮬레이터에 통과시킴 (nullptr이면 끔). 받는 도중에도 바꿀 수 있음
+	void setLinkEmulation(const LinkEmulationSettings* settings, uint32_t seed);
+	LinkEmulatorCounters linkCounters();
+
+	ReassemblyCounters counters() { return reassembler.counters(); }
+
+private:
+	void receiveLoop();
+	void sendFeedback(const unsigned char* source);
+	void receivePacket(const uint8_t* packet, size_t size);
+	// 도착 시각이 된 에뮬레이터 패킷을 모두 넘기고 다음 도착 시각을 반환 (없으면 -1)
+	int64_t deliverEmulated(int64_t nowUs);
+
+	intptr_t socketHandle = UdpSender::INVALID_SOCKET_HANDLE;
+	std::atomic<bool> running{ false };
+	std::thread receiveThread;
+	FrameReassembler reassembler;
+
+	std::mutex emulatorMutex;
+	LinkEmulator linkEmulator;
+	std::vector<uint8_t> emulatedPacket;
+};
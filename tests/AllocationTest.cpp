@@ -0,0 +1,168 @@
+// 인코딩 경로의 정상 상태 힙 할당 확인
+// CaptureDLL 단계들처럼 풀에서 버퍼를 돌려쓰며 모션 검출 + 타일/XOR/사전 인코딩 + 전달 Task를 반복하고
+// 워밍업 뒤에는 GetAllocationStats 카운터와 실제 operator new 호출이 모두 늘지 않아야 함
+// 큰 캡처 Task가 카운터에 잡히는지도 확인
+// 사용법: AllocationTest
+#include "FrameCodec.h"
+#include "MotionDetect.h"
+#include "TileDiff.h"
+#include "TestFrames.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <thread>
+#include <vector>
+
+static const size_t WIDTH = 1280;
+static const size_t HEIGHT = 720;
+
+// 이 프로그램의 모든 힙 할당 횟수 (카운터에 안 잡힌 할당 확인용)
+static std::atomic<long long> heapAllocations{ 0 };
+
+void* operator new(size_t size) {
+	heapAllocations.fetch_add(1, std::memory_order_relaxed);
+	if (void* p = std::malloc(size ? size : 1)) {
+		return p;
+	}
+	throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+	std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+	std::free(p);
+}
+
+static ByteBufferPool bufferPool;
+static BufferPool<CopyRectList> copyRectPool;
+
+// FrameData + 압축 버퍼 + lease 정도의 전달 작업 캡처
+struct DeliveryCapture {
+	void* target;
+	double frameTime;
+	unsigned char frameData[32];
+	void* frameLease;
+};
+
+// diff -> compress -> 전달 한 프레임. 단계 사이 버퍼는 CaptureDLL처럼 풀에서 꺼내고 돌려줌
+static void encodeFrame(int mode, const std::vector<uint8_t>& current, std::vector<uint8_t>& reference, MotionDetector& motionDetector, ThreadPool* pool) {
+	CopyRectList copyRects = copyRectPool.acquire();
+	if (motionDetector.detect(current.data(), copyRects, pool) > 0) {
+		applyCopyRects(reference.data(), static_cast<int>(WIDTH), static_cast<int>(HEIGHT), copyRects);
+	}
+
+	ByteBuffer compressedData = bufferPool.acquire();
+	if (mode == ENCODE_TILE) {
+		TileGrid grid = makeTileGrid(static_cast<int>(WIDTH), static_cast<int>(HEIGHT), 64);
+		ByteBuffer dirtyBitmap = bufferPool.acquire();
+		ByteBuffer tilePixels = bufferPool.acquire();
+		int dirtyTileCount = detectDirtyTiles(current.data(), reference.data(), grid, dirtyBitmap, pool);
+		packDirtyTiles(current.data(), grid, dirtyBitmap.data(), tilePixels);
+		compressTiles(grid, dirtyBitmap, dirtyTileCount, tilePixels, 1, compressedData, pool);
+		bufferPool.release(std::move(dirtyBitmap));
+		bufferPool.release(std::move(tilePixels));
+	}
+	else if (mode == ENCODE_XOR_LZ4) {
+		compressFrame(current.data(), reference.data(), current.size(), 1, compressedData, pool);
+	}
+	else {
+		compressFrameWithDict(current.data(), reference.data(), current.size(), 1, compressedData, pool);
+	}
+	prependCopyRects(copyRects, compressedData);
+	copyRectPool.release(std::move(copyRects));
+	reference = current;
+
+	DeliveryCapture capture = {};
+	Task deliver([capture, compressedData = std::move(compressedData)]() mutable {
+		bufferPool.release(std::move(compressedData));
+	});
+	deliver();
+}
+
+static bool checkSteadyState(int mode, ThreadPool* pool) {
+	std::vector<uint8_t> base, current, reference(WIDTH * HEIGHT * 4, 0);
+	makeDesktopFrame(WIDTH, HEIGHT, 3, base);
+	MotionDetector motionDetector;
+	motionDetector.reset(static_cast<int>(WIDTH), static_cast<int>(HEIGHT));
+
+	// 스크롤과 글자 입력을 번갈아 (CopyRect가 있는 프레임과 없는 프레임)
+	auto makeFrame = [&](int frameIndex) {
+		current = base;
+		if (frameIndex % 2) {
+			scrollUp(current, WIDTH, HEIGHT, 3);
+		}
+		changeRows(current, WIDTH, HEIGHT, 0.05, frameIndex % 2);
+	};
+
+	const int warmupFrames = 20;
+	const int frames = 60;
+	for (int i = 0; i < warmupFrames; ++i) {
+		makeFrame(i);
+		encodeFrame(mode, current, reference, motionDetector, pool);
+	}
+
+	long long countedBefore, bytesBefore, countedAfter, bytesAfter;
+	getAllocationCounters(countedBefore, bytesBefore);
+	long long heapBefore = heapAllocations.load();
+	for (int i = warmupFrames; i < warmupFrames + frames; ++i) {
+		makeFrame(i); // 같은 크기로 덮어쓰므로 할당 없음
+		encodeFrame(mode, current, reference, motionDetector, pool);
+	}
+	getAllocationCounters(countedAfter, bytesAfter);
+	long long heapAfter = heapAllocations.load();
+
+	printf("%-5s %-9s counted %lld (%lld bytes), operator new %lld over %d frames\n", mode == ENCODE_TILE ? "tile" : mode == ENCODE_XOR_LZ4 ? "xor" : "dict",
+		pool ? "pool" : "no pool", countedAfter - countedBefore, bytesAfter - bytesBefore, heapAfter - heapBefore, frames);
+	return countedAfter == countedBefore && heapAfter == heapBefore;
+}
+
+// 쓰레드마다 처음 한 번 만드는 LZ4 상태를 풀의 모든 쓰레드에 미리 만들어 둠
+// parallelFor가 밴드를 어느 쓰레드에 줄지는 정해져 있지 않아 워밍업 프레임만으로는 빠지는 워커가 있을 수 있음
+// 모두 모일 때까지 기다려 한 쓰레드가 두 항목을 맡지 않게 함 (워커가 바쁘면 시간 제한 뒤 진행)
+static void warmUpWorkers(ThreadPool& pool) {
+	size_t threads = pool.size() + 1;
+	std::atomic<size_t> arrived{ 0 };
+	pool.parallelFor(threads, [&](size_t) {
+		std::vector<uint8_t> frame(1024, 0);
+		ByteBuffer compressedData;
+		compressFrame(frame.data(), frame.data(), frame.size(), 1, compressedData);
+		arrived++;
+		auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+		while (arrived.load() < threads && std::chrono::steady_clock::now() < deadline) {
+			std::this_thread::yield();
+		}
+	});
+}
+
+// 인라인 버퍼에 안 들어가는 캡처는 힙에 두고 카운터에 더함
+static bool checkLargeTaskCounted() {
+	unsigned char large[Task::INLINE_SIZE + 1] = {};
+	long long countedBefore, bytesBefore, countedAfter, bytesAfter;
+	getAllocationCounters(countedBefore, bytesBefore);
+	Task task([large] { (void)large; });
+	getAllocationCounters(countedAfter, bytesAfter);
+	bool ok = countedAfter == countedBefore + 1 && bytesAfter - bytesBefore >= static_cast<long long>(sizeof(large));
+
+	Task small([capture = DeliveryCapture{}, buffer = ByteBuffer()] { (void)capture; });
+	long long countedSmall, bytesSmall;
+	getAllocationCounters(countedSmall, bytesSmall);
+	ok = ok && countedSmall == countedAfter;
+	printf("large Task capture counted: %s, delivery-sized capture inline: %s\n", countedAfter == countedBefore + 1 ? "yes" : "no", countedSmall == countedAfter ? "yes" : "no");
+	return ok;
+}
+
+int main() {
+	bool ok = checkLargeTaskCounted();
+	ThreadPool pool((std::max)(1u, std::thread::hardware_concurrency()));
+	warmUpWorkers(pool);
+	for (int mode : { ENCODE_TILE, ENCODE_XOR_LZ4, ENCODE_LZ4_DICT }) {
+		ok = checkSteadyState(mode, nullptr) && ok;
+		ok = checkSteadyState(mode, &pool) && ok;
+	}
+	return ok ? 0 : 1;
+}
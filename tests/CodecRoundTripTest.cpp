@@ -0,0 +1,180 @@
+// 인코딩 모드(XOR/사전/타일) x 채널 배치(BGRA/BGR/평면)마다 연속 프레임을 인코딩/복원해 확인
+// BGRA는 알파까지 그대로, 알파를 뺀 배치는 색은 그대로이고 알파는 모든 모드에서 0xFF여야 함
+// 마지막 프레임은 FRAME_FLAG_ZERO_BASE (보낸 쪽 기준을 0 프레임으로 다시 잡음): 받는 쪽 이전 프레임이 어긋나 있어도 복원돼야 함
+// 위로 스크롤/오른쪽으로 민 프레임은 MotionDetector가 그 이동을 찾고, CopyRect를 먼저 적용한 나머지 인코딩으로 복원돼야 함
+// 사용법: CodecRoundTripTest
+#include "FrameCodec.h"
+#include "MotionDetect.h"
+#include "TileDiff.h"
+#include "TestFrames.h"
+
+#include <cstdio>
+#include <vector>
+
+static const size_t WIDTH = 333;   // 블록/타일 경계가 픽셀과 맞지 않도록
+static const size_t HEIGHT = 187;
+
+static const char* modeName(int mode) {
+	switch (mode) {
+	case ENCODE_XOR_LZ4: return "xor";
+	case ENCODE_LZ4_DICT: return "dict";
+	case ENCODE_TILE: return "tile";
+	}
+	return "?";
+}
+
+static bool encodeFrame(int mode, int channelLayout, const std::vector<uint8_t>& previous, const std::vector<uint8_t>& current, ByteBuffer& compressed, uint32_t frameFlags) {
+	size_t frameSize = current.size();
+	switch (mode) {
+	case ENCODE_XOR_LZ4:
+		return compressFrame(current.data(), previous.data(), frameSize, 1, compressed, nullptr, channelLayout, frameFlags);
+	case ENCODE_LZ4_DICT:
+		return compressFrameWithDict(current.data(), previous.data(), frameSize, 1, compressed, nullptr, channelLayout, frameFlags);
+	case ENCODE_TILE: {
+		TileGrid grid = makeTileGrid(static_cast<int>(WIDTH), static_cast<int>(HEIGHT), 64);
+		ByteBuffer dirtyBitmap;
+		int dirtyTileCount = detectDirtyTiles(current.data(), previous.data(), grid, dirtyBitmap);
+		ByteBuffer tilePixels;
+		packDirtyTiles(current.data(), grid, dirtyBitmap.data(), tilePixels);
+		return compressTiles(grid, dirtyBitmap, dirtyTileCount, tilePixels, 1, compressed, nullptr, channelLayout, frameFlags);
+	}
+	}
+	return false;
+}
+
+// decoded는 받는 쪽 이전 프레임이고 제자리에서 복원됨
+static bool decodeFrame(int mode, const uint8_t* payload, size_t payloadSize, std::vector<uint8_t>& decoded) {
+	switch (mode) {
+	case ENCODE_XOR_LZ4:
+		return decompressFrame(payload, payloadSize, decoded.data(), decoded.data(), decoded.size());
+	case ENCODE_LZ4_DICT:
+		return decompressFrameWithDict(payload, payloadSize, decoded.data(), decoded.data(), decoded.size());
+	case ENCODE_TILE:
+		return decompressTiles(payload, payloadSize, decoded.data(), static_cast<int>(WIDTH), static_cast<int>(HEIGHT));
+	}
+	return false;
+}
+
+static bool encodeDecode(int mode, int channelLayout, const std::vector<uint8_t>& previous, const std::vector<uint8_t>& current, std::vector<uint8_t>& decoded, uint32_t frameFlags) {
+	ByteBuffer compressed;
+	return encodeFrame(mode, channelLayout, previous, current, compressed, frameFlags) && decodeFrame(mode, compressed.data(), compressed.size(), decoded);
+}
+
+// 알려진 스크롤/가로 이동: MotionDetector가 그 이동량의 CopyRect를 찾고,
+// CaptureDLL처럼 보내는 쪽 기준 프레임에 CopyRect를 먼저 적용해 나머지만 인코딩하면 받는 쪽이 같은 순서로 복원함
+static bool checkMotion(int mode) {
+	struct Motion {
+		const char* name;
+		int dx;  // 오른쪽으로 민 픽셀
+		int dy;  // 위로 스크롤한 행
+	};
+	static const Motion MOTIONS[] = { { "scroll up 24", 0, 24 }, { "shift right 40", 40, 0 } };
+
+	std::vector<uint8_t> previous;
+	makeDesktopFrame(WIDTH, HEIGHT, 11, previous);
+	std::vector<uint8_t> decoded(previous);
+	MotionDetector detector;
+	detector.reset(static_cast<int>(WIDTH), static_cast<int>(HEIGHT));
+	CopyRectList copyRects;
+	detector.detect(previous.data(), copyRects);
+
+	bool ok = true;
+	for (const Motion& motion : MOTIONS) {
+		std::vector<uint8_t> current(previous);
+		if (motion.dy > 0) {
+			scrollUp(current, WIDTH, HEIGHT, motion.dy);
+		}
+		else {
+			shiftRows(current, WIDTH, HEIGHT, motion.dx);
+		}
+
+		// 이동한 영역의 절반 이상을 맞는 이동량으로 찾아야 함
+		int detected = detector.detect(current.data(), copyRects);
+		long long matchedPixels = 0;
+		for (const CopyRect& rect : copyRects) {
+			if (rect.dstX - rect.srcX == motion.dx && rect.srcY - rect.dstY == motion.dy) {
+				matchedPixels += static_cast<long long>(rect.width) * rect.height;
+			}
+		}
+		long long movedPixels = static_cast<long long>(WIDTH - motion.dx) * (HEIGHT - motion.dy);
+		bool found = detected > 0 && matchedPixels * 2 >= movedPixels;
+
+		// 보내는 쪽: 기준 프레임에 CopyRect 적용 -> 나머지 인코딩 -> CopyRect를 앞에 붙임
+		std::vector<uint8_t> reference(previous);
+		applyCopyRects(reference.data(), static_cast<int>(WIDTH), static_cast<int>(HEIGHT), copyRects);
+		ByteBuffer payload;
+		bool encoded = encodeFrame(mode, CHANNEL_BGRA, reference, current, payload, 0);
+		ByteBuffer withoutMotion;
+		encoded = encodeFrame(mode, CHANNEL_BGRA, previous, current, withoutMotion, 0) && encoded;
+		size_t residualSize = payload.size();
+		prependCopyRects(copyRects, payload);
+
+		// 받는 쪽: CopyRect를 읽어 이전 프레임에 적용 -> 나머지 복원
+		CopyRectList received;
+		size_t prefixSize = readCopyRects(payload.data(), payload.size(), received);
+		bool restored = prefixSize > 0 && received.size() == copyRects.size();
+		if (restored) {
+			applyCopyRects(decoded.data(), static_cast<int>(WIDTH), static_cast<int>(HEIGHT), received);
+			restored = decodeFrame(mode, payload.data() + prefixSize, payload.size() - prefixSize, decoded);
+		}
+		bool matches = restored && decoded == current;
+
+		// 사전 모드는 이전 프레임을 사전으로 쓰므로 이동한 내용도 이미 찾아 나머지가 작아지지 않음
+		bool smaller = mode == ENCODE_LZ4_DICT || residualSize < withoutMotion.size();
+		bool motionOk = found && encoded && matches && smaller;
+		printf("%-5s %-14s: %d copy rects, %lld/%lld pixels at the known shift, residual %zu bytes (without motion %zu), decoded %s: %s\n", modeName(mode),
+			motion.name, detected, matchedPixels, movedPixels, residualSize, withoutMotion.size(), matches ? "same" : "DIFFERENT", motionOk ? "ok" : "FAIL");
+		ok = ok && motionOk;
+		previous = current;
+		if (!matches) {
+			decoded = current;
+		}
+	}
+	return ok;
+}
+
+int main() {
+	bool ok = true;
+	for (int mode : { ENCODE_XOR_LZ4, ENCODE_LZ4_DICT, ENCODE_TILE }) {
+		for (int channelLayout : { CHANNEL_BGRA, CHANNEL_BGR, CHANNEL_PLANAR }) {
+			// 보내는 쪽과 받는 쪽 모두 0 프레임에서 시작. 알파는 일부러 0xFF가 아닌 값을 섞음
+			std::vector<uint8_t> previous(WIDTH * HEIGHT * 4, 0);
+			std::vector<uint8_t> decoded(previous);
+			int failures = 0;
+			for (uint32_t frameIndex = 0; frameIndex < 5; ++frameIndex) {
+				uint32_t frameFlags = 0;
+				if (frameIndex == 4) {
+					// 받는 쪽이 프레임을 놓쳐 기준이 어긋난 상태에서 전체 갱신
+					frameFlags = FRAME_FLAG_ZERO_BASE;
+					previous.assign(previous.size(), 0);
+					decoded.assign(decoded.size(), 0x5A);
+				}
+				std::vector<uint8_t> current;
+				makeDesktopFrame(WIDTH, HEIGHT, 11, current);
+				changeRows(current, WIDTH, HEIGHT, 0.2 * frameIndex, frameIndex);
+				for (size_t i = 3; i < current.size(); i += 4 * 7) {
+					current[i] = static_cast<uint8_t>(i);
+				}
+
+				if (!encodeDecode(mode, channelLayout, previous, current, decoded, frameFlags)) {
+					failures++;
+					break;
+				}
+				for (size_t i = 0; i < current.size(); ++i) {
+					uint8_t expected = (i % 4 == 3 && channelLayout != CHANNEL_BGRA) ? 0xFF : current[i];
+					if (decoded[i] != expected) {
+						failures++;
+						break;
+					}
+				}
+				previous = current;
+			}
+			printf("%-5s layout %d: %s\n", modeName(mode), channelLayout, failures ? "FAIL" : "ok");
+			ok = ok && failures == 0;
+		}
+	}
+	for (int mode : { ENCODE_XOR_LZ4, ENCODE_LZ4_DICT, ENCODE_TILE }) {
+		ok = checkMotion(mode) && ok;
+	}
+	return ok ? 0 : 1;
+}
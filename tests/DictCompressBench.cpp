@@ -0,0 +1,114 @@
+// ENCODE_LZ4_DICT(이전 프레임 같은 블록을 사전으로)와 ENCODE_XOR_LZ4의 압축률/속도 비교
+// 둘 다 복원 결과를 확인하고, 사전 모드는 LZ4_loadDict와 LZ4_loadDictSlow의 차이도 출력
+// 사용법: DictCompressBench
+#include "FrameCodec.h"
+#define LZ4_STATIC_LINKING_ONLY
+#include "lz4.h"
+#include "TestFrames.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <vector>
+
+static const size_t WIDTH = 1920;
+static const size_t HEIGHT = 1080;
+
+template <typename Run>
+static double measureMs(Run&& run, int iterations = 10) {
+	run();
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < iterations; ++i) {
+		run();
+	}
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / iterations;
+}
+
+// 코덱과 같은 블록 단위로 사전만 바꿔 압축한 전체 크기
+static size_t compressBlocksWithLoader(const std::vector<uint8_t>& current, const std::vector<uint8_t>& previous, int (*loadDict)(LZ4_stream_t*, const char*, int), double& ms) {
+	static LZ4_stream_t stream;
+	std::vector<char> out(LZ4_compressBound(static_cast<int>(FUSED_BLOCK_SIZE)));
+	size_t total = 0;
+	ms = measureMs([&] {
+		total = 0;
+		for (size_t offset = 0; offset < current.size(); offset += FUSED_BLOCK_SIZE) {
+			int blockSize = static_cast<int>((std::min)(FUSED_BLOCK_SIZE, current.size() - offset));
+			LZ4_resetStream_fast(&stream);
+			loadDict(&stream, reinterpret_cast<const char*>(previous.data() + offset), blockSize);
+			total += LZ4_compress_fast_continue(&stream, reinterpret_cast<const char*>(current.data() + offset), out.data(), blockSize, static_cast<int>(out.size()), 1);
+		}
+	});
+	return total;
+}
+
+int main() {
+	struct Case {
+		const char* name;
+		std::function<void(std::vector<uint8_t>&)> change;
+	};
+	const Case cases[] = {
+		{ "static", [](std::vector<uint8_t>&) {} },
+		{ "typing 2%", [](std::vector<uint8_t>& frame) { changeRows(frame, WIDTH, HEIGHT, 0.02, 3); } },
+		{ "changed 10%", [](std::vector<uint8_t>& frame) { changeRows(frame, WIDTH, HEIGHT, 0.1, 3); } },
+		{ "shift 8px", [](std::vector<uint8_t>& frame) { shiftRows(frame, WIDTH, HEIGHT, 8); } },
+		{ "scroll 3 rows", [](std::vector<uint8_t>& frame) { scrollUp(frame, WIDTH, HEIGHT, 3); } },
+		{ "new content", [](std::vector<uint8_t>& frame) { makeDesktopFrame(WIDTH, HEIGHT, 99, frame); shiftRows(frame, WIDTH, HEIGHT, 100); } },
+	};
+	const int accelerations[] = { 1, 8 };
+	bool ok = true;
+
+	printf("%-14s %-5s %5s %10s %8s %12s %12s\n", "frame", "mode", "accel", "out KB", "ratio", "enc ms", "dec ms");
+	for (const Case& c : cases) {
+		std::vector<uint8_t> previous, current;
+		makeDesktopFrame(WIDTH, HEIGHT, 7, previous);
+		current = previous;
+		c.change(current);
+		size_t frameSize = current.size();
+
+		for (int acceleration : accelerations) {
+			for (int mode : { ENCODE_XOR_LZ4, ENCODE_LZ4_DICT }) {
+				ByteBuffer compressed;
+				double encodeMs = measureMs([&] {
+					if (mode == ENCODE_XOR_LZ4) {
+						compressFrame(current.data(), previous.data(), frameSize, acceleration, compressed);
+					}
+					else {
+						compressFrameWithDict(current.data(), previous.data(), frameSize, acceleration, compressed);
+					}
+				});
+
+				std::vector<uint8_t> decoded(frameSize);
+				bool decodedOk = false;
+				double decodeMs = measureMs([&] {
+					decoded = previous;
+					decodedOk = mode == ENCODE_XOR_LZ4
+						? decompressFrame(compressed.data(), compressed.size(), decoded.data(), decoded.data(), frameSize)
+						: decompressFrameWithDict(compressed.data(), compressed.size(), decoded.data(), decoded.data(), frameSize);
+				});
+				if (!decodedOk || decoded != current) {
+					printf("%-14s %-5s decode mismatch\n", c.name, mode == ENCODE_XOR_LZ4 ? "xor" : "dict");
+					ok = false;
+				}
+
+				printf("%-14s %-5s %5d %10zu %8.1f %12.3f %12.3f\n", c.name, mode == ENCODE_XOR_LZ4 ? "xor" : "dict", acceleration,
+					compressed.size() / 1024, static_cast<double>(frameSize) / compressed.size(), encodeMs, decodeMs);
+			}
+		}
+	}
+
+	printf("\n%-14s %-16s %10s %12s\n", "frame", "dictionary load", "out KB", "enc ms");
+	for (const Case& c : cases) {
+		std::vector<uint8_t> previous, current;
+		makeDesktopFrame(WIDTH, HEIGHT, 7, previous);
+		current = previous;
+		c.change(current);
+
+		double fastMs, slowMs;
+		size_t fastSize = compressBlocksWithLoader(current, previous, LZ4_loadDict, fastMs);
+		size_t slowSize = compressBlocksWithLoader(current, previous, LZ4_loadDictSlow, slowMs);
+		printf("%-14s %-16s %10zu %12.3f\n", c.name, "LZ4_loadDict", fastSize / 1024, fastMs);
+		printf("%-14s %-16s %10zu %12.3f\n", c.name, "LZ4_loadDictSlow", slowSize / 1024, slowMs);
+	}
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,100 @@
+// 프레임 diff 커널: 스칼라 기준 구현과 결과 비교 후 1080p/1440p/4K 버퍼에서 속도 측정
+// 사용법: DiffKernelTest [--bench]
+#include "FrameDiff.h"
+#include "CpuFeatures.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+static const DiffKernelType KERNEL_TYPES[] = { DiffKernelType::Scalar, DiffKernelType::SSE2, DiffKernelType::AVX2, DiffKernelType::AVX512BW };
+
+// 길이와 시작 위치(정렬)를 바꿔가며 스칼라 결과와 비교
+static bool checkKernels() {
+	std::mt19937 random(1);
+	const size_t maxSize = 4096 + 64;
+	std::vector<uint8_t> current(maxSize + 64), previous(maxSize + 64), expected(maxSize + 64), actual(maxSize + 64);
+	for (size_t i = 0; i < current.size(); ++i) {
+		current[i] = static_cast<uint8_t>(random());
+		previous[i] = static_cast<uint8_t>(random());
+	}
+
+	bool ok = true;
+	for (DiffKernelType type : KERNEL_TYPES) {
+		DiffKernel kernel = getDiffKernel(type);
+		if (!kernel) {
+			printf("%-9s not supported\n", getDiffKernelName(type));
+			continue;
+		}
+		int failures = 0;
+		for (size_t offset = 0; offset < 4; ++offset) {
+			for (size_t size = 0; size <= maxSize; size += (size < 300 ? 1 : 97)) {
+				calculateDiffScalar(current.data() + offset, previous.data() + offset, expected.data(), size);
+				// 끝을 넘어 쓰는지 확인할 수 있도록 뒤를 표시값으로 채움
+				memset(actual.data(), 0xA5, actual.size());
+				kernel(current.data() + offset, previous.data() + offset, actual.data(), size);
+				if (memcmp(expected.data(), actual.data(), size) != 0 || actual[size] != 0xA5) {
+					if (failures++ == 0) {
+						printf("%-9s mismatch at size %zu offset %zu\n", getDiffKernelName(type), size, offset);
+					}
+				}
+			}
+		}
+		printf("%-9s %s\n", getDiffKernelName(type), failures ? "FAIL" : "ok");
+		ok = ok && failures == 0;
+	}
+	return ok;
+}
+
+static void benchmark() {
+	struct Resolution {
+		const char* name;
+		size_t width;
+		size_t height;
+	};
+	const Resolution resolutions[] = { { "1080p", 1920, 1080 }, { "1440p", 2560, 1440 }, { "4K", 3840, 2160 } };
+
+	printf("\n%-6s %-9s %10s %10s\n", "size", "kernel", "ms/frame", "GB/s");
+	for (const Resolution& resolution : resolutions) {
+		size_t frameSize = resolution.width * resolution.height * 4;
+		std::vector<uint8_t> current(frameSize), previous(frameSize), diff(frameSize);
+		for (size_t i = 0; i < frameSize; ++i) {
+			current[i] = static_cast<uint8_t>(i * 7);
+			previous[i] = static_cast<uint8_t>(i * 13);
+		}
+
+		// memcpy(읽기 1 + 쓰기 1)를 메모리 대역폭 기준으로 함께 출력
+		auto measure = [&](auto&& run) {
+			run();
+			const int iterations = 30;
+			auto start = std::chrono::steady_clock::now();
+			for (int i = 0; i < iterations; ++i) {
+				run();
+			}
+			return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / iterations;
+		};
+
+		double copyMs = measure([&] { memcpy(diff.data(), current.data(), frameSize); });
+		printf("%-6s %-9s %10.3f %10.2f\n", resolution.name, "memcpy", copyMs, 2.0 * frameSize / copyMs / 1e6);
+		for (DiffKernelType type : KERNEL_TYPES) {
+			DiffKernel kernel = getDiffKernel(type);
+			if (!kernel) {
+				continue;
+			}
+			double ms = measure([&] { kernel(current.data(), previous.data(), diff.data(), frameSize); });
+			// 읽기 2 + 쓰기 1
+			printf("%-6s %-9s %10.3f %10.2f\n", resolution.name, getDiffKernelName(type), ms, 3.0 * frameSize / ms / 1e6);
+		}
+	}
+}
+
+int main(int argc, char** argv) {
+	printf("active kernel: %s\n", getDiffKernelName(getActiveDiffKernel()));
+	bool ok = checkKernels();
+	if (argc > 1 && strcmp(argv[1], "--bench") == 0) {
+		benchmark();
+	}
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,160 @@
+// 패리티 FEC 복구율과 CPU 비용
+// 패킷으로 나눈 프레임을 링크 에뮬레이터(손실만, seed 고정)에 통과시켜 모으고 (소켓 없이 한 쓰레드에서)
+// 손실률/그룹 크기별로 완성된 프레임, 잃은 데이터 패킷 중 패리티로 복구한 비율, 1 Mbit당 패리티 계산/복구 CPU 시간을 출력
+// (받는 쪽 packetsLost에는 잃은 패리티도 들어가므로 복구율은 에뮬레이터가 버린 데이터 패킷으로 셈)
+// 1 Mbit당 us는 1 Mbps 스트림이 1초에 쓰는 CPU us와 같음 (100 Mbps면 100배)
+// 사용법: FecRecoveryTest
+#include "FramePacket.h"
+#include "LinkEmulator.h"
+#include "PacketFec.h"
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+static const size_t FRAME_BYTES = 200000;
+static const size_t PACKET_SIZE = 1200;
+static const int FRAMES = 600;
+// 보내는 쪽이 수신 보고를 받는 간격 (60fps에서 100ms)
+static const int REPORT_FRAMES = 6;
+
+static uint8_t patternByte(long long frameIndex, size_t offset) {
+	return static_cast<uint8_t>(offset * 31 + frameIndex + (offset >> 8));
+}
+
+struct FecResult {
+	int framesComplete;
+	int framesCorrupt;
+	long long packetsLost;      // 받는 쪽이 센 손실 (패리티 포함)
+	long long dataPacketsLost;  // 에뮬레이터가 버린 데이터 패킷
+	long long packetsRecovered;
+	long long parityPackets;
+	long long dataPackets;
+	double encodeUsPerMbit;
+	double decodeUsPerMbit;
+	size_t lastGroupSize;
+};
+
+// groupSize: FecController 설정 (-1 자동, 0 끔, 그 외 고정)
+static FecResult run(const LinkEmulationSettings& link, int groupSize) {
+	FecResult result = {};
+	FecController fec;
+	fec.configure(groupSize);
+	LinkEmulator emulator;
+	emulator.configure(link, 1234);
+	FrameReassembler reassembler;
+	reassembler.reset([&result](const FrameData& frameData) {
+		bool intact = static_cast<size_t>(frameData.dataSize) == FRAME_BYTES;
+		for (size_t i = 0; intact && i < FRAME_BYTES; ++i) {
+			intact = frameData.data[i] == patternByte(frameData.timeStamp, i);
+		}
+		(intact ? result.framesComplete : result.framesCorrupt)++;
+	});
+	FramePacketizer packetizer;
+	packetizer.reset(PACKET_SIZE);
+
+	std::vector<uint8_t> frame(FRAME_BYTES), packet;
+	FrameData frameData = {};
+	frameData.width = 1920;
+	frameData.height = 1080;
+	frameData.frameRate = 60;
+	uint32_t packetSequence = 0;
+	int64_t nowUs = 0;
+	double parityMs = 0;
+	ReassemblyCounters reported;
+	for (int i = 0; i < FRAMES; ++i) {
+		for (size_t offset = 0; offset < FRAME_BYTES; ++offset) {
+			frame[offset] = patternByte(i, offset);
+		}
+		frameData.data = frame.data();
+		frameData.dataSize = static_cast<int>(FRAME_BYTES);
+		frameData.timeStamp = i;
+		packetizer.setParityGroupSize(fec.groupSize());
+		size_t count = packetizer.packetize(frameData);
+		parityMs += packetizer.parityTimeMs();
+		result.parityPackets += static_cast<long long>(packetizer.parityPacketCount());
+		result.dataPackets += static_cast<long long>(count - packetizer.parityPacketCount());
+		for (size_t p = 0; p < count; ++p) {
+			packetizer.stamp(p, packetSequence++, nowUs);
+			FramePacketHeader header;
+			memcpy(&header, packetizer.packet(p), sizeof(header));
+			if (!emulator.submit(packetizer.packet(p), packetizer.size(p), nowUs) && !(header.flags & FRAME_PACKET_PARITY)) {
+				result.dataPacketsLost++;
+			}
+			while (emulator.pop(nowUs, packet)) {
+				reassembler.receive(packet.data(), packet.size());
+			}
+			nowUs += 10;
+		}
+
+		// 받는 쪽 수신 보고 (UdpSender::readFeedback처럼 구간 차이)
+		if ((i + 1) % REPORT_FRAMES == 0) {
+			ReassemblyCounters counters = reassembler.counters();
+			fec.reportLoss(counters.packetsReceived - reported.packetsReceived, counters.packetsLost - reported.packetsLost);
+			reported = counters;
+		}
+	}
+
+	ReassemblyCounters counters = reassembler.counters();
+	double megabits = static_cast<double>(FRAME_BYTES) * FRAMES * 8 / 1e6;
+	result.packetsLost = counters.packetsLost;
+	result.packetsRecovered = counters.packetsRecovered;
+	result.encodeUsPerMbit = parityMs * 1000 / megabits;
+	result.decodeUsPerMbit = counters.totalRecoveryMs * 1000 / megabits;
+	result.lastGroupSize = fec.groupSize();
+	return result;
+}
+
+static void print(const char* linkName, const char* fecName, const FecResult& result) {
+	double recoveryRate = result.dataPacketsLost > 0 ? static_cast<double>(result.packetsRecovered) / result.dataPacketsLost : 0;
+	double overhead = result.dataPackets > 0 ? static_cast<double>(result.parityPackets) / result.dataPackets : 0;
+	printf("%-12s %-8s %5d/%d %8lld %9lld %9lld %8.1f%% %7zu %8.1f%% %11.1f %11.1f%s\n", linkName, fecName, result.framesComplete, FRAMES,
+		result.packetsLost, result.dataPacketsLost, result.packetsRecovered, recoveryRate * 100, result.lastGroupSize, overhead * 100,
+		result.encodeUsPerMbit, result.decodeUsPerMbit, result.framesCorrupt ? "  CORRUPT" : "");
+}
+
+int main() {
+	struct Link {
+		const char* name;
+		LinkEmulationSettings settings;
+	};
+	std::vector<Link> links;
+	for (double loss : { 0.0, 0.01, 0.03, 0.05 }) {
+		Link link = { loss == 0 ? "no loss" : loss == 0.01 ? "1% random" : loss == 0.03 ? "3% random" : "5% random", {} };
+		link.settings.goodLossRate = loss;
+		links.push_back(link);
+	}
+	// 평균 약 1%지만 뭉쳐서 잃음 (나쁨 상태 평균 5패킷, 그 안에서 50%)
+	Link burst = { "1% burst", {} };
+	burst.settings.goodToBadRate = 0.004;
+	burst.settings.badToGoodRate = 0.2;
+	burst.settings.badLossRate = 0.5;
+	links.push_back(burst);
+
+	printf("%-12s %-8s %9s %8s %9s %9s %9s %7s %9s %11s %11s\n", "link", "fec", "frames", "lost", "data lost", "recovered", "recovery", "group", "overhead", "enc us/Mbit", "dec us/Mbit");
+	bool ok = true;
+	for (const Link& link : links) {
+		FecResult off = run(link.settings, 0);
+		FecResult fixed = run(link.settings, 8);
+		FecResult adaptive = run(link.settings, FecController::FEC_GROUP_ADAPTIVE);
+		print(link.name, "off", off);
+		print(link.name, "group 8", fixed);
+		print(link.name, "adaptive", adaptive);
+
+		bool linkOk = off.framesCorrupt == 0 && fixed.framesCorrupt == 0 && adaptive.framesCorrupt == 0 && off.packetsRecovered == 0;
+		if (link.settings.goodLossRate == 0 && link.settings.badLossRate == 0) {
+			// 손실이 없으면 모두 도착하고 자동 FEC는 패리티를 보내지 않음
+			linkOk = linkOk && off.framesComplete == FRAMES && adaptive.framesComplete == FRAMES && adaptive.parityPackets == 0;
+		}
+		else if (link.settings.goodLossRate > 0) {
+			// 독립 손실: 패리티가 있으면 더 많은 프레임이 완성되고, 자동은 손실에 맞춰 그룹을 줄여 대부분 복구
+			double adaptiveRecovery = static_cast<double>(adaptive.packetsRecovered) / adaptive.dataPacketsLost;
+			linkOk = linkOk && fixed.framesComplete > off.framesComplete && adaptive.framesComplete > off.framesComplete && adaptiveRecovery >= 0.8;
+		}
+		if (!linkOk) {
+			printf("%s: FAIL\n", link.name);
+		}
+		ok = ok && linkOk;
+	}
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,153 @@
+// FrameDelivery 확인: 워커가 순서 없이 끝내도 캡처 순서대로 전달, complete 전에 예외로 빠져나간 프레임,
+// 예외를 던지는 전달 작업, 전달 작업 안에서 stop()/start() (StopCapture를 콜백에서 부르는 경우)
+// 멈추면(교착) 감시 쓰레드가 실패로 끝냄
+// 사용법: FrameDeliveryTest
+#include "FrameDelivery.h"
+#include "ThreadPool.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+static const int FRAMES = 200;
+
+// 캡처 쓰레드처럼 순번을 예약하고 워커에서 인코딩(임의 지연) 후 완료
+// encode가 false를 돌려주면 complete 없이 예외로 빠져나감. 워커 작업이 모두 끝난 뒤 반환
+template <typename Encode>
+static void produce(FrameDelivery& delivery, ThreadPool& pool, int frames, Encode encode) {
+	std::atomic<int> running{ 0 };
+	for (int i = 0; i < frames; ++i) {
+		uint64_t sequence;
+		if (!delivery.reserve(sequence)) {
+			break;
+		}
+		running++;
+		pool.enqueueTask([&delivery, &running, sequence, encode] {
+			std::this_thread::sleep_for(std::chrono::microseconds((sequence * 7919) % 300));
+			try {
+				FrameCompletion completion(delivery, sequence);
+				if (!encode(sequence, completion)) {
+					throw std::runtime_error("encode failed");
+				}
+			}
+			catch (std::exception&) {
+			}
+			running--;
+		});
+	}
+	while (running.load() > 0) {
+		std::this_thread::yield();
+	}
+}
+
+static bool checkOrder(ThreadPool& pool) {
+	FrameDelivery delivery;
+	delivery.start(4, BACKPRESSURE_BLOCK);
+	std::vector<uint64_t> delivered;
+	produce(delivery, pool, FRAMES, [&delivered](uint64_t sequence, FrameCompletion& completion) {
+		completion.complete([&delivered, sequence] { delivered.push_back(sequence); });
+		return true;
+	});
+	delivery.stop();
+
+	bool ok = delivered.size() == FRAMES;
+	for (size_t i = 0; i < delivered.size(); ++i) {
+		ok = ok && delivered[i] == i;
+	}
+	DeliveryCounters counters = delivery.counters();
+	printf("in order: delivered %zu, reordered %lld: %s\n", delivered.size(), counters.reorderedFrames, ok ? "ok" : "FAIL");
+	return ok;
+}
+
+static bool checkThrowBeforeComplete(ThreadPool& pool) {
+	FrameDelivery delivery;
+	delivery.start(4, BACKPRESSURE_BLOCK);
+	std::atomic<int> delivered{ 0 };
+	produce(delivery, pool, FRAMES, [&delivered](uint64_t sequence, FrameCompletion& completion) {
+		if (sequence % 3 == 0) {
+			return false;
+		}
+		completion.complete([&delivered] { delivered++; });
+		return true;
+	});
+	delivery.stop();
+
+	int expected = FRAMES - (FRAMES + 2) / 3;
+	bool ok = delivered.load() == expected;
+	printf("throw before complete: delivered %d of %d: %s\n", delivered.load(), expected, ok ? "ok" : "FAIL");
+	return ok;
+}
+
+static bool checkThrowingDelivery(ThreadPool& pool) {
+	FrameDelivery delivery;
+	delivery.start(4, BACKPRESSURE_BLOCK);
+	std::atomic<int> delivered{ 0 };
+	produce(delivery, pool, FRAMES, [&delivered](uint64_t sequence, FrameCompletion& completion) {
+		completion.complete([&delivered, sequence] {
+			if (sequence % 10 == 0) {
+				throw std::runtime_error("callback failed");
+			}
+			delivered++;
+		});
+		return true;
+	});
+	delivery.stop();
+
+	DeliveryCounters counters = delivery.counters();
+	bool ok = counters.failedDeliveries == FRAMES / 10 && counters.deliveredFrames == delivered.load() && delivered.load() == FRAMES - FRAMES / 10;
+	printf("throwing delivery: delivered %lld, failed %lld: %s\n", counters.deliveredFrames, counters.failedDeliveries, ok ? "ok" : "FAIL");
+	return ok;
+}
+
+static bool checkStopFromDelivery(ThreadPool& pool) {
+	FrameDelivery delivery;
+	delivery.start(2, BACKPRESSURE_BLOCK);
+	std::atomic<int> delivered{ 0 };
+	std::atomic<bool> restartRejected{ false };
+	// 창이 작아 캡처 쓰레드는 reserve에서 기다리는 중에 전달 작업이 멈춤
+	produce(delivery, pool, FRAMES, [&](uint64_t sequence, FrameCompletion& completion) {
+		completion.complete([&, sequence] {
+			delivered++;
+			if (sequence == 10) {
+				delivery.stop();
+				restartRejected = !delivery.start(2, BACKPRESSURE_BLOCK);
+			}
+		});
+		return true;
+	});
+	// 캡처 쪽 stop은 남은 쓰레드만 정리
+	delivery.stop();
+
+	bool ok = delivered.load() == 11 && restartRejected.load();
+	printf("stop from delivery: delivered %d, restart rejected %s: %s\n", delivered.load(), restartRejected.load() ? "yes" : "no", ok ? "ok" : "FAIL");
+
+	// 다시 시작하면 정상 동작
+	delivery.start(2, BACKPRESSURE_BLOCK);
+	std::atomic<int> restarted{ 0 };
+	produce(delivery, pool, 20, [&restarted](uint64_t, FrameCompletion& completion) {
+		completion.complete([&restarted] { restarted++; });
+		return true;
+	});
+	delivery.stop();
+	printf("restart after stop: delivered %d: %s\n", restarted.load(), restarted.load() == 20 ? "ok" : "FAIL");
+	return ok && restarted.load() == 20;
+}
+
+int main() {
+	std::thread([] {
+		std::this_thread::sleep_for(std::chrono::seconds(30));
+		printf("timed out (delivery hang)\n");
+		std::_Exit(1);
+	}).detach();
+
+	ThreadPool pool(4);
+	bool ok = checkOrder(pool);
+	ok = checkThrowBeforeComplete(pool) && ok;
+	ok = checkThrowingDelivery(pool) && ok;
+	ok = checkStopFromDelivery(pool) && ok;
+	return ok ? 0 : 1;
+}
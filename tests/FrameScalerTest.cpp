@@ -0,0 +1,149 @@
+// 프레임 스케일러 AVX2 커널 확인
+// - 필터마다 (AUTO/BOX/BILINEAR/AREA) 홀수 폭/높이, 정수가 아닌 배율, 벡터 폭보다 좁은 프레임에서 AVX2 결과가 스칼라 경로와 같아야 함
+//   원본 행 간격(pitch)은 행 크기보다 길게, 밴드 병렬 처리 결과도 같아야 함
+// - 한 색으로 채운 프레임은 어떤 필터로 줄이거나 늘려도 같은 색
+// 사용법: FrameScalerTest
+#include "FrameScaler.h"
+
+#include <cstdio>
+#include <random>
+#include <vector>
+
+struct ScaleCase {
+	int srcWidth;
+	int srcHeight;
+	int dstWidth;
+	int dstHeight;
+};
+
+static const ScaleCase CASES[] = {
+	{ 74, 46, 37, 23 },      // 2:1, 홀수 출력
+	{ 148, 92, 37, 23 },     // 4:1, 홀수 출력
+	{ 1922, 1082, 961, 541 },
+	{ 1920, 1080, 1280, 720 },  // 1.5:1
+	{ 1921, 1079, 1283, 717 },  // 홀수, 가로/세로 배율 다름
+	{ 333, 211, 100, 77 },      // 3.33:1, 2.74:1
+	{ 1001, 999, 997, 3 },      // 거의 같은 폭, 아주 낮은 높이
+	{ 7, 5, 3, 3 },             // 벡터 폭보다 좁음
+	{ 9, 7, 13, 11 },           // 확대
+	{ 641, 361, 1279, 719 },    // 약 2배 확대, 홀수
+	{ 1280, 720, 1920, 1080 },  // 1.5배 확대
+	{ 1920, 1080, 1921, 1081 }, // 한 픽셀 확대
+};
+
+static const int FILTERS[] = { SCALE_FILTER_AUTO, SCALE_FILTER_BOX, SCALE_FILTER_BILINEAR, SCALE_FILTER_AREA };
+
+static const char* filterName(int filter) {
+	switch (filter) {
+	case SCALE_FILTER_BOX:
+		return "box";
+	case SCALE_FILTER_BILINEAR:
+		return "bilinear";
+	case SCALE_FILTER_AREA:
+		return "area";
+	default:
+		return "auto";
+	}
+}
+
+// 원본 행 끝 뒤 pitch 여백은 읽으면 안 되는 값으로 채움
+static void fillSource(std::vector<uint8_t>& src, const ScaleCase& scaleCase, size_t pitch, std::mt19937& random) {
+	src.assign(pitch * scaleCase.srcHeight, 0xCD);
+	for (int y = 0; y < scaleCase.srcHeight; ++y) {
+		for (size_t x = 0; x < static_cast<size_t>(scaleCase.srcWidth) * 4; ++x) {
+			src[y * pitch + x] = static_cast<uint8_t>(random());
+		}
+	}
+}
+
+static int firstMismatch(const std::vector<uint8_t>& expected, const std::vector<uint8_t>& actual) {
+	for (size_t i = 0; i < expected.size(); ++i) {
+		if (expected[i] != actual[i]) {
+			return static_cast<int>(i);
+		}
+	}
+	return -1;
+}
+
+static bool checkAvx2MatchesScalar(ThreadPool& pool) {
+	std::mt19937 random(1);
+	std::vector<uint8_t> src, expected, actual, banded;
+	bool ok = true;
+	for (const ScaleCase& scaleCase : CASES) {
+		size_t pitch = static_cast<size_t>(scaleCase.srcWidth) * 4 + 36;
+		fillSource(src, scaleCase, pitch, random);
+		size_t dstSize = static_cast<size_t>(scaleCase.dstWidth) * scaleCase.dstHeight * 4;
+		for (int filter : FILTERS) {
+			FrameScaler scaler;
+			scaler.reset(scaleCase.srcWidth, scaleCase.srcHeight, scaleCase.dstWidth, scaleCase.dstHeight, filter);
+			expected.assign(dstSize, 0);
+			actual.assign(dstSize, 0);
+			banded.assign(dstSize, 0);
+			scaler.setAvx2Enabled(false);
+			scaler.scale(src.data(), pitch, expected.data());
+			scaler.setAvx2Enabled(true);
+			scaler.scale(src.data(), pitch, actual.data());
+			scaler.scale(src.data(), pitch, banded.data(), &pool);
+
+			int mismatch = firstMismatch(expected, actual);
+			int bandMismatch = firstMismatch(expected, banded);
+			bool caseOk = mismatch < 0 && bandMismatch < 0;
+			printf("%4dx%-4d -> %4dx%-4d %-8s (%-8s): ", scaleCase.srcWidth, scaleCase.srcHeight, scaleCase.dstWidth, scaleCase.dstHeight, filterName(filter),
+				filterName(scaler.activeFilter()));
+			if (caseOk) {
+				printf("ok\n");
+			}
+			else {
+				int at = mismatch >= 0 ? mismatch : bandMismatch;
+				printf("%s differs at pixel (%d, %d) channel %d: scalar %d, avx2 %d: FAIL\n", mismatch >= 0 ? "avx2" : "banded avx2", at / 4 % scaleCase.dstWidth,
+					at / 4 / scaleCase.dstWidth, at % 4, expected[at], mismatch >= 0 ? actual[at] : banded[at]);
+			}
+			ok = ok && caseOk;
+		}
+	}
+	return ok;
+}
+
+static bool checkSolidColor() {
+	const uint8_t color[4] = { 12, 200, 77, 255 };
+	bool ok = true;
+	for (const ScaleCase& scaleCase : CASES) {
+		size_t pitch = static_cast<size_t>(scaleCase.srcWidth) * 4;
+		std::vector<uint8_t> src(pitch * scaleCase.srcHeight);
+		for (size_t i = 0; i < src.size(); ++i) {
+			src[i] = color[i % 4];
+		}
+		std::vector<uint8_t> dst(static_cast<size_t>(scaleCase.dstWidth) * scaleCase.dstHeight * 4);
+		for (int filter : FILTERS) {
+			for (bool avx2 : { false, true }) {
+				FrameScaler scaler;
+				scaler.reset(scaleCase.srcWidth, scaleCase.srcHeight, scaleCase.dstWidth, scaleCase.dstHeight, filter);
+				scaler.setAvx2Enabled(avx2);
+				scaler.scale(src.data(), pitch, dst.data());
+				for (size_t i = 0; i < dst.size(); ++i) {
+					if (dst[i] != color[i % 4]) {
+						printf("solid %dx%d -> %dx%d %s%s: byte %zu is %d, expected %d: FAIL\n", scaleCase.srcWidth, scaleCase.srcHeight, scaleCase.dstWidth,
+							scaleCase.dstHeight, filterName(filter), scaler.avx2Enabled() ? " avx2" : "", i, dst[i], color[i % 4]);
+						ok = false;
+						break;
+					}
+				}
+			}
+		}
+	}
+	printf("solid color through every filter: %s\n", ok ? "ok" : "FAIL");
+	return ok;
+}
+
+int main() {
+	ThreadPool pool(3);
+	bool ok = true;
+	if (getCpuFeatures().avx2) {
+		ok = checkAvx2MatchesScalar(pool);
+	}
+	else {
+		printf("AVX2 not supported, comparing scalar path only\n");
+	}
+	ok = checkSolidColor() && ok;
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,90 @@
+// XOR+LZ4: 예전 두 단계 방식(프레임 크기 diff 버퍼 -> 프레임 전체 LZ4)과 32 KB 블록 융합 방식 비교
+// 프레임 크기 버퍼를 지나가는 바이트 수(계산값)와 프레임당 시간을 출력하고, 융합 방식은 복원 결과도 확인
+// 사용법: FusedCompressBench
+#include "FrameCodec.h"
+#include "FrameDiff.h"
+#include "ThreadPool.h"
+#include "lz4.h"
+#include "TestFrames.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+// 예전 compressFrame: 호출마다 0으로 채운 diff 버퍼를 만들고 프레임 전체를 한 번에 압축
+static size_t compressTwoPass(const uint8_t* currentFrame, const uint8_t* previousFrame, size_t frameSize, int acceleration, std::vector<unsigned char>& compressedData) {
+	std::vector<unsigned char> diffBuffer(frameSize, 0);
+	calculateDiffSIMD(currentFrame, previousFrame, diffBuffer.data(), frameSize);
+
+	int maxCompressedSize = LZ4_compressBound(static_cast<int>(frameSize));
+	compressedData.resize(maxCompressedSize);
+	int compressedSize = LZ4_compress_fast(reinterpret_cast<const char*>(diffBuffer.data()), reinterpret_cast<char*>(compressedData.data()),
+		static_cast<int>(frameSize), maxCompressedSize, acceleration);
+	compressedData.resize(compressedSize > 0 ? compressedSize : 0);
+	return compressedData.size();
+}
+
+int main() {
+	struct Case {
+		const char* name;
+		size_t width;
+		size_t height;
+		double changedRatio;
+	};
+	const Case cases[] = {
+		{ "1080p static", 1920, 1080, 0.0 },
+		{ "1080p 10%", 1920, 1080, 0.1 },
+		{ "1080p 50%", 1920, 1080, 0.5 },
+		{ "4K static", 3840, 2160, 0.0 },
+		{ "4K 10%", 3840, 2160, 0.1 },
+		{ "4K 50%", 3840, 2160, 0.5 },
+	};
+	const int acceleration = 1;
+	const int iterations = 20;
+	ThreadPool pool(std::thread::hardware_concurrency());
+	bool ok = true;
+
+	printf("%-13s %-12s %12s %12s %10s\n", "frame", "path", "MB touched", "ms/frame", "out KB");
+	for (const Case& c : cases) {
+		std::vector<uint8_t> previous, current;
+		makeDesktopFrame(c.width, c.height, 7, previous);
+		current = previous;
+		changeRows(current, c.width, c.height, c.changedRatio, 8);
+		size_t frameSize = previous.size();
+		double frameMb = frameSize / 1e6;
+
+		auto measure = [&](auto&& run) {
+			run();
+			auto start = std::chrono::steady_clock::now();
+			for (int i = 0; i < iterations; ++i) {
+				run();
+			}
+			return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / iterations;
+		};
+
+		// 두 단계: 현재/이전 읽기 + diff 버퍼 0 채우기 + diff 쓰기 + LZ4가 diff 다시 읽기 + 출력 버퍼 0 채우기 + 압축 결과 쓰기
+		std::vector<unsigned char> twoPassOut;
+		size_t twoPassSize = 0;
+		double twoPassMs = measure([&] { twoPassSize = compressTwoPass(current.data(), previous.data(), frameSize, acceleration, twoPassOut); });
+		double twoPassMb = 5 * frameMb + (LZ4_compressBound(static_cast<int>(frameSize)) + twoPassSize) / 1e6;
+		printf("%-13s %-12s %12.1f %12.3f %10zu\n", c.name, "two-pass", twoPassMb, twoPassMs, twoPassSize / 1024);
+
+		// 융합: 현재/이전 읽기 + 압축 결과 쓰기. XOR 결과는 32 KB 블록 버퍼(L1/L2)에만 있음
+		ByteBuffer fusedOut;
+		double fusedMs = measure([&] { compressFrame(current.data(), previous.data(), frameSize, acceleration, fusedOut); });
+		double fusedMb = 2 * frameMb + fusedOut.size() / 1e6;
+		printf("%-13s %-12s %12.1f %12.3f %10zu\n", c.name, "fused", fusedMb, fusedMs, fusedOut.size() / 1024);
+
+		double pooledMs = measure([&] { compressFrame(current.data(), previous.data(), frameSize, acceleration, fusedOut, &pool); });
+		printf("%-13s %-12s %12.1f %12.3f %10zu\n", c.name, "fused+pool", fusedMb, pooledMs, fusedOut.size() / 1024);
+
+		std::vector<uint8_t> decoded(previous);
+		if (!decompressFrame(fusedOut.data(), fusedOut.size(), decoded.data(), decoded.data(), frameSize) || decoded != current) {
+			printf("%-13s decode mismatch\n", c.name);
+			ok = false;
+		}
+	}
+	return ok ? 0 : 1;
+}
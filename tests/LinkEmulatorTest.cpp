@@ -0,0 +1,202 @@
+// 링크 에뮬레이터 확인 (소켓 없이 한 쓰레드에서 시각을 직접 넘김)
+// - 프리셋마다 같은 seed로 두 번 돌리면 통계가 모두 같아야 함
+// - 대역폭보다 많이 넣어도 도착한 양은 어느 시점이든 burstBytes + bandwidthMbps * 시간을 넘지 않고, 오래 보면 대역폭에 가까워야 함
+// - 지연은 기본 지연 이상이고 큐 지연 + 지터 + 순서 바꿈 지연 안이어야 함
+// - 병목 큐는 queueBytes를 넘지 않고 넘치는 패킷은 버림
+// - 지터만으로는 순서가 바뀌지 않고, 순서를 바꾼 패킷은 reorderDelayMs만큼 더 늦게 도착
+// 사용법: LinkEmulatorTest
+#include "LinkEmulator.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+static const size_t PACKET_SIZE = 1200;
+
+struct LinkRun {
+	LinkEmulatorCounters counters;
+	long long packetsSent = 0;
+	long long observedReorders = 0;   // 앞 번호 패킷이 뒤 번호 패킷보다 늦게 도착
+	double minDelayMs = 1e9;
+	double maxDelayMs = 0;
+	double minReorderedDelayMs = 1e9; // 늦게 도착한 패킷의 지연 중 최소
+	double maxExcessBytes = -1e18;    // 도착한 누적 바이트 - (burstBytes + 대역폭 * 시간) 의 최대
+	double deliveredMbps = 0;         // 넣는 시간의 가운데 절반 동안 도착한 양 (버스트/큐 비우기 제외)
+};
+
+// offeredMbps로 durationMs 동안 PACKET_SIZE 패킷을 넣고 모두 도착할 때까지 꺼냄
+// 패킷마다 번호와 넣은 시각을 실어 도착 순서와 지연을 잼
+static LinkRun run(const LinkEmulationSettings& settings, uint32_t seed, double offeredMbps, int durationMs) {
+	LinkRun result;
+	LinkEmulator emulator;
+	emulator.configure(settings, seed);
+
+	int64_t intervalUs = static_cast<int64_t>(PACKET_SIZE * 8 / offeredMbps);
+	int64_t endUs = static_cast<int64_t>(durationMs) * 1000;
+	std::vector<uint8_t> packet(PACKET_SIZE), received;
+	long long deliveredBytes = 0;
+	long long highestIndex = -1;
+	int64_t windowStartUs = endUs / 4;
+	int64_t windowEndUs = endUs * 3 / 4;
+	long long windowBytes = 0;
+
+	// nowUs까지 도착할 패킷을 도착 시각에 꺼냄 (지연을 정확히 재도록)
+	auto deliverUntil = [&](int64_t nowUs) {
+		int64_t nextUs;
+		while ((nextUs = emulator.nextDeliveryUs()) >= 0 && nextUs <= nowUs) {
+			emulator.pop(nextUs, received);
+			long long index;
+			int64_t submitUs;
+			memcpy(&index, received.data(), sizeof(index));
+			memcpy(&submitUs, received.data() + sizeof(index), sizeof(submitUs));
+			double delayMs = (nextUs - submitUs) / 1000.0;
+			result.minDelayMs = (std::min)(result.minDelayMs, delayMs);
+			result.maxDelayMs = (std::max)(result.maxDelayMs, delayMs);
+			if (index < highestIndex) {
+				result.observedReorders++;
+				result.minReorderedDelayMs = (std::min)(result.minReorderedDelayMs, delayMs);
+			}
+			highestIndex = (std::max)(highestIndex, index);
+
+			deliveredBytes += static_cast<long long>(received.size());
+			if (nextUs >= windowStartUs && nextUs < windowEndUs) {
+				windowBytes += static_cast<long long>(received.size());
+			}
+			if (settings.bandwidthMbps > 0) {
+				double allowed = settings.burstBytes + settings.bandwidthMbps / 8 * nextUs;
+				result.maxExcessBytes = (std::max)(result.maxExcessBytes, deliveredBytes - allowed);
+			}
+		}
+	};
+
+	for (int64_t nowUs = 0; nowUs < endUs; nowUs += intervalUs) {
+		deliverUntil(nowUs);
+		long long index = result.packetsSent++;
+		memcpy(packet.data(), &index, sizeof(index));
+		memcpy(packet.data() + sizeof(index), &nowUs, sizeof(nowUs));
+		emulator.submit(packet.data(), packet.size(), nowUs);
+	}
+	deliverUntil(INT64_MAX);
+
+	result.counters = emulator.counters();
+	result.deliveredMbps = windowBytes * 8.0 / (windowEndUs - windowStartUs);
+	return result;
+}
+
+static bool sameCounters(const LinkEmulatorCounters& a, const LinkEmulatorCounters& b) {
+	return a.packetsIn == b.packetsIn && a.packetsDelivered == b.packetsDelivered && a.queueDrops == b.queueDrops && a.lossDrops == b.lossDrops
+		&& a.burstLosses == b.burstLosses && a.reorderedPackets == b.reorderedPackets && a.totalDelayMs == b.totalDelayMs && a.maxDelayMs == b.maxDelayMs
+		&& a.maxQueueBytes == b.maxQueueBytes;
+}
+
+// 큐가 가득 찼을 때의 큐 지연 (ms)
+static double queueDelayMs(const LinkEmulationSettings& settings) {
+	return settings.bandwidthMbps > 0 && settings.queueBytes > 0 ? settings.queueBytes * 8 / (settings.bandwidthMbps * 1000) : 0;
+}
+
+static void print(const char* name, const LinkRun& result) {
+	const LinkEmulatorCounters& counters = result.counters;
+	printf("%-20s in %6lld delivered %6lld queue drops %5lld loss drops %4lld (burst %4lld) reordered %4lld (seen %4lld) delay %6.2f..%7.2f ms, %6.1f Mbps",
+		name, counters.packetsIn, counters.packetsDelivered, counters.queueDrops, counters.lossDrops, counters.burstLosses, counters.reorderedPackets,
+		result.observedReorders, result.minDelayMs, result.maxDelayMs, result.deliveredMbps);
+}
+
+// 프리셋: 같은 seed면 같은 결과, 대역폭의 1.5배를 넣어도 대역폭을 넘지 않고, 지연/순서 바꿈/손실이 설정 범위 안
+static bool checkPreset(const char* name, int preset) {
+	LinkEmulationSettings settings;
+	if (!LinkEmulator::preset(preset, settings)) {
+		printf("%s: unknown preset\n", name);
+		return false;
+	}
+	LinkRun first = run(settings, 42, settings.bandwidthMbps * 1.5, 2000);
+	LinkRun second = run(settings, 42, settings.bandwidthMbps * 1.5, 2000);
+	const LinkEmulatorCounters& counters = first.counters;
+
+	bool deterministic = sameCounters(first.counters, second.counters);
+	// 누적 도착량은 엄격히 제한. 구간 도착률은 지터로 몰려 도착한 패킷이 구간 경계에 걸칠 수 있어 1% 여유
+	bool throughput = first.maxExcessBytes <= 0 && first.deliveredMbps <= settings.bandwidthMbps * 1.01 && first.deliveredMbps >= settings.bandwidthMbps * 0.9;
+	// 지수 분포 지터는 평균의 20배를 넘을 확률이 2e-9
+	double maxExpectedDelayMs = queueDelayMs(settings) + settings.delayMs + settings.jitterMs * 20 + settings.reorderDelayMs;
+	bool delays = first.minDelayMs >= settings.delayMs && first.maxDelayMs <= maxExpectedDelayMs && counters.maxQueueBytes <= settings.queueBytes;
+	// 순서를 바꾼 패킷은 설정 확률의 두 배 안, 실제로 늦게 도착한 패킷은 그중 일부
+	long long passed = counters.packetsIn - counters.queueDrops - counters.lossDrops;
+	bool reorders = counters.reorderedPackets <= passed * settings.reorderRate * 2 + 5 && first.observedReorders <= counters.reorderedPackets
+		&& (first.observedReorders == 0 || first.minReorderedDelayMs >= settings.delayMs + settings.reorderDelayMs);
+	// 평균 손실은 프리셋 설명(1% 미만)의 두 배 안
+	bool losses = counters.lossDrops <= (counters.packetsIn - counters.queueDrops) * 0.02 && counters.packetsDelivered == passed;
+
+	bool ok = deterministic && throughput && delays && reorders && losses;
+	print(name, first);
+	printf(", same seed %s: %s\n", deterministic ? "same" : "DIFFERENT", ok ? "ok" : "FAIL");
+	if (!ok) {
+		printf("  throughput %s, delays %s, reorders %s, losses %s\n", throughput ? "ok" : "FAIL", delays ? "ok" : "FAIL", reorders ? "ok" : "FAIL", losses ? "ok" : "FAIL");
+	}
+	return ok;
+}
+
+// 병목 큐: 대역폭의 두 배를 넣으면 큐가 queueBytes에서 넘쳐 버리고, 큐 지연은 queueBytes / 대역폭 안
+// 무제한 큐(0)는 버리지 않음
+static bool checkQueueLimit() {
+	LinkEmulationSettings settings = {};
+	settings.bandwidthMbps = 10;
+	settings.burstBytes = 16 * 1024;
+	settings.queueBytes = 64 * 1024;
+	settings.delayMs = 5;
+	LinkRun limited = run(settings, 1, 20, 1000);
+	settings.queueBytes = 0;
+	LinkRun unlimited = run(settings, 1, 20, 1000);
+	settings.queueBytes = 64 * 1024;
+
+	bool ok = limited.counters.queueDrops > 0 && limited.counters.maxQueueBytes <= settings.queueBytes
+		&& limited.maxDelayMs <= queueDelayMs(settings) + settings.delayMs + 1 && limited.maxExcessBytes <= 0
+		&& unlimited.counters.queueDrops == 0 && unlimited.counters.packetsDelivered == unlimited.packetsSent && unlimited.maxExcessBytes <= 0;
+	print("queue 64KB", limited);
+	printf("\n");
+	print("queue unlimited", unlimited);
+	printf(": %s\n", ok ? "ok" : "FAIL");
+	return ok;
+}
+
+// 지터: 패킷 간격이 지터보다 충분히 길면 추가 지연 평균이 jitterMs에 가깝고, 순서는 그대로
+static bool checkJitter() {
+	LinkEmulationSettings settings = {};
+	settings.delayMs = 10;
+	settings.jitterMs = 2;
+	// 패킷 간격 20ms (0.48 Mbps)
+	LinkRun result = run(settings, 7, PACKET_SIZE * 8 / 20000.0, 100000);
+	double averageJitterMs = result.counters.totalDelayMs / result.counters.packetsDelivered - settings.delayMs;
+
+	bool ok = result.observedReorders == 0 && result.counters.reorderedPackets == 0 && result.minDelayMs >= settings.delayMs
+		&& averageJitterMs >= settings.jitterMs * 0.9 && averageJitterMs <= settings.jitterMs * 1.1;
+	print("jitter 2ms", result);
+	printf(", average jitter %.2f ms: %s\n", averageJitterMs, ok ? "ok" : "FAIL");
+	return ok;
+}
+
+// 순서 바꿈: 설정 비율 근처로 순서를 바꾸고, 앞 패킷보다 늦게 도착한 패킷은 모두 reorderDelayMs만큼 더 늦음
+static bool checkReorder() {
+	LinkEmulationSettings settings = {};
+	settings.delayMs = 3;
+	settings.reorderRate = 0.05;
+	settings.reorderDelayMs = 5;
+	// 패킷 간격 1ms라 5ms 늦추면 뒤 패킷에 추월당함
+	LinkRun result = run(settings, 3, PACKET_SIZE * 8 / 1000.0, 10000);
+	double reorderRate = static_cast<double>(result.counters.reorderedPackets) / result.counters.packetsIn;
+
+	bool ok = reorderRate >= settings.reorderRate * 0.8 && reorderRate <= settings.reorderRate * 1.2 && result.observedReorders > 0
+		&& result.observedReorders <= result.counters.reorderedPackets && result.minReorderedDelayMs >= settings.delayMs + settings.reorderDelayMs
+		&& result.maxDelayMs <= settings.delayMs + settings.reorderDelayMs + 0.001;
+	print("reorder 5%", result);
+	printf(", rate %.2f%%: %s\n", reorderRate * 100, ok ? "ok" : "FAIL");
+	return ok;
+}
+
+int main() {
+	bool ok = checkPreset("home wifi", LINK_PRESET_HOME_WIFI);
+	ok = checkPreset("usb tether", LINK_PRESET_USB_TETHER) && ok;
+	ok = checkQueueLimit() && ok;
+	ok = checkJitter() && ok;
+	ok = checkReorder() && ok;
+	return ok ? 0 : 1;
+}
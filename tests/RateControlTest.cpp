@@ -0,0 +1,94 @@
+// 전송률 제어 확인
+// - 늦게 도착한 패킷으로 받는 쪽 손실 누적이 줄어도 추정기가 재시작으로 보지 않고 계속 추정
+// - 캡처 루프가 프레임 없이 decide()만 반복해도 단계를 올리지 않고, 올리기는 record()한 프레임 수로만 셈
+// 사용법: RateControlTest
+#include "RateController.h"
+
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+// 100ms 간격 보고. 구간마다 packets개를 받고 패킷당 transitMs, 손실 누적 변화 lostDelta
+struct ReportFeed {
+	BandwidthEstimator& estimator;
+	long long bytes = 0;
+	long long received = 0;
+	long long lost = 0;
+	long long transitUs = 0;
+	int64_t timeUs = 1000000;
+
+	void next(long long packets, double transitMs, long long lostDelta) {
+		bytes += packets * 1250;
+		received += packets;
+		lost += lostDelta;
+		transitUs += static_cast<long long>(packets * transitMs * 1000);
+		timeUs += 100000;
+		estimator.report(bytes, received, lost, transitUs, timeUs);
+	}
+};
+
+static bool checkLateLossReport() {
+	BandwidthEstimator estimator;
+	ReportFeed feed{ estimator };
+	feed.next(100, 5, 0);   // 기준
+	feed.next(100, 5, 0);   // 큐 빔 (10 Mbps 전달)
+	feed.next(100, 45, 0);  // 큐 지연 40ms: 전달 속도 아래로 낮춤
+	feed.next(100, 5, 0);   // 큐가 비어 올려봄
+	double beforeLate = estimator.estimateMbps();
+	feed.next(101, 5, -1);  // 앞 구간에서 손실로 센 패킷이 늦게 도착
+	double afterLate = estimator.estimateMbps();
+	feed.next(100, 5, 0);
+	double afterNext = estimator.estimateMbps();
+
+	bool ok = beforeLate > 0 && afterLate > beforeLate && afterNext > afterLate;
+	printf("late packet report: estimate %.2f -> %.2f -> %.2f Mbps: %s\n", beforeLate, afterLate, afterNext, ok ? "ok" : "FAIL");
+	return ok;
+}
+
+static bool checkUpgradeCountsEmittedFrames() {
+	RateController controller;
+	controller.configure(10);
+	controller.reset(60);
+
+	// 전체 fps로는 예산(10 Mbps)을 넘는 프레임 (12 Mbps): fps 절반으로 내려감
+	RateDecision decision;
+	for (int i = 0; i < 8; ++i) {
+		decision = controller.decide();
+		controller.record(25000, decision);
+		std::this_thread::sleep_for(std::chrono::milliseconds(20)); // 가상 버퍼가 비워지도록
+	}
+	bool lowered = decision.frameDivisor == 2;
+
+	// 작은 프레임 몇 개로 예측이 예산 안으로 들어옴
+	for (int i = 0; i < 20; ++i) {
+		controller.record(2000, decision);
+	}
+	std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+	// 화면 변화가 없어 캡처 루프만 도는 경우: 내보낸 프레임이 없으므로 올리지 않아야 함
+	for (int i = 0; i < 300; ++i) {
+		decision = controller.decide();
+	}
+	bool heldWithoutFrames = decision.frameDivisor == 2;
+
+	// 프레임을 내보내면 UPGRADE_FRAMES(30) 뒤에 올림
+	int emitted = 0;
+	while (decision.frameDivisor == 2 && emitted < 200) {
+		decision = controller.decide();
+		if (decision.frameDivisor == 2) {
+			controller.record(2000, decision);
+			emitted++;
+		}
+	}
+	bool ok = lowered && heldWithoutFrames && emitted >= 30 && emitted <= 32;
+	printf("upgrade: lowered %s, held over 300 idle decisions %s, raised after %d emitted frames: %s\n",
+		lowered ? "yes" : "no", heldWithoutFrames ? "yes" : "no", emitted, ok ? "ok" : "FAIL");
+	printf("frames counted: %lld\n", controller.counters().frames);
+	return ok;
+}
+
+int main() {
+	bool ok = checkLateLossReport();
+	ok = checkUpgradeCountsEmittedFrames() && ok;
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,308 @@
+// 공유 메모리 프레임 링을 두 프로세스로 확인 (POSIX shm + futex)
+// 자식 프로세스가 이름으로 링을 열어 읽고, 부모가 씀
+// - 작은 링(칸 2개)에 읽는 쪽이 느려도 버리지 않고 순서대로, 내용 그대로 전달되고 쓰는 쪽이 멈추면 읽기가 끝나는지
+// - 칸보다 큰 프레임은 버리고, 없는 이름은 열지 못하고, 빈 링에서 acquire가 시간 제한 뒤 돌아오는지
+// - 읽는 쪽이 열어 둔 채로 같은 이름의 링을 다시 만들면 (StopSession -> StartSession) 읽는 쪽이 새 링의 처음부터 읽고 쓰는 쪽이 멈추지 않는지
+// --bench: 1080p60/4K60 BGRA 원본 크기 프레임의 전달 지연 (write 시작 -> 읽는 쪽 acquire)과 제한 없는 처리량
+// 사용법: SharedFrameRingTest [--bench]
+#include "SharedFrameRing.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+typedef std::chrono::steady_clock Clock;
+
+// 프로세스 사이에서 같은 시계 (Linux steady_clock = CLOCK_MONOTONIC)
+static long long nowUs() {
+	return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now().time_since_epoch()).count();
+}
+
+static std::string ringName(const char* suffix) {
+	return "SharedFrameRingTest_" + std::to_string(getpid()) + "_" + suffix;
+}
+
+// 프레임 내용: 순번과 위치로 정해지는 값. 앞/뒤와 중간 몇 곳만 비교
+static uint8_t patternByte(long long index, size_t offset) {
+	return static_cast<uint8_t>(index * 13 + offset * 5 + (offset >> 9));
+}
+
+static bool matchesFrame(const SharedFrameHeader* frame, long long index, size_t frameBytes) {
+	if (frame->timeStamp != index || static_cast<size_t>(frame->dataSize) != frameBytes || frame->width != 64) {
+		return false;
+	}
+	const uint8_t* data = SharedFrameRing::data(frame);
+	for (size_t offset : { size_t(0), frameBytes / 3, frameBytes / 2, frameBytes - 1 }) {
+		if (data[offset] != patternByte(index, offset)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// 자식 프로세스에서 body를 실행하고 종료 코드가 0인지 돌려줌
+template <typename Body>
+static bool runChild(pid_t& pid, Body body) {
+	pid = fork();
+	if (pid == 0) {
+		fflush(stdout);
+		_exit(body() ? 0 : 1);
+	}
+	return pid > 0;
+}
+
+static bool waitChild(pid_t pid) {
+	int status = 0;
+	return waitpid(pid, &status, 0) == pid && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+static bool checkTransfer() {
+	const std::string name = ringName("transfer");
+	const int frames = 500;
+	const size_t frameBytes = 100000;
+	SharedFrameRing ring;
+	if (!ring.create(name, 2, frameBytes)) {
+		printf("create failed\n");
+		return false;
+	}
+
+	pid_t pid;
+	runChild(pid, [&name, frameBytes] {
+		SharedFrameRing reader;
+		if (!reader.open(name)) {
+			printf("reader: open failed\n");
+			return false;
+		}
+		long long received = 0;
+		bool ordered = true;
+		while (const SharedFrameHeader* frame = reader.acquire(5000)) {
+			ordered = ordered && frame->sequence == static_cast<uint64_t>(received) && matchesFrame(frame, received, frameBytes);
+			// 가끔 늦게 반납해 쓰는 쪽이 자리를 기다리게 함
+			if (received % 50 == 0) {
+				std::this_thread::sleep_for(std::chrono::milliseconds(2));
+			}
+			reader.release();
+			received++;
+		}
+		printf("reader: received %lld frames in order with matching data: %s\n", received, ordered ? "yes" : "no");
+		return ordered && received == frames;
+	});
+
+	std::vector<uint8_t> data(frameBytes);
+	FrameData frameData = {};
+	frameData.data = data.data();
+	frameData.dataSize = static_cast<int>(frameBytes);
+	frameData.width = 64;
+	frameData.height = 64;
+	int written = 0;
+	for (int i = 0; i < frames; ++i) {
+		for (size_t offset = 0; offset < frameBytes; ++offset) {
+			data[offset] = patternByte(i, offset);
+		}
+		frameData.timeStamp = i;
+		written += ring.write(frameData) ? 1 : 0;
+	}
+
+	// 칸보다 큰 프레임은 기다리지 않고 버림
+	std::vector<uint8_t> oversized(frameBytes + SHARED_FRAME_DATA_OFFSET + 64);
+	frameData.data = oversized.data();
+	frameData.dataSize = static_cast<int>(oversized.size());
+	bool oversizedDropped = !ring.write(frameData) && ring.droppedFrames() == 1;
+
+	ring.stop();
+	bool readerOk = waitChild(pid);
+	ring.close();
+	bool ok = readerOk && written == frames && oversizedDropped;
+	printf("two-process transfer: written %d/%d, oversized dropped %s: %s\n", written, frames, oversizedDropped ? "yes" : "no", ok ? "ok" : "FAIL");
+	return ok;
+}
+
+static void writeFrames(SharedFrameRing& ring, long long firstIndex, int frames, size_t frameBytes, int& written) {
+	std::vector<uint8_t> data(frameBytes);
+	FrameData frameData = {};
+	frameData.data = data.data();
+	frameData.dataSize = static_cast<int>(frameBytes);
+	frameData.width = 64;
+	frameData.height = 64;
+	for (int i = 0; i < frames; ++i) {
+		for (size_t offset = 0; offset < frameBytes; ++offset) {
+			data[offset] = patternByte(firstIndex + i, offset);
+		}
+		frameData.timeStamp = firstIndex + i;
+		written += ring.write(frameData) ? 1 : 0;
+	}
+}
+
+static bool checkRecreate() {
+	const std::string name = ringName("recreate");
+	const int firstFrames = 20;
+	const int secondFrames = 30;
+	const long long secondIndex = 1000;
+	const size_t frameBytes = 4096;
+	SharedFrameRing first;
+	if (!first.create(name, 4, frameBytes)) {
+		printf("create failed\n");
+		return false;
+	}
+
+	pid_t pid;
+	runChild(pid, [&] {
+		SharedFrameRing reader;
+		if (!reader.open(name)) {
+			return false;
+		}
+		long long expected = 0;
+		bool ordered = true;
+		auto deadline = Clock::now() + std::chrono::seconds(10);
+		while (expected < secondIndex + secondFrames && Clock::now() < deadline) {
+			const SharedFrameHeader* frame = reader.acquire(100);
+			if (!frame) {
+				continue;
+			}
+			// 첫 링의 마지막 프레임은 든 채로 링이 다시 만들어지길 기다렸다가 반납 (옛 링의 순번으로 반납해도 새 링이 막히면 안 됨)
+			// 다시 만든 뒤에는 그 칸을 새 링이 덮어쓰므로 들고 있는 동안 다시 읽지 않음
+			if (frame->timeStamp == firstFrames - 1 && expected != secondIndex) {
+				ordered = ordered && matchesFrame(frame, expected, frameBytes);
+				expected = secondIndex;
+				std::this_thread::sleep_for(std::chrono::seconds(1));
+				reader.release();
+				continue;
+			}
+			// 다 읽기 전에 링을 다시 만들었으면 옛 링의 남은 프레임은 버려짐
+			if (frame->timeStamp >= secondIndex && expected < secondIndex) {
+				expected = secondIndex;
+			}
+			ordered = ordered && matchesFrame(frame, expected, frameBytes);
+			expected = frame->timeStamp + 1;
+			reader.release();
+		}
+		printf("reader: read through frame %lld after recreate, in order with matching data: %s\n", expected - 1, ordered ? "yes" : "no");
+		return ordered && expected == secondIndex + secondFrames;
+	});
+
+	int written = 0;
+	writeFrames(first, 0, firstFrames, frameBytes, written);
+	std::this_thread::sleep_for(std::chrono::milliseconds(300));
+	// 캡처를 멈춘 것처럼 첫 링은 멈추기만 하고 (읽는 쪽이 매핑을 붙잡고 있는 상태) 같은 이름으로 다시 만듦
+	first.stop();
+	SharedFrameRing second;
+	bool recreated = second.create(name, 4, frameBytes);
+
+	// 읽는 쪽이 옛 순번으로 반납하면 쓰는 쪽이 자리를 영영 기다리므로 시간 제한을 둠
+	std::atomic<bool> writing{ true };
+	int secondWritten = 0;
+	std::thread writerThread([&] {
+		writeFrames(second, secondIndex, secondFrames, frameBytes, secondWritten);
+		writing = false;
+	});
+	auto deadline = Clock::now() + std::chrono::seconds(5);
+	while (writing.load() && Clock::now() < deadline) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+	bool writerStalled = writing.load();
+	second.stop();
+	writerThread.join();
+	bool readerOk = waitChild(pid);
+	second.close();
+	first.close();
+
+	bool ok = recreated && readerOk && !writerStalled && written == firstFrames && secondWritten == secondFrames;
+	printf("recreate with reader attached: written %d + %d, writer stalled %s: %s\n", written, secondWritten, writerStalled ? "yes" : "no", ok ? "ok" : "FAIL");
+	return ok;
+}
+
+static bool checkOpenAndTimeout() {
+	SharedFrameRing missing;
+	bool missingRejected = !missing.open(ringName("missing"));
+
+	const std::string name = ringName("timeout");
+	SharedFrameRing ring;
+	ring.create(name, 4, 1024);
+	SharedFrameRing reader;
+	bool opened = reader.open(name);
+	auto start = Clock::now();
+	bool empty = reader.acquire(50) == nullptr;
+	double waitedMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	bool ok = missingRejected && opened && empty && waitedMs >= 40 && waitedMs < 1000;
+	printf("missing name rejected %s, empty acquire returned after %.1f ms: %s\n", missingRejected ? "yes" : "no", waitedMs, ok ? "ok" : "FAIL");
+	return ok;
+}
+
+// frames개를 intervalUs 간격으로 (0이면 쉬지 않고) 보내고 읽는 쪽 지연과 처리량을 출력
+static bool benchmark(const char* label, int width, int height, int frames, long long intervalUs) {
+	const std::string name = ringName("bench");
+	size_t frameBytes = static_cast<size_t>(width) * height * 4;
+	SharedFrameRing ring;
+	if (!ring.create(name, 4, static_cast<uint32_t>(frameBytes))) {
+		printf("create failed\n");
+		return false;
+	}
+
+	pid_t pid;
+	runChild(pid, [&name, label, frames] {
+		SharedFrameRing reader;
+		if (!reader.open(name)) {
+			return false;
+		}
+		std::vector<long long> latencies;
+		latencies.reserve(frames);
+		unsigned checksum = 0;
+		while (const SharedFrameHeader* frame = reader.acquire(5000)) {
+			latencies.push_back(nowUs() - frame->timeStamp);
+			// 복사 없이 읽는 쪽이 데이터를 만진다고 보고 끝 바이트만 읽음
+			checksum += SharedFrameRing::data(frame)[frame->dataSize - 1];
+			reader.release();
+		}
+		if (latencies.empty()) {
+			return false;
+		}
+		std::sort(latencies.begin(), latencies.end());
+		printf("%-14s reader: %zu frames, latency median %lld us, p99 %lld us, max %lld us (checksum %u)\n", label, latencies.size(),
+			latencies[latencies.size() / 2], latencies[latencies.size() * 99 / 100], latencies.back(), checksum);
+		return static_cast<int>(latencies.size()) == frames;
+	});
+
+	std::vector<uint8_t> data(frameBytes, 7);
+	FrameData frameData = {};
+	frameData.data = data.data();
+	frameData.dataSize = static_cast<int>(frameBytes);
+	frameData.width = width;
+	frameData.height = height;
+	frameData.frameRate = 60;
+	auto start = Clock::now();
+	for (int i = 0; i < frames; ++i) {
+		if (intervalUs > 0) {
+			std::this_thread::sleep_until(start + std::chrono::microseconds(intervalUs * i));
+		}
+		frameData.timeStamp = nowUs(); // write 안의 복사 시간도 지연에 포함
+		ring.write(frameData);
+	}
+	double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+	ring.stop();
+	bool ok = waitChild(pid);
+	ring.close();
+	printf("%-14s writer: %.1f frames/s, %.2f GB/s%s\n", label, frames / seconds, frames * static_cast<double>(frameBytes) / seconds / 1e9, ok ? "" : "  FAIL");
+	return ok;
+}
+
+int main(int argc, char** argv) {
+	setvbuf(stdout, nullptr, _IOLBF, 0);
+	bool ok = checkTransfer();
+	ok = checkOpenAndTimeout() && ok;
+	ok = checkRecreate() && ok;
+	if (argc > 1 && strcmp(argv[1], "--bench") == 0) {
+		ok = benchmark("1080p60", 1920, 1080, 240, 16667) && ok;
+		ok = benchmark("4K60", 3840, 2160, 240, 16667) && ok;
+		ok = benchmark("1080p unpaced", 1920, 1080, 600, 0) && ok;
+		ok = benchmark("4K unpaced", 3840, 2160, 200, 0) && ok;
+	}
+	return ok ? 0 : 1;
+}
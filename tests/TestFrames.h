@@ -0,0 +1,54 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <vector>
+
+// 테스트/벤치마크용 데스크톱 비슷한 BGRA 프레임 (그라디언트 배경 + 글자가 있는 밝은 창)
+inline void makeDesktopFrame(size_t width, size_t height, uint32_t seed, std::vector<uint8_t>& frame) {
+	std::mt19937 random(seed);
+	frame.resize(width * height * 4);
+	for (size_t y = 0; y < height; ++y) {
+		for (size_t x = 0; x < width; ++x) {
+			uint8_t* pixel = &frame[(y * width + x) * 4];
+			bool window = (x / 320 + y / 240) % 3 == 0;
+			pixel[0] = window ? 0xF0 : static_cast<uint8_t>(40 + y * 60 / height);
+			pixel[1] = window ? 0xF0 : static_cast<uint8_t>(80 + x * 40 / width);
+			pixel[2] = window ? 0xF0 : 0x90;
+			pixel[3] = 0xFF;
+			// 창 안의 글자
+			if (window && (y % 16) < 10 && (random() % 4) == 0) {
+				pixel[0] = pixel[1] = pixel[2] = 0x20;
+			}
+		}
+	}
+}
+
+// 가운데 changedRatio 비율의 행에서 가로 절반 구간의 픽셀 일부를 바꿈 (글자 입력/영상 영역 비슷)
+inline void changeRows(std::vector<uint8_t>& frame, size_t width, size_t height, double changedRatio, uint32_t seed) {
+	std::mt19937 random(seed);
+	size_t changedRows = static_cast<size_t>(height * changedRatio);
+	for (size_t y = 0; y < changedRows; ++y) {
+		uint8_t* row = &frame[((height - changedRows) / 2 + y) * width * 4];
+		for (size_t x = width / 4; x < width * 3 / 4; ++x) {
+			if ((random() % 3) == 0) {
+				row[x * 4 + 0] ^= 0x55;
+				row[x * 4 + 1] ^= 0x33;
+			}
+		}
+	}
+}
+
+// 모든 행을 dx 픽셀 오른쪽으로 밀어냄 (창을 옆으로 끄는 경우). 왼쪽 빈 곳은 그대로 둠
+inline void shiftRows(std::vector<uint8_t>& frame, size_t width, size_t height, size_t dx) {
+	for (size_t y = 0; y < height; ++y) {
+		uint8_t* row = &frame[y * width * 4];
+		memmove(row + dx * 4, row, (width - dx) * 4);
+	}
+}
+
+// 위로 dy 행 스크롤. 아래 빈 곳은 그대로 둠
+inline void scrollUp(std::vector<uint8_t>& frame, size_t width, size_t height, size_t dy) {
+	memmove(frame.data(), frame.data() + dy * width * 4, (height - dy) * width * 4);
+}
@@ -0,0 +1,210 @@
+// ThreadPool 작업 배분 마이크로벤치마크: 예전 방식(잠금 하나 + std::queue<std::function>)과 비교
+// 1..64 쓰레드에서 잠든 풀에 넣은 작업이 시작되기까지의 지연, 작업 처리량, parallelFor 왕복 시간과
+// parallelFor 한 번당 힙 할당 수를 출력하고 parallelFor 결과(중첩 포함)를 확인
+// 사용법: ThreadPoolBench
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <queue>
+#include <thread>
+#include <vector>
+
+// 이 프로그램의 모든 힙 할당 횟수
+static std::atomic<long long> heapAllocations{ 0 };
+
+void* operator new(size_t size) {
+	heapAllocations.fetch_add(1, std::memory_order_relaxed);
+	if (void* p = std::malloc(size ? size : 1)) {
+		return p;
+	}
+	throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+	std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+	std::free(p);
+}
+
+// 예전 ThreadPool: 작업마다 std::function, 모든 워커가 잠금 하나를 두고 경쟁
+// parallelFor는 바꾸기 전과 같이 호출마다 공유 상태를 힙에 만듦
+class MutexThreadPool {
+public:
+	explicit MutexThreadPool(size_t threadCount) {
+		for (size_t i = 0; i < threadCount; ++i) {
+			workers.emplace_back([this] {
+				while (true) {
+					std::function<void()> task;
+					{
+						std::unique_lock<std::mutex> lock(queueMutex);
+						condition.wait(lock, [this] { return stop || !tasks.empty(); });
+						if (stop && tasks.empty()) return;
+						task = std::move(tasks.front());
+						tasks.pop();
+					}
+					task();
+				}
+			});
+		}
+	}
+
+	~MutexThreadPool() {
+		{
+			std::unique_lock<std::mutex> lock(queueMutex);
+			stop = true;
+		}
+		condition.notify_all();
+		for (std::thread& worker : workers) {
+			worker.join();
+		}
+	}
+
+	void enqueueTask(std::function<void()> task) {
+		{
+			std::unique_lock<std::mutex> lock(queueMutex);
+			tasks.push(std::move(task));
+		}
+		condition.notify_one();
+	}
+
+	void parallelFor(size_t count, const std::function<void(size_t)>& body) {
+		if (count == 0) {
+			return;
+		}
+		struct State {
+			std::atomic<size_t> next{ 0 };
+			std::atomic<size_t> done{ 0 };
+			std::mutex doneMutex;
+			std::condition_variable doneCondition;
+		};
+		auto state = std::make_shared<State>();
+		auto run = [state, count, &body]() {
+			size_t index;
+			while ((index = state->next.fetch_add(1)) < count) {
+				body(index);
+				if (state->done.fetch_add(1) + 1 == count) {
+					std::lock_guard<std::mutex> lock(state->doneMutex);
+					state->doneCondition.notify_all();
+				}
+			}
+		};
+		size_t helpers = (std::min)(workers.size(), count - 1);
+		for (size_t i = 0; i < helpers; ++i) {
+			enqueueTask(run);
+		}
+		run();
+		std::unique_lock<std::mutex> lock(state->doneMutex);
+		state->doneCondition.wait(lock, [&state, count] { return state->done.load() == count; });
+	}
+
+private:
+	std::vector<std::thread> workers;
+	std::queue<std::function<void()>> tasks;
+	std::mutex queueMutex;
+	std::condition_variable condition;
+	bool stop = false;
+};
+
+typedef std::chrono::steady_clock Clock;
+
+struct Result {
+	double wakeLatencyUs;     // 중앙값
+	double wakeLatencyP99Us;
+	double tasksPerSecond;
+	double parallelForUs;
+	double allocationsPerParallelFor;
+	bool ok;
+};
+
+template <typename Pool>
+static Result run(size_t threadCount) {
+	Result result = {};
+	result.ok = true;
+	Pool pool(threadCount);
+
+	// 잠든 풀에 작업 하나: 넣은 시각부터 워커에서 시작한 시각까지
+	std::vector<double> latencies;
+	for (int i = 0; i < 300; ++i) {
+		std::this_thread::sleep_for(std::chrono::microseconds(200));
+		std::atomic<bool> started{ false };
+		Clock::time_point startTime;
+		Clock::time_point enqueueTime = Clock::now();
+		pool.enqueueTask([&] {
+			startTime = Clock::now();
+			started.store(true, std::memory_order_release);
+		});
+		while (!started.load(std::memory_order_acquire)) {
+			std::this_thread::yield();
+		}
+		latencies.push_back(std::chrono::duration<double, std::micro>(startTime - enqueueTime).count());
+	}
+	std::sort(latencies.begin(), latencies.end());
+	result.wakeLatencyUs = latencies[latencies.size() / 2];
+	result.wakeLatencyP99Us = latencies[latencies.size() * 99 / 100];
+
+	// 한 쓰레드가 빈 작업을 계속 넣을 때 처리량
+	const int taskCount = 100000;
+	std::atomic<int> done{ 0 };
+	auto start = Clock::now();
+	for (int i = 0; i < taskCount; ++i) {
+		pool.enqueueTask([&done] { done.fetch_add(1, std::memory_order_relaxed); });
+	}
+	while (done.load() < taskCount) {
+		std::this_thread::yield();
+	}
+	result.tasksPerSecond = taskCount / std::chrono::duration<double>(Clock::now() - start).count();
+
+	// 밴드 병렬화처럼 항목 64개짜리 parallelFor 왕복
+	const int rounds = 2000;
+	const size_t items = 64;
+	std::vector<std::atomic<int>> hits(items);
+	long long allocationsBefore = heapAllocations.load();
+	start = Clock::now();
+	for (int round = 0; round < rounds; ++round) {
+		pool.parallelFor(items, [&hits](size_t index) { hits[index].fetch_add(1, std::memory_order_relaxed); });
+	}
+	result.parallelForUs = std::chrono::duration<double, std::micro>(Clock::now() - start).count() / rounds;
+	result.allocationsPerParallelFor = static_cast<double>(heapAllocations.load() - allocationsBefore) / rounds;
+	for (size_t i = 0; i < items; ++i) {
+		result.ok = result.ok && hits[i].load() == rounds;
+	}
+
+	// 항목 안에서 다시 parallelFor (밴드 안의 타일 같은 중첩)
+	std::atomic<int> nested{ 0 };
+	pool.parallelFor(16, [&](size_t) {
+		pool.parallelFor(16, [&](size_t) { nested.fetch_add(1, std::memory_order_relaxed); });
+	});
+	result.ok = result.ok && nested.load() == 16 * 16;
+	return result;
+}
+
+int main() {
+	const size_t threadCounts[] = { 1, 2, 4, 8, 16, 32, 64 };
+	bool ok = true;
+
+	printf("%-7s %7s %12s %12s %12s %14s %12s\n", "pool", "threads", "wake us", "wake p99 us", "Mtask/s", "parallelFor us", "allocs/call");
+	for (size_t threadCount : threadCounts) {
+		Result mutexResult = run<MutexThreadPool>(threadCount);
+		Result result = run<ThreadPool>(threadCount);
+		printf("%-7s %7zu %12.1f %12.1f %12.2f %14.1f %12.1f\n", "mutex", threadCount, mutexResult.wakeLatencyUs, mutexResult.wakeLatencyP99Us,
+			mutexResult.tasksPerSecond / 1e6, mutexResult.parallelForUs, mutexResult.allocationsPerParallelFor);
+		printf("%-7s %7zu %12.1f %12.1f %12.2f %14.1f %12.1f\n", "current", threadCount, result.wakeLatencyUs, result.wakeLatencyP99Us,
+			result.tasksPerSecond / 1e6, result.parallelForUs, result.allocationsPerParallelFor);
+		if (!mutexResult.ok || !result.ok) {
+			printf("parallelFor result mismatch at %zu threads\n", threadCount);
+			ok = false;
+		}
+	}
+	return ok ? 0 : 1;
+}
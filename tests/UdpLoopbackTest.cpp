@@ -0,0 +1,183 @@
+// 127.0.0.1 UDP 송수신 확인
+// - 200KB/1MB/4MB 프레임을 60fps로 보내 모두 깨지지 않고 도착하는지, 처리량과 프레임 지연 (보낸 시각 -> 다 모인 시각)
+//   소켓 버퍼가 가득 차도 sendto 실패로 버리지 않고 기다렸다 다시 보내야 함
+// - 보내는 쪽을 닫고 다시 열면 (프레임 순번이 0부터 다시 시작) 처음 프레임부터 받아야 함
+// - 받는 쪽에서 패킷을 잃어 프레임을 놓치면 (링크 에뮬레이터 5% 손실, FEC 끔) 보내는 쪽이 전체 갱신 요청을 받아야 함
+//   손실이 없으면 요청은 처음 붙을 때 한 번뿐
+// - 콜백 안에서 stop하면 (받는 쓰레드가 자기를 join하면 안 됨) 그 뒤로 콜백이 없고 밖에서 다시 stop/소멸해도 됨
+// 사용법: UdpLoopbackTest [포트]
+#include "UdpStream.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+static const double FRAME_RATE = 60;
+static const size_t PACKET_SIZE = 1400;
+
+// 프레임마다 바뀌는 내용. 받은 쪽에서 timeStamp로 다시 만들어 비교
+static uint8_t patternByte(long long frameIndex, size_t offset) {
+	return static_cast<uint8_t>(frameIndex * 31 + offset * 7 + (offset >> 11));
+}
+
+static void fillFrame(std::vector<uint8_t>& frame, long long frameIndex) {
+	for (size_t i = 0; i < frame.size(); ++i) {
+		frame[i] = patternByte(frameIndex, i);
+	}
+}
+
+static bool matchesFrame(const FrameData& frameData, size_t expectedSize) {
+	if (static_cast<size_t>(frameData.dataSize) != expectedSize) {
+		return false;
+	}
+	for (size_t i = 0; i < expectedSize; ++i) {
+		if (frameData.data[i] != patternByte(frameData.timeStamp, i)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// firstIndex부터 frames개를 FRAME_RATE 간격으로 보냄
+static void sendFrames(UdpSender& sender, size_t frameBytes, long long firstIndex, int frames) {
+	std::vector<uint8_t> frame(frameBytes);
+	FrameData frameData = {};
+	frameData.width = 1920;
+	frameData.height = 1080;
+	frameData.frameRate = static_cast<int>(FRAME_RATE);
+	double intervalMs = 1000 / FRAME_RATE;
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < frames; ++i) {
+		fillFrame(frame, firstIndex + i);
+		frameData.data = frame.data();
+		frameData.dataSize = static_cast<int>(frame.size());
+		frameData.timeStamp = firstIndex + i;
+		sender.send(frameData, intervalMs);
+		std::this_thread::sleep_until(start + std::chrono::microseconds(static_cast<long long>(intervalMs * 1000 * (i + 1))));
+	}
+	// 받는 쪽이 남은 패킷을 처리할 시간
+	std::this_thread::sleep_for(std::chrono::milliseconds(200));
+}
+
+static bool checkThroughput(int port, size_t frameBytes) {
+	const int frames = 120;
+	std::atomic<int> good{ 0 }, bad{ 0 };
+	UdpReceiver receiver;
+	if (!receiver.start(port, [&](const FrameData& frameData) { (matchesFrame(frameData, frameBytes) ? good : bad)++; })) {
+		printf("failed to bind port %d\n", port);
+		return false;
+	}
+	UdpSender sender;
+	sender.open("127.0.0.1", port, PACKET_SIZE);
+	auto start = std::chrono::steady_clock::now();
+	sendFrames(sender, frameBytes, 0, frames);
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	receiver.stop();
+
+	ReassemblyCounters received = receiver.counters();
+	UdpSenderCounters sent = sender.counters();
+	bool ok = good.load() == frames && bad.load() == 0 && sent.sendErrors == 0 && sent.keyframeRequests <= 1;
+	printf("%7zu B/frame: received %d/%d (corrupt %d), packets %lld lost %lld, send errors %lld blocked %lld, keyframe requests %lld, send %.2f ms, latency avg %.2f max %.2f ms, %.0f Mbps: %s\n",
+		frameBytes, good.load(), frames, bad.load(), received.packetsReceived, received.packetsLost, sent.sendErrors, sent.sendBlocked, sent.keyframeRequests,
+		sent.framesSent > 0 ? sent.totalSendMs / sent.framesSent : 0, received.framesReceived > 0 ? received.totalLatencyMs / received.framesReceived : 0,
+		received.maxLatencyMs, received.bytesReceived * 8 / seconds / 1e6, ok ? "ok" : "FAIL");
+	return ok;
+}
+
+static bool checkSenderRestart(int port) {
+	const size_t frameBytes = 20000;
+	const int firstFrames = 50;
+	const int secondFrames = 20;
+	std::atomic<int> firstReceived{ 0 }, secondReceived{ 0 };
+	UdpReceiver receiver;
+	if (!receiver.start(port, [&](const FrameData& frameData) {
+		if (matchesFrame(frameData, frameBytes)) {
+			(frameData.timeStamp < firstFrames ? firstReceived : secondReceived)++;
+		}
+	})) {
+		printf("failed to bind port %d\n", port);
+		return false;
+	}
+	UdpSender sender;
+	sender.open("127.0.0.1", port, PACKET_SIZE);
+	sendFrames(sender, frameBytes, 0, firstFrames);
+	// 다시 열면 프레임/패킷 순번이 0부터 시작
+	sender.close();
+	sender.open("127.0.0.1", port, PACKET_SIZE);
+	sendFrames(sender, frameBytes, firstFrames, secondFrames);
+	receiver.stop();
+
+	bool ok = firstReceived.load() == firstFrames && secondReceived.load() == secondFrames;
+	printf("sender restart: before %d/%d, after %d/%d: %s\n", firstReceived.load(), firstFrames, secondReceived.load(), secondFrames, ok ? "ok" : "FAIL");
+	return ok;
+}
+
+static bool checkKeyframeRequest(int port) {
+	const size_t frameBytes = 20000;
+	const int frames = 60;
+	std::atomic<int> good{ 0 };
+	UdpReceiver receiver;
+	if (!receiver.start(port, [&](const FrameData& frameData) { good += matchesFrame(frameData, frameBytes) ? 1 : 0; })) {
+		printf("failed to bind port %d\n", port);
+		return false;
+	}
+	LinkEmulationSettings loss = {};
+	loss.goodLossRate = 0.05;
+	receiver.setLinkEmulation(&loss, 1234);
+	UdpSender sender;
+	sender.configureFec(0);
+	sender.open("127.0.0.1", port, PACKET_SIZE);
+	sendFrames(sender, frameBytes, 0, frames);
+	receiver.stop();
+
+	// 처음 붙을 때 한 번 + 놓친 프레임을 알린 보고마다
+	ReassemblyCounters received = receiver.counters();
+	UdpSenderCounters sent = sender.counters();
+	bool requested = sender.takeKeyframeRequest();
+	bool ok = received.framesDropped > 0 && sent.keyframeRequests > 1 && requested;
+	printf("5%% loss: received %d/%d, dropped %lld, keyframe requests %lld, pending request %s: %s\n", good.load(), frames, received.framesDropped,
+		sent.keyframeRequests, requested ? "yes" : "no", ok ? "ok" : "FAIL");
+	return ok;
+}
+
+static bool checkStopFromCallback(int port) {
+	const size_t frameBytes = 20000;
+	std::atomic<int> callbacks{ 0 };
+	std::atomic<bool> stoppedInCallback{ false };
+	bool restartRejected = false;
+	{
+		UdpReceiver receiver;
+		if (!receiver.start(port, [&](const FrameData&) {
+			if (callbacks++ == 0) {
+				receiver.stop();
+				restartRejected = !receiver.start(port, [](const FrameData&) {});
+				stoppedInCallback = true;
+			}
+		})) {
+			printf("failed to bind port %d\n", port);
+			return false;
+		}
+		UdpSender sender;
+		sender.open("127.0.0.1", port, PACKET_SIZE);
+		sendFrames(sender, frameBytes, 0, 10);
+		receiver.stop();
+	}
+
+	bool ok = stoppedInCallback.load() && restartRejected && callbacks.load() == 1;
+	printf("stop from callback: callbacks %d, restart rejected %s: %s\n", callbacks.load(), restartRejected ? "yes" : "no", ok ? "ok" : "FAIL");
+	return ok;
+}
+
+int main(int argc, char** argv) {
+	int port = argc > 1 ? atoi(argv[1]) : 45000;
+	bool ok = checkSenderRestart(port);
+	ok = checkKeyframeRequest(port) && ok;
+	ok = checkStopFromCallback(port) && ok;
+	for (size_t frameBytes : { 200000, 1000000, 4000000 }) {
+		ok = checkThroughput(port, frameBytes) && ok;
+	}
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,139 @@
+// BGRA -> NV12/I420 -> BGRA 왕복 PSNR 확인 (BT.601/709, 제한/전체 범위, 홀수 크기 포함)
+// 회색 램프는 크로마가 0이라 거의 그대로 돌아와야 하고, NV12와 I420은 같은 결과로 복원돼야 함
+// 사용법: YuvPsnrTest [--bench]
+#include "ColorConvert.h"
+#include "ThreadPool.h"
+#include "TestFrames.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+// 4:2:0 왕복의 최소 PSNR (dB). 데스크톱 프레임은 색 경계가 적어 크로마 평균의 손실이 작음
+// 회색은 크로마가 0이라 Y 양자화 오차만 남음
+static const double MIN_DESKTOP_PSNR = 45;
+static const double MIN_GRADIENT_PSNR = 45;
+static const double MIN_GRAY_PSNR = 50;
+
+static const char* formatName(int pixelFormat) {
+	return pixelFormat == PIXEL_FORMAT_NV12 ? "NV12" : "I420";
+}
+
+// 가로/세로로 천천히 바뀌는 색 (사진/영상 비슷한 부드러운 크로마). 기울기는 크기와 상관없이 1080p에서 끝까지 한 번
+static void makeGradient(size_t width, size_t height, std::vector<uint8_t>& frame) {
+	frame.resize(width * height * 4);
+	for (size_t y = 0; y < height; ++y) {
+		for (size_t x = 0; x < width; ++x) {
+			uint8_t* pixel = &frame[(y * width + x) * 4];
+			pixel[0] = static_cast<uint8_t>(255 * (x % 1920) / 1919);
+			pixel[1] = static_cast<uint8_t>(255 * (y % 1080) / 1079);
+			pixel[2] = static_cast<uint8_t>(128 + 100 * std::sin((x + y) * 0.01));
+			pixel[3] = 0xFF;
+		}
+	}
+}
+
+static void makeGrayRamp(size_t width, size_t height, std::vector<uint8_t>& frame) {
+	frame.resize(width * height * 4);
+	for (size_t i = 0; i < width * height; ++i) {
+		uint8_t level = static_cast<uint8_t>(i % 256);
+		frame[i * 4 + 0] = frame[i * 4 + 1] = frame[i * 4 + 2] = level;
+		frame[i * 4 + 3] = 0xFF;
+	}
+}
+
+static double roundTrip(const std::vector<uint8_t>& bgra, int width, int height, int pixelFormat, int colorMatrix, bool fullRange, ThreadPool* pool, std::vector<uint8_t>& decoded) {
+	std::vector<uint8_t> yuv(yuvFrameSize(width, height));
+	decoded.assign(bgra.size(), 0);
+	convertBgraToYuv(bgra.data(), width, height, yuv.data(), pixelFormat, colorMatrix, fullRange, pool);
+	convertYuvToBgra(yuv.data(), width, height, decoded.data(), pixelFormat, colorMatrix, fullRange, pool);
+	return computePsnr(bgra.data(), decoded.data(), static_cast<size_t>(width) * height);
+}
+
+static bool checkPsnr(ThreadPool& pool) {
+	struct Size {
+		int width;
+		int height;
+	};
+	const Size sizes[] = { { 1, 1 }, { 17, 9 }, { 333, 187 }, { 1920, 1080 } };
+	bool ok = true;
+
+	printf("%-9s %-4s %-5s %-7s %9s %9s %9s\n", "size", "fmt", "matrix", "range", "desktop", "gradient", "gray");
+	for (const Size& size : sizes) {
+		std::vector<uint8_t> desktop, gradient, gray;
+		makeDesktopFrame(size.width, size.height, 5, desktop);
+		makeGradient(size.width, size.height, gradient);
+		makeGrayRamp(size.width, size.height, gray);
+
+		for (int colorMatrix : { COLOR_MATRIX_BT601, COLOR_MATRIX_BT709 }) {
+			for (bool fullRange : { false, true }) {
+				std::vector<uint8_t> nv12Decoded;
+				for (int pixelFormat : { PIXEL_FORMAT_NV12, PIXEL_FORMAT_I420 }) {
+					std::vector<uint8_t> decoded;
+					double desktopPsnr = roundTrip(desktop, size.width, size.height, pixelFormat, colorMatrix, fullRange, &pool, decoded);
+					// NV12와 I420은 크로마 배치만 다르므로 복원 결과가 같아야 함
+					if (pixelFormat == PIXEL_FORMAT_NV12) {
+						nv12Decoded = decoded;
+					}
+					else if (decoded != nv12Decoded) {
+						printf("NV12 and I420 decode differently\n");
+						ok = false;
+					}
+					double gradientPsnr = roundTrip(gradient, size.width, size.height, pixelFormat, colorMatrix, fullRange, &pool, decoded);
+					double grayPsnr = roundTrip(gray, size.width, size.height, pixelFormat, colorMatrix, fullRange, &pool, decoded);
+
+					bool pass = desktopPsnr >= MIN_DESKTOP_PSNR && gradientPsnr >= MIN_GRADIENT_PSNR && grayPsnr >= MIN_GRAY_PSNR;
+					char sizeName[32];
+					snprintf(sizeName, sizeof(sizeName), "%dx%d", size.width, size.height);
+					printf("%-9s %-4s %-5s %-7s %9.2f %9.2f %9.2f%s\n", sizeName, formatName(pixelFormat), colorMatrix == COLOR_MATRIX_BT601 ? "601" : "709",
+						fullRange ? "full" : "limited", desktopPsnr, gradientPsnr, grayPsnr, pass ? "" : "  FAIL");
+					ok = ok && pass;
+				}
+			}
+		}
+	}
+	return ok;
+}
+
+static void benchmark(ThreadPool& pool) {
+	struct Size {
+		const char* name;
+		int width;
+		int height;
+	};
+	const Size sizes[] = { { "1080p", 1920, 1080 }, { "4K", 3840, 2160 } };
+
+	printf("\n%-6s %-4s %12s %12s\n", "size", "fmt", "to yuv ms", "to bgra ms");
+	for (const Size& size : sizes) {
+		std::vector<uint8_t> bgra, decoded(static_cast<size_t>(size.width) * size.height * 4);
+		makeDesktopFrame(size.width, size.height, 5, bgra);
+		std::vector<uint8_t> yuv(yuvFrameSize(size.width, size.height));
+		for (int pixelFormat : { PIXEL_FORMAT_NV12, PIXEL_FORMAT_I420 }) {
+			const int iterations = 20;
+			auto start = std::chrono::steady_clock::now();
+			for (int i = 0; i < iterations; ++i) {
+				convertBgraToYuv(bgra.data(), size.width, size.height, yuv.data(), pixelFormat, COLOR_MATRIX_BT709, false, &pool);
+			}
+			auto middle = std::chrono::steady_clock::now();
+			for (int i = 0; i < iterations; ++i) {
+				convertYuvToBgra(yuv.data(), size.width, size.height, decoded.data(), pixelFormat, COLOR_MATRIX_BT709, false, &pool);
+			}
+			auto end = std::chrono::steady_clock::now();
+			printf("%-6s %-4s %12.3f %12.3f\n", size.name, formatName(pixelFormat),
+				std::chrono::duration<double, std::milli>(middle - start).count() / iterations,
+				std::chrono::duration<double, std::milli>(end - middle).count() / iterations);
+		}
+	}
+}
+
+int main(int argc, char** argv) {
+	ThreadPool pool(std::thread::hardware_concurrency());
+	bool ok = checkPsnr(pool);
+	if (argc > 1 && strcmp(argv[1], "--bench") == 0) {
+		benchmark(pool);
+	}
+	return ok ? 0 : 1;
+}